@@ -64,6 +64,57 @@ static void BM_test1_fastad(benchmark::State& state)
 
 BENCHMARK(BM_test1_fastad);
 
+// FastAD with every leaf in a Workspace, resetting the adjoints every iteration
+static void BM_test1_fastad_workspace(benchmark::State& state)
+{
+    using namespace ad;
+    std::vector<VarView<double>> x(100);
+    std::vector<VarView<double>> w(3);
+    Workspace<double> ws(x, w);
+    ws.values().head(x.size()) = Eigen::VectorXd::LinSpaced(x.size(), 0., 0.99);
+    auto expr = ad::bind(
+                (w[0] = x[0] * x[1] - x[2] * sin(x[0]),
+                 w[1] = x[1] * w[0] - cos(w[0]) + 
+                        ad::sum(x.begin(), x.end(), [](const auto& xi) {return xi;}),
+                 w[2] = w[1] + ad::exp(w[1] - w[0])) 
+    );
+
+    for (auto _ : state) {
+        ws.reset_adj();
+        autodiff(expr);
+        benchmark::DoNotOptimize(ws.adjoints().data());
+    }
+}
+
+BENCHMARK(BM_test1_fastad_workspace);
+
+// FastAD dynamic tape (re-records every iteration like Adept)
+static void BM_test1_tape(benchmark::State& state)
+{
+    using namespace ad::tape;
+    Stack<double> stack;
+    for (auto _ : state) {
+        stack.new_recording();
+        std::vector<Real<double>> x;
+        x.reserve(100);
+        for (size_t i = 0; i < 100; ++i) {
+            x.emplace_back(i / 100.);
+        }
+        Real<double> sum = x[0];
+        for (size_t i = 1; i < x.size(); ++i) {
+            sum += x[i];
+        }
+        Real<double> w_0 = x[0] * x[1] - x[2] * sin(x[0]);
+        Real<double> w_1 = x[1] * w_0 - cos(w_0) + sum;
+        Real<double> J = w_1 + exp(w_1 - w_0);
+        J.set_adj(1.);
+        stack.reverse();
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_test1_tape);
+
 #ifdef USE_ADEPT
 
 // Adept
@@ -0,0 +1,67 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/any_expr.hpp>
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <vector>
+
+// Gradient of a program of n_stmts statements p[i+1] = g_i(p[i], w, x),
+// where g_i cycles through three different expressions.
+// "typed" glues the statements into one expression type
+// and "erased" stores every statement as an AnyExpr.
+
+static constexpr size_t n_stmts = 32;
+
+template <size_t I, class P, class W>
+auto step(P& p, W& w)
+{
+    if constexpr (I % 3 == 0) return (p[I+1] = ad::sin(p[I]) * w + 0.5);
+    else if constexpr (I % 3 == 1) return (p[I+1] = ad::exp(p[I] * 0.1) - w);
+    else return (p[I+1] = ad::sqrt(p[I] * p[I] + w * w) * 0.5);
+}
+
+template <class P, class W, size_t... I>
+auto typed_program(P& p, W& w, std::index_sequence<I...>)
+{
+    return (step<I>(p, w), ...);
+}
+
+template <class P, class W, size_t... I>
+auto erased_program(P& p, W& w, std::index_sequence<I...>)
+{
+    return std::vector<ad::AnyExpr<double>>{step<I>(p, w)...};
+}
+
+static void BM_any_expr_typed(benchmark::State& state)
+{
+    std::vector<ad::Var<double>> p(n_stmts + 1);
+    ad::Var<double> w(0.3);
+    p[0].get() = 0.2;
+    auto expr = ad::bind(typed_program(p, w, std::make_index_sequence<n_stmts>()));
+    for (auto _ : state) {
+        for (auto& pi : p) pi.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+static void BM_any_expr_erased(benchmark::State& state)
+{
+    std::vector<ad::Var<double>> p(n_stmts + 1);
+    ad::Var<double> w(0.3);
+    p[0].get() = 0.2;
+    auto stmts = erased_program(p, w, std::make_index_sequence<n_stmts>());
+    auto expr = ad::bind(ad::for_each(stmts.begin(), stmts.end(),
+                                      [](const auto& s) { return s; }));
+    for (auto _ : state) {
+        for (auto& pi : p) pi.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+BENCHMARK(BM_any_expr_typed);
+BENCHMARK(BM_any_expr_erased);
@@ -0,0 +1,82 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <vector>
+
+// Startup cost of large programs: time to build (and bind)
+// an expression of state.range(0) statements or summands.
+
+static std::vector<size_t> indices(size_t n)
+{
+    std::vector<size_t> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    return idx;
+}
+
+// w[i] = x * v[i] + sin(v[i]) for every i, then sum(w)
+template <class VType, class WType, class XType>
+static auto make_program(const std::vector<size_t>& idx,
+                         VType& v, WType& w, XType& x)
+{
+    return (ad::for_each(idx.begin(), idx.end(), [&](size_t i) {
+                return w[i] = x * v[i] + ad::sin(v[i]);
+            }),
+            ad::sum(w));
+}
+
+static void BM_build_for_each(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    auto idx = indices(n);
+    ad::Var<double, ad::vec> v(n), w(n);
+    ad::Var<double> x(2.);
+
+    for (auto _ : state) {
+        auto expr = make_program(idx, v, w, x);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_build_for_each)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_build_bind_for_each(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    auto idx = indices(n);
+    ad::Var<double, ad::vec> v(n), w(n);
+    ad::Var<double> x(2.);
+
+    for (auto _ : state) {
+        auto expr = ad::bind(make_program(idx, v, w, x));
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_build_bind_for_each)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_build_bind_sum(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    auto idx = indices(n);
+    ad::Var<double, ad::vec> v(n);
+    ad::Var<double> x(2.);
+
+    for (auto _ : state) {
+        auto expr = ad::bind(ad::sum(idx.begin(), idx.end(), [&](size_t i) {
+                    return ad::exp(x * v[i]) * v[i];
+                }));
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_build_bind_sum)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
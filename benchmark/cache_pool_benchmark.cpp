@@ -0,0 +1,47 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/util/cache_pool.hpp>
+#include <benchmark/benchmark.h>
+
+// Rebuilds, binds, and differentiates an expression of state.range(0) summands
+// on every iteration, as when an expression is built per request.
+
+static auto make_expr(const std::vector<double>& x, 
+                      const ad::Var<double>& w)
+{
+    return ad::sum(x.begin(), x.end(),
+                   [&](double xi) { return ad::exp(w * xi) + w; });
+}
+
+static void BM_cache_pool_heap(benchmark::State& state)
+{
+    std::vector<double> x(state.range(0), 0.01);
+    ad::Var<double> w(0.5);
+    for (auto _ : state) {
+        auto expr = ad::bind(make_expr(x, w));
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_cache_pool_heap)->RangeMultiplier(10)->Range(1, 10000);
+
+static void BM_cache_pool(benchmark::State& state)
+{
+    std::vector<double> x(state.range(0), 0.01);
+    ad::Var<double> w(0.5);
+    ad::util::CachePool pool(ad::util::CachePool::huge_page_size, state.range(1));
+    for (auto _ : state) {
+        auto expr = ad::bind(make_expr(x, w), pool);
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["high_water_mark"] = pool.high_water_mark();
+}
+
+// args: number of summands, huge pages
+BENCHMARK(BM_cache_pool)->ArgsProduct({{1, 10, 100, 1000, 10000}, {0, 1}});
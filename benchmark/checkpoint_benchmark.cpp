@@ -0,0 +1,67 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/checkpoint.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+// Gradient of sum(x_T^2) with respect to the parameter a and x_0 of the explicit Euler scheme
+// x <- x + dt * (a * sin(x) - x) on a state of 64 values over state.range(0) steps.
+// The "cache" counter is the number of bytes of the expression cache
+// plus, for checkpointing, the snapshots of the state.
+
+constexpr size_t state_size = 64;
+constexpr double dt = 0.01;
+
+template <class F>
+static void run(benchmark::State& state, F make)
+{
+    std::vector<size_t> idx(state.range(0));
+    std::iota(idx.begin(), idx.end(), 0);
+    ad::Var<double> a(0.9);
+    ad::Var<double, ad::vec> x(state_size);
+    auto step = [&](size_t) { return x += dt * (a * ad::sin(x) - x); };
+    auto expr = ad::bind((make(idx, step), ad::sum(x * x)));
+
+    for (auto _ : state) {
+        x.get().setLinSpaced(-1., 1.);
+        a.reset_adj();
+        x.reset_adj();
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(a.get_adj());
+    }
+
+    size_t n_values = expr.get().bind_cache_size().sum();
+    state.counters["cache"] = n_values * sizeof(double);
+}
+
+static void BM_for_each(benchmark::State& state)
+{
+    run(state, [](auto& idx, auto step) {
+            return ad::for_each(idx.begin(), idx.end(), step);
+        });
+}
+
+static void BM_checkpoint(benchmark::State& state)
+{
+    size_t n_checkpoints = state.range(1);
+    run(state, [&](auto& idx, auto step) {
+            auto expr = ad::checkpoint_for_each(idx.begin(), idx.end(), step,
+                                                n_checkpoints);
+            n_checkpoints = expr.n_checkpoints();
+            return expr;
+        });
+    state.counters["cache"] += n_checkpoints * state_size * sizeof(double);
+}
+
+BENCHMARK(BM_for_each)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_checkpoint)
+    ->Args({1000, 0})
+    ->Args({1000, 20})
+    ->Args({10000, 0})
+    ->Args({10000, 40});
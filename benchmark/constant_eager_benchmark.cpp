@@ -4,6 +4,7 @@
 #include <fastad_bits/reverse/core/eval.hpp>
 #include <fastad_bits/reverse/core/pow.hpp>
 #include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
 #include <benchmark/benchmark.h>
 #include <vector>
 #include <numeric>
@@ -55,3 +56,40 @@ static void BM_normal_repeated_stddev(benchmark::State& state)
 }
 
 BENCHMARK(BM_normal_repeated_stddev);
+
+// Builds and copies an expression containing
+// a constant design matrix with state.range(0) elements.
+// Every iteration fills a fresh matrix M, which is moved into the constant
+// (BM_build_large_constant) or copied into it (BM_build_large_constant_copy).
+// Binding is left out since it allocates a cache proportional to the rows of X.
+template <bool move>
+static void build_large_constant(benchmark::State& state)
+{
+    constexpr size_t p = 10;
+    size_t n = state.range(0) / p;
+    Eigen::MatrixXd data = Eigen::MatrixXd::Random(n, p);
+    ad::Var<double, ad::vec> w(p);
+
+    for (auto _ : state) {
+        Eigen::MatrixXd M = data;
+        benchmark::DoNotOptimize(M.data());
+        auto X = move ? ad::constant(std::move(M)) : ad::constant(M);
+        auto expr = ad::sum(ad::dot(X, w));
+        std::vector<decltype(expr)> copies(4, expr);
+        benchmark::DoNotOptimize(copies.data());
+        benchmark::ClobberMemory();
+    }
+}
+
+static void BM_build_large_constant(benchmark::State& state)
+{
+    build_large_constant<true>(state);
+}
+
+static void BM_build_large_constant_copy(benchmark::State& state)
+{
+    build_large_constant<false>(state);
+}
+
+BENCHMARK(BM_build_large_constant)->RangeMultiplier(10)->Range(1000, 10000000);
+BENCHMARK(BM_build_large_constant_copy)->RangeMultiplier(10)->Range(1000, 10000000);
@@ -0,0 +1,77 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/data_slot.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <benchmark/benchmark.h>
+
+// Gradient of a squared loss over minibatches of 64 data points
+// with state.range(0) features.
+// Minibatch b is the (64 x p) block of columns [b*p, (b+1)*p) of X.
+// "copy" copies every minibatch into a buffer viewed by ad::constant_view,
+// "slot" points an ad::data_slot to the minibatch.
+
+static constexpr size_t n_batches = 64;
+static constexpr size_t batch = 64;
+
+struct Data
+{
+    Data(size_t p)
+        : X(Eigen::MatrixXd::Random(batch, n_batches * p))
+        , y(Eigen::VectorXd::Random(n_batches * batch))
+        , w(p)
+    {
+        w.get().setRandom();
+    }
+
+    Eigen::MatrixXd X;
+    Eigen::VectorXd y;
+    ad::Var<double, ad::vec> w;
+};
+
+static void BM_stream_copy(benchmark::State& state)
+{
+    size_t p = state.range(0);
+    Data d(p);
+    Eigen::MatrixXd X_buf = d.X.leftCols(p);
+    Eigen::VectorXd y_buf = d.y.head(batch);
+    auto Xb = ad::constant_view(X_buf.data(), batch, p);
+    auto yb = ad::constant_view(y_buf.data(), batch);
+    auto expr = ad::bind(ad::sum(ad::pow<2>(yb - ad::dot(Xb, d.w))));
+
+    for (auto _ : state) {
+        for (size_t b = 0; b < n_batches; ++b) {
+            X_buf = d.X.middleCols(b * p, p);
+            y_buf = d.y.segment(b * batch, batch);
+            benchmark::DoNotOptimize(ad::autodiff(expr));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n_batches * batch);
+}
+
+BENCHMARK(BM_stream_copy)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_stream_slot(benchmark::State& state)
+{
+    size_t p = state.range(0);
+    Data d(p);
+    auto Xb = ad::data_slot(d.X.data(), batch, p);
+    auto yb = ad::data_slot(d.y.data(), batch);
+    auto expr = ad::bind(ad::sum(ad::pow<2>(yb - ad::dot(Xb, d.w))));
+
+    for (auto _ : state) {
+        for (size_t b = 0; b < n_batches; ++b) {
+            Xb.set_data(d.X.data() + b * batch * p);
+            yb.set_data(d.y.data() + b * batch);
+            benchmark::DoNotOptimize(ad::autodiff(expr));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n_batches * batch);
+}
+
+BENCHMARK(BM_stream_slot)->RangeMultiplier(4)->Range(4, 1024);
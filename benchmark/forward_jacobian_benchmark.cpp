@@ -0,0 +1,40 @@
+#include <fastad_bits/forward/core/jacobian.hpp>
+#include <benchmark/benchmark.h>
+
+// Dense Jacobian of a chained map R^n -> R^n in state.range(0) dimensions
+// with N directions per forward evaluation.
+
+static auto f = [](const auto& x) {
+    using fvalue_t = std::decay_t<decltype(x(0))>;
+    Eigen::Matrix<fvalue_t, Eigen::Dynamic, 1> y(x.size());
+    fvalue_t acc = x(0);
+    for (int i = 0; i < x.size(); ++i) {
+        acc = ad::sin(acc) * x(i) + ad::exp(x(i) / 4.);
+        y(i) = acc;
+    }
+    return y;
+};
+
+template <int N>
+static void BM_forward_jacobian(benchmark::State& state)
+{
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    for (auto _ : state) {
+        auto J = ad::forward_jacobian<N>(f, x);
+        benchmark::DoNotOptimize(J.data());
+    }
+}
+
+static void BM_forward_jacobian_dynamic(benchmark::State& state)
+{
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    for (auto _ : state) {
+        auto J = ad::forward_jacobian<Eigen::Dynamic>(f, x, 8);
+        benchmark::DoNotOptimize(J.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_forward_jacobian, 1)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_forward_jacobian, 4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_forward_jacobian, 8)->Arg(16)->Arg(64);
+BENCHMARK(BM_forward_jacobian_dynamic)->Arg(16)->Arg(64);
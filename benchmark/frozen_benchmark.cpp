@@ -0,0 +1,110 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <vector>
+
+// Block-wise gradient of a model made of state.range(0) blocks:
+// sum_k sum((y_k - X_k w_k)^2) with (256 x 16) data X_k.
+// "frozen" freezes the parameters of every block but the first,
+// so only the first block is backward evaluated.
+
+static constexpr size_t n = 256;
+static constexpr size_t p = 16;
+
+struct Blocks
+{
+    Blocks(size_t K)
+        : idx(K)
+    {
+        std::iota(idx.begin(), idx.end(), 0);
+        for (size_t k = 0; k < K; ++k) {
+            X.emplace_back(Eigen::MatrixXd::Random(n, p));
+            y.emplace_back(Eigen::VectorXd::Random(n));
+            w.emplace_back(p);
+            w.back().get().setRandom();
+        }
+    }
+
+    auto model()
+    {
+        return ad::bind(ad::sum(idx.begin(), idx.end(), [&](size_t k) {
+                    return ad::sum(ad::pow<2>(ad::constant_view(y[k].data(), n) -
+                                ad::dot(ad::constant_view(X[k].data(), n, p), w[k])));
+                }));
+    }
+
+    std::vector<size_t> idx;
+    std::vector<Eigen::MatrixXd> X;
+    std::vector<Eigen::VectorXd> y;
+    std::vector<ad::Var<double, ad::vec>> w;
+};
+
+template <class ExprType>
+static void run(benchmark::State& state, ExprType& expr)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_autodiff(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    auto expr = b.model();
+    run(state, expr);
+}
+
+BENCHMARK(BM_autodiff)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_autodiff_frozen(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    for (size_t k = 1; k < b.w.size(); ++k) b.w[k].freeze();
+    auto expr = b.model();
+    run(state, expr);
+}
+
+BENCHMARK(BM_autodiff_frozen)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_bind(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(b.model());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_bind)->RangeMultiplier(4)->Range(4, 256);
+
+// Bind of a chain w_0 * (w_1 * (... * w_{depth-1})) of depth 64
+// whose leaves are all frozen but the last,
+// so that every node along the chain finds out the activity of its children.
+static constexpr size_t depth = 64;
+
+template <size_t d>
+static auto chain(const std::vector<ad::Var<double>>& w, size_t i = 0)
+{
+    if constexpr (d == 1) return ad::VarView<double>(w[i]);
+    else return w[i] * chain<d-1>(w, i+1);
+}
+
+static void BM_bind_deep_frozen(benchmark::State& state)
+{
+    std::vector<ad::Var<double>> w(depth, ad::Var<double>(1.));
+    for (size_t i = 0; i + 1 < depth; ++i) w[i].freeze();
+    auto expr = chain<depth>(w);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ad::bind(expr));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_bind_deep_frozen);
@@ -0,0 +1,72 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/fuse.hpp>
+#include <benchmark/benchmark.h>
+
+// Gradient of a long chain of cheap elementwise operations
+// on vectors of size state.range(0), with and without ad::fuse.
+
+template <class F>
+static void run(benchmark::State& state, F&& wrap)
+{
+    ad::Var<double, ad::vec> x(state.range(0));
+    ad::Var<double, ad::vec> y(state.range(0));
+    x.get().setLinSpaced(-1., 1.);
+    y.get().setLinSpaced(0.5, 2.);
+    auto expr = ad::bind(ad::sum(wrap(
+                    (x * y + 2. * x - y) * (x - 0.5 * y) + x * x - y / 3.)));
+    for (auto _ : state) {
+        x.reset_adj();
+        y.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+// Nests sin(e) * x + x depth times around e.
+template <size_t depth, class X, class E>
+static auto chain(const X& x, const E& e)
+{
+    if constexpr (depth == 0) return e;
+    else return chain<depth-1>(x, ad::sin(e) * x + x);
+}
+
+// Gradient of a deep chain (depth 6) on vectors of size state.range(0).
+template <class F>
+static void run_deep(benchmark::State& state, F&& wrap)
+{
+    ad::Var<double, ad::vec> x(state.range(0));
+    x.get().setLinSpaced(-1., 1.);
+    auto expr = ad::bind(ad::sum(wrap(chain<6>(x, x))));
+    for (auto _ : state) {
+        x.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+static void BM_fuse_off(benchmark::State& state)
+{
+    run(state, [](const auto& e) { return e; });
+}
+
+static void BM_fuse_on(benchmark::State& state)
+{
+    run(state, [](const auto& e) { return ad::fuse(e); });
+}
+
+static void BM_fuse_deep_off(benchmark::State& state)
+{
+    run_deep(state, [](const auto& e) { return e; });
+}
+
+static void BM_fuse_deep_on(benchmark::State& state)
+{
+    run_deep(state, [](const auto& e) { return ad::fuse(e); });
+}
+
+BENCHMARK(BM_fuse_off)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_fuse_on)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_fuse_deep_off)->Arg(100000);
+BENCHMARK(BM_fuse_deep_on)->Arg(100000);
@@ -0,0 +1,47 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/hessian.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+// Dense Hessian of the extended Rosenbrock function in state.range(0) dimensions.
+// The parallel version computes the columns on every hardware thread.
+
+static auto rosenbrock(const std::vector<size_t>& idx)
+{
+    return [&](auto& x) {
+        return ad::sum(idx.begin(), idx.end(), [&](size_t i) {
+            auto d = x[i+1] - x[i] * x[i];
+            auto e = 1. - x[i];
+            return 100. * d * d + e * e;
+        });
+    };
+}
+
+static void BM_hessian_seq(benchmark::State& state)
+{
+    std::vector<size_t> idx(state.range(0) - 1);
+    std::iota(idx.begin(), idx.end(), 0);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    for (auto _ : state) {
+        auto H = ad::hessian(rosenbrock(idx), x);
+        benchmark::DoNotOptimize(H.data());
+    }
+}
+
+static void BM_hessian_par(benchmark::State& state)
+{
+    std::vector<size_t> idx(state.range(0) - 1);
+    std::iota(idx.begin(), idx.end(), 0);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    auto policy = ad::par();
+    for (auto _ : state) {
+        auto H = ad::hessian(policy, rosenbrock(idx), x);
+        benchmark::DoNotOptimize(H.data());
+    }
+    state.counters["threads"] = policy.n_threads();
+}
+
+BENCHMARK(BM_hessian_seq)->Arg(16)->Arg(128);
+BENCHMARK(BM_hessian_par)->Arg(16)->Arg(128);
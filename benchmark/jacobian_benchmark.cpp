@@ -0,0 +1,55 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/jacobian.hpp>
+#include <benchmark/benchmark.h>
+#include <tuple>
+
+// Jacobian of x -> sin(A * x) + exp(x[0]) with A of size m x n,
+// n = 4 * m = state.range(0) (reverse mode is chosen).
+// "rows" computes one row per sweep on a bound expression,
+// "blocked" computes K rows per sweep with lane adjoints.
+
+static Eigen::MatrixXd make_A(size_t n)
+{
+    return Eigen::MatrixXd::Random(n / 4, n);
+}
+
+static void BM_jacobian_rows(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Eigen::MatrixXd A = make_A(n);
+    ad::Var<double, ad::vec> x(n);
+    x.get().setLinSpaced(-1., 1.);
+    auto expr = ad::bind(ad::sin(ad::dot(A, x)) + ad::exp(x[0]));
+    for (auto _ : state) {
+        auto J = ad::jacobian(expr, x);
+        benchmark::DoNotOptimize(J.data());
+    }
+}
+
+template <int K>
+static void BM_jacobian_blocked(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Eigen::MatrixXd A = make_A(n);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(n, -1., 1.);
+    // A cast to every value type f is called with, viewed without copies
+    auto As = std::make_tuple(A,
+            Eigen::Matrix<ad::Lanes<double, K>, Eigen::Dynamic, Eigen::Dynamic>(A.cast<ad::Lanes<double, K>>()),
+            Eigen::Matrix<ad::ForwardVar<double, K>, Eigen::Dynamic, Eigen::Dynamic>(A.cast<ad::ForwardVar<double, K>>()));
+    auto f = [&](auto& x) {
+        using v_t = typename std::decay_t<decltype(x)>::value_t;
+        const auto& Av = std::get<Eigen::Matrix<v_t, Eigen::Dynamic, Eigen::Dynamic>>(As);
+        return ad::sin(ad::dot(ad::constant_view(Av.data(), Av.rows(), Av.cols()), x)) +
+               ad::exp(x[0]);
+    };
+    for (auto _ : state) {
+        auto J = ad::jacobian<K>(f, x);
+        benchmark::DoNotOptimize(J.data());
+    }
+}
+
+BENCHMARK(BM_jacobian_rows)->Arg(32)->Arg(128);
+BENCHMARK_TEMPLATE(BM_jacobian_blocked, 4)->Arg(32)->Arg(128);
+BENCHMARK_TEMPLATE(BM_jacobian_blocked, 8)->Arg(32)->Arg(128);
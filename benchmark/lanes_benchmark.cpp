@@ -0,0 +1,98 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/lanes.hpp>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Delta of every option and total vega of a book of state.range(0) Black-Scholes call options.
+// The scalar version sweeps once per option.
+// The lane version sweeps once per W options.
+
+static void make_book(size_t size,
+                      std::vector<double>& S,
+                      std::vector<double>& K,
+                      std::vector<double>& tau)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> spot(90., 110.);
+    std::uniform_real_distribution<double> strike(80., 120.);
+    std::uniform_real_distribution<double> maturity(0.1, 2.);
+    S.resize(size); K.resize(size); tau.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        S[i] = spot(gen);
+        K[i] = strike(gen);
+        tau[i] = maturity(gen);
+    }
+}
+
+template <class VarType>
+static auto call_price(const VarType& S, const VarType& K, const VarType& tau, 
+                       const VarType& sigma, double r)
+{
+    auto Phi = [](const auto& x) 
+        { return 0.5 * (ad::erf(x / std::sqrt(2.)) + 1.); };
+    auto sq = ad::sqrt(tau);
+    auto d1 = (ad::log(S / K) + (r + sigma * sigma / 2.) * tau) / (sigma * sq);
+    auto d2 = d1 - sigma * sq;
+    return Phi(d1) * S - Phi(d2) * K * ad::exp(-r * tau);
+}
+
+static void BM_lanes_scalar(benchmark::State& state)
+{
+    std::vector<double> S_data, K_data, tau_data, delta(state.range(0));
+    make_book(state.range(0), S_data, K_data, tau_data);
+
+    ad::Var<double> S, K, tau, sigma(0.25);
+    auto expr = ad::bind(call_price(S, K, tau, sigma, 0.0125));
+
+    for (auto _ : state) {
+        sigma.reset_adj();
+        for (size_t i = 0; i < S_data.size(); ++i) {
+            S.get() = S_data[i];
+            K.get() = K_data[i];
+            tau.get() = tau_data[i];
+            S.reset_adj();
+            ad::autodiff(expr);
+            delta[i] = S.get_adj();
+        }
+        benchmark::DoNotOptimize(sigma.get_adj());
+        benchmark::DoNotOptimize(delta.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_lanes_scalar)->RangeMultiplier(10)->Range(1000, 100000);
+
+template <int W>
+static void BM_lanes(benchmark::State& state)
+{
+    using lanes_t = ad::Lanes<double, W>;
+    std::vector<double> S_data, K_data, tau_data, delta(state.range(0));
+    make_book(state.range(0), S_data, K_data, tau_data);
+
+    ad::Var<lanes_t> S, K, tau, sigma(lanes_t(0.25));
+    auto expr = ad::bind(call_price(S, K, tau, sigma, 0.0125));
+
+    // assumes the book size is a multiple of W
+    for (auto _ : state) {
+        sigma.reset_adj();
+        for (size_t i = 0; i < S_data.size(); i += W) {
+            for (int k = 0; k < W; ++k) {
+                S.get()[k] = S_data[i+k];
+                K.get()[k] = K_data[i+k];
+                tau.get()[k] = tau_data[i+k];
+            }
+            S.reset_adj();
+            ad::autodiff(expr, lanes_t(1.));
+            for (int k = 0; k < W; ++k) delta[i+k] = S.get_adj()[k];
+        }
+        benchmark::DoNotOptimize(sigma.get_adj().sum());
+        benchmark::DoNotOptimize(delta.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_lanes, 4)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_lanes, 8)->RangeMultiplier(10)->Range(1000, 100000);
@@ -0,0 +1,56 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
+#include <benchmark/benchmark.h>
+
+// Gradient of a normal log-pdf, the log determinant of its covariance S
+// and a quadratic form of S, with S of size state.range(0).
+// "separate" factors S in every node and "shared" factors it once with ad::llt.
+
+static void init(ad::Var<double, ad::mat>& S,
+                 ad::Var<double, ad::vec>& x,
+                 ad::Var<double, ad::vec>& mu)
+{
+    size_t n = S.rows();
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(n, n);
+    S.get() = A * A.transpose() + n * Eigen::MatrixXd::Identity(n, n);
+    x.get().setLinSpaced(-1., 1.);
+    mu.get().setZero();
+}
+
+static void BM_llt_separate(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    ad::Var<double, ad::mat> S(n, n);
+    ad::Var<double, ad::vec> x(n), mu(n);
+    init(S, x, mu);
+    auto expr = ad::bind(ad::normal_adj_log_pdf(x, mu, S) +
+                         ad::log_det<ad::LogDetLLT>(S) +
+                         ad::inv_quad_form(S, x));
+    for (auto _ : state) {
+        S.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+static void BM_llt_shared(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    ad::Var<double, ad::mat> S(n, n);
+    ad::Var<double, ad::vec> x(n), mu(n);
+    init(S, x, mu);
+    auto L = ad::llt(S);
+    auto expr = ad::bind(ad::normal_adj_log_pdf(x, mu, L) +
+                         ad::log_det(L) +
+                         ad::inv_quad_form(L, x));
+    for (auto _ : state) {
+        S.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+BENCHMARK(BM_llt_separate)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_llt_shared)->Arg(16)->Arg(64)->Arg(256);
@@ -0,0 +1,116 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/var_view.hpp>
+#include <fastad_bits/reverse/core/map_reduce.hpp>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Squared loss of a one-hidden-layer network y = sum(tanh(W x))
+// summed over state.range(0) rows (x, y) with x of size p.
+// "seq" is the row loop of the ceres example:
+// one expression over a row buffer evaluated row by row.
+
+static constexpr size_t p = 8;
+static constexpr size_t n_hidden = 16;
+
+static Eigen::MatrixXd make_data(size_t n)
+{
+    std::mt19937 gen(0);
+    std::normal_distribution<double> dist(0., 1.);
+    Eigen::MatrixXd data(n, p+1);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= p; ++j) {
+            data(i,j) = dist(gen);
+        }
+    }
+    return data;
+}
+
+static auto loss()
+{
+    return [](const auto& row, auto& W) {
+        auto x = row.segment(0, p);
+        auto y = row.segment(p, 1);
+        return ad::pow<2>(ad::sum(y) - ad::sum(ad::tanh(ad::dot(W, x))));
+    };
+}
+
+static void BM_map_reduce_seq(benchmark::State& state)
+{
+    Eigen::MatrixXd data = make_data(state.range(0));
+    Eigen::VectorXd theta = Eigen::VectorXd::Constant(n_hidden * p, 0.1);
+    Eigen::VectorXd grad(theta.size());
+    ad::VarView<double, ad::mat> W(theta.data(), grad.data(), n_hidden, p);
+
+    Eigen::VectorXd row_buffer(p+1);
+    auto row = ad::data_slot(row_buffer.data(), p+1);
+    auto expr = ad::bind(loss()(row, W));
+
+    for (auto _ : state) {
+        grad.setZero();
+        double total = 0;
+        for (int i = 0; i < data.rows(); ++i) {
+            row_buffer = data.row(i);
+            total += ad::autodiff(expr);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_map_reduce_seq)->RangeMultiplier(10)->Range(1000, 100000)
+                            ->UseRealTime();
+
+static void BM_map_reduce_par(benchmark::State& state)
+{
+    Eigen::MatrixXd data = make_data(state.range(0));
+    Eigen::VectorXd theta = Eigen::VectorXd::Constant(n_hidden * p, 0.1);
+    Eigen::VectorXd grad(theta.size());
+    ad::VarView<double, ad::mat> W(theta.data(), grad.data(), n_hidden, p);
+    auto policy = ad::par(state.range(1), state.range(2));
+
+    for (auto _ : state) {
+        grad.setZero();
+        benchmark::DoNotOptimize(ad::map_reduce(policy, data, loss(), W));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Serial map_reduce on column-major data, whose rows are copied,
+// and on the same data stored row-major, whose rows are viewed in place.
+template <class Data>
+static void run_layout(benchmark::State& state)
+{
+    Data data = make_data(state.range(0));
+    Eigen::VectorXd theta = Eigen::VectorXd::Constant(n_hidden * p, 0.1);
+    Eigen::VectorXd grad(theta.size());
+    ad::VarView<double, ad::mat> W(theta.data(), grad.data(), n_hidden, p);
+
+    for (auto _ : state) {
+        grad.setZero();
+        benchmark::DoNotOptimize(ad::map_reduce(data, loss(), W));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_map_reduce_col_major(benchmark::State& state)
+{
+    run_layout<Eigen::MatrixXd>(state);
+}
+
+static void BM_map_reduce_row_major(benchmark::State& state)
+{
+    run_layout<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                             Eigen::RowMajor>>(state);
+}
+
+BENCHMARK(BM_map_reduce_col_major)->Arg(100000);
+BENCHMARK(BM_map_reduce_row_major)->Arg(100000);
+
+// args: number of rows, number of threads, deterministic
+BENCHMARK(BM_map_reduce_par)
+    ->ArgsProduct({{1000, 10000, 100000}, {1, 2, 4, 8}, {0, 1}})
+    ->UseRealTime();
@@ -0,0 +1,97 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/memo.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <vector>
+
+// Coordinate-wise updates of a model made of state.range(0) blocks:
+// sum_k sum((y_k - X_k w_k)^2) with (256 x 16) data X_k.
+// Every iteration changes the parameters of one block and evaluates the model.
+// "memo" memoizes every block, so only the changed block is evaluated again.
+
+static constexpr size_t n = 256;
+static constexpr size_t p = 16;
+
+struct Blocks
+{
+    Blocks(size_t K)
+        : idx(K)
+    {
+        std::iota(idx.begin(), idx.end(), 0);
+        for (size_t k = 0; k < K; ++k) {
+            X.emplace_back(Eigen::MatrixXd::Random(n, p));
+            y.emplace_back(Eigen::VectorXd::Random(n));
+            w.emplace_back(p);
+            w.back().get().setRandom();
+        }
+    }
+
+    auto block(size_t k)
+    {
+        return ad::sum(ad::pow<2>(ad::constant_view(y[k].data(), n) -
+                    ad::dot(ad::constant_view(X[k].data(), n, p), w[k])));
+    }
+
+    std::vector<size_t> idx;
+    std::vector<Eigen::MatrixXd> X;
+    std::vector<Eigen::VectorXd> y;
+    std::vector<ad::Var<double, ad::vec>> w;
+};
+
+template <class ExprType, class F>
+static void run(benchmark::State& state, Blocks& b, ExprType& expr, F&& eval)
+{
+    size_t k = 0;
+    for (auto _ : state) {
+        b.w[k].get()(0) += 1e-3;
+        benchmark::DoNotOptimize(eval(expr));
+        k = (k + 1) % b.idx.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_evaluate(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    auto expr = ad::bind(ad::sum(b.idx.begin(), b.idx.end(),
+                [&](size_t k) { return b.block(k); }));
+    run(state, b, expr, [](auto& e) { return ad::evaluate(e); });
+}
+
+BENCHMARK(BM_evaluate)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_evaluate_memo(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    auto expr = ad::bind(ad::sum(b.idx.begin(), b.idx.end(),
+                [&](size_t k) { return ad::memo(b.block(k)); }));
+    run(state, b, expr, [](auto& e) { return ad::evaluate(e); });
+}
+
+BENCHMARK(BM_evaluate_memo)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_autodiff(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    auto expr = ad::bind(ad::sum(b.idx.begin(), b.idx.end(),
+                [&](size_t k) { return b.block(k); }));
+    run(state, b, expr, [](auto& e) { return ad::autodiff(e); });
+}
+
+BENCHMARK(BM_autodiff)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_autodiff_memo(benchmark::State& state)
+{
+    Blocks b(state.range(0));
+    auto expr = ad::bind(ad::sum(b.idx.begin(), b.idx.end(),
+                [&](size_t k) { return ad::memo(b.block(k)); }));
+    run(state, b, expr, [](auto& e) { return ad::autodiff(e); });
+}
+
+BENCHMARK(BM_autodiff_memo)->RangeMultiplier(4)->Range(4, 256);
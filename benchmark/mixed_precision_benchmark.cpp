@@ -0,0 +1,105 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/norm.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/adj_buffer.hpp>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Gradient of a memory-bandwidth bound expression on two vectors
+// of size state.range(0) with float and double values.
+
+template <class T>
+static void BM_mixed_precision_vec(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    ad::Var<T, ad::vec> v(n), w(n);
+    v.get().setRandom();
+    w.get().setRandom();
+    auto expr = ad::bind(ad::norm(v - w) + ad::sum(v * w * 0.5));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * n * 4 * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_mixed_precision_vec, double)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_mixed_precision_vec, float)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+// Gradient of a squared loss summed over state.range(0) rows (x, y)
+// evaluated row by row, as in a data loop.
+// "rel_err" is the relative error of the gradient w.r.t. the double gradient.
+// "acc" accumulates the float gradient in double (see ad::AdjAccumulator).
+
+static constexpr size_t p = 16;
+
+static Eigen::MatrixXd make_data(size_t n)
+{
+    std::mt19937 gen(0);
+    std::normal_distribution<double> dist(0., 1.);
+    Eigen::MatrixXd data(n, p+1);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= p; ++j) {
+            data(i,j) = dist(gen);
+        }
+    }
+    return data;
+}
+
+template <class T>
+static Eigen::VectorXd gradient(const Eigen::MatrixXd& data, bool acc)
+{
+    using vec_t = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    ad::Var<T, ad::vec> w(p);
+    w.get().setConstant(0.1);
+    vec_t row(p+1);
+    auto x = ad::constant_view(row.data(), p);
+    auto y = ad::constant_view(row.data() + p, 1);
+    auto expr = ad::bind(ad::pow<2>(ad::sum(y) - ad::sum(x * w)));
+
+    auto loop = [&]() {
+        for (int i = 0; i < data.rows(); ++i) {
+            row = data.row(i).transpose().template cast<T>();
+            ad::autodiff(expr);
+        }
+    };
+    if constexpr (std::is_same_v<T, float>) {
+        if (acc) {
+            ad::AdjAccumulator<float> accumulator(w);
+            loop();
+            accumulator.flush();
+            return w.get_adj().template cast<double>();
+        }
+    }
+    loop();
+    return w.get_adj().template cast<double>();
+}
+
+template <class T>
+static void BM_mixed_precision_rows(benchmark::State& state)
+{
+    Eigen::MatrixXd data = make_data(state.range(0));
+    bool acc = state.range(1);
+    Eigen::VectorXd g;
+
+    for (auto _ : state) {
+        g = gradient<T>(data, acc);
+        benchmark::DoNotOptimize(g.data());
+    }
+    Eigen::VectorXd g_ref = gradient<double>(data, false);
+    state.counters["rel_err"] = (g - g_ref).norm() / g_ref.norm();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// args: number of rows, accumulate in double
+BENCHMARK_TEMPLATE(BM_mixed_precision_rows, double)
+    ->ArgsProduct({{10000, 1000000}, {0}});
+BENCHMARK_TEMPLATE(BM_mixed_precision_rows, float)
+    ->ArgsProduct({{10000, 1000000}, {0, 1}});
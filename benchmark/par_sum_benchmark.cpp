@@ -0,0 +1,88 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Normal log-likelihood of a linear regression model
+// summed over state.range(0) observations.
+
+static void make_data(size_t size,
+                      std::vector<double>& x,
+                      std::vector<double>& y)
+{
+    std::mt19937 gen(0);
+    std::normal_distribution<double> dist(0., 1.);
+    x.resize(size);
+    y.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        x[i] = dist(gen);
+        y[i] = 2. * x[i] + 1. + dist(gen);
+    }
+}
+
+static void BM_sumnode_seq(benchmark::State& state)
+{
+    using namespace ad;
+    std::vector<double> x, y;
+    make_data(state.range(0), x, y);
+    std::vector<Var<double>> w(3);
+    w[0].get() = 2.;
+    w[1].get() = 1.;
+    w[2].get() = 1.;
+
+    size_t i = 0;
+    auto expr = ad::bind(
+        ad::sum(x.begin(), x.end(),
+            [&](double xi) {
+                auto&& expr = ad::pow<2>((ad::constant(y[i]) - 
+                                          w[0] * xi - w[1]) / w[2]);
+                ++i;
+                return expr;
+            }));
+
+    for (auto _ : state) {
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_sumnode_seq)->RangeMultiplier(10)->Range(1000, 1000000)
+                         ->UseRealTime();
+
+static void BM_sumnode_par(benchmark::State& state)
+{
+    using namespace ad;
+    std::vector<double> x, y;
+    make_data(state.range(0), x, y);
+    std::vector<Var<double>> w(3);
+    w[0].get() = 2.;
+    w[1].get() = 1.;
+    w[2].get() = 1.;
+
+    size_t i = 0;
+    auto expr = ad::bind(
+        ad::sum(ad::par(state.range(1), state.range(2)), 
+                x.begin(), x.end(),
+            [&](double xi) {
+                auto&& expr = ad::pow<2>((ad::constant(y[i]) - 
+                                          w[0] * xi - w[1]) / w[2]);
+                ++i;
+                return expr;
+            }));
+
+    for (auto _ : state) {
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// args: number of observations, number of threads, deterministic
+BENCHMARK(BM_sumnode_par)
+    ->ArgsProduct({{1000, 10000, 100000, 1000000}, {1, 2, 4, 8}, {0, 1}})
+    ->UseRealTime();
@@ -0,0 +1,100 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/schedule.hpp>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Value of a book of state.range(0) Black-Scholes call options
+// on the same underlying (spot S and volatility sigma are shared).
+// Every option is a small program of 3 statements,
+// so the options are independent of one another except for S and sigma.
+
+struct Book
+{
+    Book(size_t size)
+        : S(105.), sigma(0.25)
+        , K(size), tau(size)
+        , cache(3 * size)
+    {
+        std::mt19937 gen(0);
+        std::uniform_real_distribution<double> strike(80., 120.);
+        std::uniform_real_distribution<double> maturity(0.1, 2.);
+        for (size_t i = 0; i < size; ++i) {
+            K[i] = strike(gen);
+            tau[i] = maturity(gen);
+        }
+        idx.resize(size);
+        for (size_t i = 0; i < size; ++i) idx[i] = i;
+    }
+
+    auto option(size_t i)
+    {
+        auto Phi = [](const auto& x) 
+            { return 0.5 * (ad::erf(x / std::sqrt(2.)) + 1.); };
+        double sq = std::sqrt(tau[i]);
+        double PV = K[i] * std::exp(-r * tau[i]);
+        auto& d1 = cache[3*i];
+        auto& d2 = cache[3*i+1];
+        auto& price = cache[3*i+2];
+        return (d1 = (ad::log(S / K[i]) + (r + sigma * sigma / 2.) * tau[i]) / 
+                        (sigma * sq),
+                d2 = d1 - sigma * sq,
+                price = Phi(d1) * S - Phi(d2) * PV);
+    }
+
+    auto program()
+    {
+        return (ad::for_each(idx.begin(), idx.end(), 
+                             [&](size_t i) { return option(i); }),
+                ad::sum(cache.begin(), cache.end(), 
+                        [](const ad::VarView<double>& c) { return c; }));
+    }
+
+    ad::Var<double> S;
+    ad::Var<double> sigma;
+    double r = 0.0125;
+    std::vector<double> K;
+    std::vector<double> tau;
+    std::vector<size_t> idx;
+    std::vector<ad::Var<double>> cache;
+};
+
+static void BM_schedule_seq(benchmark::State& state)
+{
+    Book book(state.range(0));
+    auto expr = ad::bind(book.program());
+
+    for (auto _ : state) {
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_schedule_seq)->RangeMultiplier(10)->Range(100, 100000)
+                          ->UseRealTime();
+
+static void BM_schedule_par(benchmark::State& state)
+{
+    Book book(state.range(0));
+    auto expr = ad::bind(
+            ad::schedule(ad::par(state.range(1), state.range(2)), 
+                         book.program()));
+
+    for (auto _ : state) {
+        ad::autodiff(expr);
+        benchmark::DoNotOptimize(expr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// args: number of options, number of threads, deterministic
+BENCHMARK(BM_schedule_par)
+    ->ArgsProduct({{100, 1000, 10000, 100000}, {1, 2, 4, 8}, {0, 1}})
+    ->UseRealTime();
@@ -0,0 +1,56 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/share.hpp>
+#include <benchmark/benchmark.h>
+
+// Gradient of f(v, x) = sum(u * u + sin(u) + u) with u = exp(v) * x
+// and v of size state.range(0).
+// "duplicated" repeats u three times, "placeholder" stores it in a Var
+// and "shared" uses ad::share.
+
+static void BM_share_duplicated(benchmark::State& state)
+{
+    ad::Var<double, ad::vec> v(state.range(0));
+    ad::Var<double> x(0.3);
+    v.get().setLinSpaced(-1., 1.);
+    auto u = ad::exp(v) * x;
+    auto expr = ad::bind(ad::sum(u * u + ad::sin(u) + u));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+static void BM_share_placeholder(benchmark::State& state)
+{
+    ad::Var<double, ad::vec> v(state.range(0));
+    ad::Var<double, ad::vec> w(state.range(0));
+    ad::Var<double> x(0.3);
+    v.get().setLinSpaced(-1., 1.);
+    auto expr = ad::bind((w = ad::exp(v) * x,
+                          ad::sum(w * w + ad::sin(w) + w)));
+    for (auto _ : state) {
+        w.reset_adj();
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+static void BM_share_shared(benchmark::State& state)
+{
+    ad::Var<double, ad::vec> v(state.range(0));
+    ad::Var<double> x(0.3);
+    v.get().setLinSpaced(-1., 1.);
+    auto u = ad::share(ad::exp(v) * x);
+    auto expr = ad::bind(ad::sum(u * u + ad::sin(u) + u));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ad::autodiff(expr));
+    }
+}
+
+BENCHMARK(BM_share_duplicated)->Arg(64)->Arg(1024);
+BENCHMARK(BM_share_placeholder)->Arg(64)->Arg(1024);
+BENCHMARK(BM_share_shared)->Arg(64)->Arg(1024);
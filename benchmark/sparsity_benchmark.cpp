@@ -0,0 +1,59 @@
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/sparsity.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+// Hessian of the extended Rosenbrock function (tridiagonal) in state.range(0) dimensions.
+// The sparse versions need 3 Hessian-vector products for any dimension;
+// "sparse_reuse" reuses the sparsity pattern detected once.
+
+static auto rosenbrock(const std::vector<size_t>& idx)
+{
+    return [&](auto& x) {
+        return ad::sum(idx.begin(), idx.end(), [&](size_t i) {
+            auto d = x[i+1] - x[i] * x[i];
+            auto e = 1. - x[i];
+            return 100. * d * d + e * e;
+        });
+    };
+}
+
+static void BM_hessian_dense(benchmark::State& state)
+{
+    std::vector<size_t> idx(state.range(0) - 1);
+    std::iota(idx.begin(), idx.end(), 0);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    for (auto _ : state) {
+        auto H = ad::hessian(rosenbrock(idx), x);
+        benchmark::DoNotOptimize(H.data());
+    }
+}
+
+static void BM_hessian_sparse(benchmark::State& state)
+{
+    std::vector<size_t> idx(state.range(0) - 1);
+    std::iota(idx.begin(), idx.end(), 0);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    for (auto _ : state) {
+        auto H = ad::sparse_hessian(rosenbrock(idx), x);
+        benchmark::DoNotOptimize(H.valuePtr());
+    }
+}
+
+static void BM_hessian_sparse_reuse(benchmark::State& state)
+{
+    std::vector<size_t> idx(state.range(0) - 1);
+    std::iota(idx.begin(), idx.end(), 0);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(state.range(0), -1., 1.);
+    auto pattern = ad::hessian_sparsity(rosenbrock(idx), x);
+    for (auto _ : state) {
+        auto H = ad::sparse_hessian(rosenbrock(idx), x, pattern);
+        benchmark::DoNotOptimize(H.valuePtr());
+    }
+}
+
+BENCHMARK(BM_hessian_dense)->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_hessian_sparse)->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_hessian_sparse_reuse)->Arg(16)->Arg(128)->Arg(512);
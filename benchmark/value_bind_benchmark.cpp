@@ -0,0 +1,71 @@
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <vector>
+
+// Scoring a trained model: forward evaluation of
+// sum_i exp(sum(x_i * w)) * v_i over state.range(0) summands,
+// bound with ad::bind (value and adjoint cache) or ad::bind_value (value cache only).
+// Bound expressions are rebuilt every iteration, as in a scoring path
+// that binds a new expression per request.
+
+struct Model
+{
+    Model(size_t n)
+        : X(Eigen::MatrixXd::Random(8, n))
+        , idx(n)
+        , w(8)
+        , v(n)
+    {
+        std::iota(idx.begin(), idx.end(), 0);
+        w.get().setRandom();
+        v.get().setRandom();
+    }
+
+    auto expr()
+    {
+        return ad::sum(idx.begin(), idx.end(), [&](size_t i) {
+                    auto xi = ad::constant_view(X.col(i).data(), X.rows());
+                    return ad::exp(ad::sum(xi * w)) * v[i];
+                });
+    }
+
+    Eigen::MatrixXd X;
+    std::vector<size_t> idx;
+    ad::Var<double, ad::vec> w;
+    ad::Var<double, ad::vec> v;
+};
+
+static void BM_score_bind(benchmark::State& state)
+{
+    Model m(state.range(0));
+    ad::util::CachePool pool;
+    for (auto _ : state) {
+        auto expr = ad::bind(m.expr(), pool);
+        benchmark::DoNotOptimize(ad::evaluate(expr));
+    }
+    state.counters["cache_bytes"] = pool.high_water_mark();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_score_bind)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+
+static void BM_score_bind_value(benchmark::State& state)
+{
+    Model m(state.range(0));
+    ad::util::CachePool pool;
+    for (auto _ : state) {
+        auto expr = ad::bind_value(m.expr(), pool);
+        benchmark::DoNotOptimize(ad::evaluate(expr));
+    }
+    state.counters["cache_bytes"] = pool.high_water_mark();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_score_bind_value)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
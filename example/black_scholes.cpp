@@ -44,8 +44,12 @@ int main()
     double sigma = 5;        
     double tau = 30.0 / 365; 
     double r = 1.25 / 100;   
-    ad::Var<double> S(105);  
-    std::vector<ad::Var<double>> cache;
+    ad::VarView<double> S;
+    std::vector<ad::VarView<double>> cache(3);
+
+    // S and cache live in one block whose adjoints are reset at once
+    ad::Workspace<double> ws(S, cache);
+    S.get() = 105;
 
     auto call_expr = ad::bind(
             black_scholes_option_price<option_type::call>(
@@ -57,8 +61,7 @@ int main()
     std::cout << S.get_adj() << std::endl;
 
     // reset adjoints before differentiating again
-    S.reset_adj();
-    for (auto& c : cache) c.reset_adj();
+    ws.reset_adj();
 
     auto put_expr = ad::bind(
             black_scholes_option_price<option_type::put>(
@@ -6,7 +6,8 @@
 using namespace ad;
 // A3*s(A2*s(A1*x+b1)+b2+(A1*x+b1))+b3
 struct NN {
-    Eigen::MatrixXd X, y;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> X;
+    Eigen::MatrixXd y;
     NN(const Eigen::MatrixXd &X, const Eigen::VectorXd &y)
         : X(X), y(y){
 
@@ -28,11 +29,9 @@ struct NN {
 
         Var<double, mat> x1(3, 1), y1(3, 1), y2(3, 1), y3(1, 1), residual_norm2(1, 1); //(1, 1);
         // Var<double, mat> y3(1, 1);
-        // data buffer
-        Eigen::VectorXd x_row_buffer = X.row(0);
-        auto xi = constant_view(x_row_buffer.data(), X.cols(), 1);
-        Eigen::VectorXd y_row_buffer = y.row(0);
-        auto yi = constant_view(y_row_buffer.data(), y.cols(), 1);
+        // data slots (X is row-major, so each row is contiguous)
+        auto xi = data_slot(X.row(0).data(), X.cols(), 1);
+        auto yi = data_slot(y.data(), y.cols(), 1);
 
         // Expression
         auto expr =
@@ -46,8 +45,8 @@ struct NN {
         // Loop over each row to calulate loss.
         double loss = 0;
         for (int i = 0; i < X.rows(); ++i) {
-            x_row_buffer = X.row(i);
-            y_row_buffer = y.row(i);
+            xi.set_data(X.row(i).data());
+            yi.set_data(y.data() + i);
 
             auto f = autodiff(expr, seed.array());
             // std::cout << "pred " << i << " " << y3.get() << std::endl;
@@ -1,21 +1,51 @@
 #pragma once
+#include <type_traits>
+#include <Eigen/Core>
 
 namespace ad {
 namespace core {
 
+namespace details {
+
+// Type of the N tangents of a dual number.
+// A single tangent is a plain value and N > 1 (or Eigen::Dynamic) tangents are
+// a contiguous Eigen array so that they are updated with SIMD instructions.
+template <class T, int N>
+struct tangent
+{
+    static_assert(N == Eigen::Dynamic || N >= 1);
+    using type = Eigen::Array<T, N, 1>;
+    static type zero() { return (N == Eigen::Dynamic) ? type() : type::Zero(N); }
+};
+
+template <class T>
+struct tangent<T, 1>
+{
+    using type = T;
+    static type zero() { return 0; }
+};
+
+} // namespace details
+
 // Underlying data structure containing value and adjoint.
 // Represent value as "w" and adjoint as "df".
+// The adjoint holds N tangents (directional derivatives) if N > 1.
+// If N is Eigen::Dynamic, the number of tangents is set at run-time
+// and defaults to 0 (see ADForward).
 // @tparam T    underlying data type (ex. double)
-template <class T>
+// @tparam N    number of tangents (default 1)
+template <class T, int N = 1>
 struct DualNum
 {
     using value_type = T;
+    using tangent_type = typename details::tangent<T, N>::type;
+    static constexpr int n_tangents = N;
 
-    DualNum(T w, T df)
+    DualNum(T w, const tangent_type& df)
         : w_(w), df_(df)
     {}
 
-    value_type& get_value() 
+    value_type& get_value()
     {
         return w_;
     }
@@ -25,30 +55,30 @@ struct DualNum
         return w_;
     }
 
-    value_type& set_value(value_type x) 
+    value_type& set_value(value_type x)
     {
         return w_ = x;
     }
 
-    value_type& get_adjoint() 
+    tangent_type& get_adjoint()
     {
         return df_;
     }
 
-    const value_type& get_adjoint() const
+    const tangent_type& get_adjoint() const
     {
         return df_;
     }
 
-    value_type& set_adjoint(value_type x) 
+    tangent_type& set_adjoint(const tangent_type& x)
     {
         return df_ = x;
     }
 
 private:
     T w_;
-    T df_;   
+    tangent_type df_;
 };
 
 } // namepsace core
-} // namespace ad 
+} // namespace ad
@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include <Eigen/Core>
 #include <fastad_bits/forward/core/dualnum.hpp>
 
 // Forward-mode Automatic Differentiation
@@ -10,37 +11,39 @@
 // The variadic arguments are optional and represent code to be placed before executing
 // "first" and "second" for optimization purposes.
 // @tparam  T   underlying data type for x.
+// @tparam  N   number of tangents of x.
 // @param   x   variable to apply unary function to
-// @return a new ADForward<T> with value and adjoint as the mathematical values for f(x), f'(x) * x'.
+// @return a new ADForward<T, N> with value and adjoint as the mathematical values for f(x), f'(x) * x'.
+// If N > 1, "second" is evaluated on all tangents at once.
 //
 // Example generation with no variadic arguments:
 //
 // FORWARD_UNARY_FUNC(sin, std::sin(x.get_value()), std::cos(x.get_value()) * x.get_adjoint())
 // =>
-// template <class T> 
-// inline auto sin(const ad::core::ADForward<T>& x) 
+// template <class T, int N> 
+// inline auto sin(const ad::core::ADForward<T, N>& x) 
 // { 
-//      return ad::core::ADForward<T>(std::sin(x.get_value()), std::cos(x.get_value()) * x.get_adjoint()); 
+//      return ad::core::ADForward<T, N>(std::sin(x.get_value()), std::cos(x.get_value()) * x.get_adjoint()); 
 // } 
 //
 // Example generation with variadic arguments:
 //
 // FORWARD_UNARY_FUNC(exp, tmp, tmp * x.get_adjoint(), auto tmp = std::exp(x.get_value());)
 // =>
-// template <class T> 
-// inline auto exp(const ad::core::ADForward<T>& x) 
+// template <class T, int N> 
+// inline auto exp(const ad::core::ADForward<T, N>& x) 
 // { 
 //      auto tmp = std::exp(x.get_value());
-//      return ad::core::ADForward<T>(tmp, tmp * x.get_adjoint()); 
+//      return ad::core::ADForward<T, N>(tmp, tmp * x.get_adjoint()); 
 // } 
 //
 // Note that we only compute std::exp(x.get_value()) once and reuse to compute both "first" and "second".
 #define FORWARD_UNARY_FUNC(f, first, second, ...) \
-template <class T> \
-inline auto f(const ad::core::ADForward<T>& x) \
+template <class T, int N> \
+inline auto f(const ad::core::ADForward<T, N>& x) \
 { \
 	__VA_ARGS__ \
-	return ad::core::ADForward<T>(first, second); \
+	return ad::core::ADForward<T, N>(first, second); \
 } \
 
 // Binary function definition with function name "f" that operates on ADForward<T> variables x, y.
@@ -58,16 +61,34 @@ inline auto f(const ad::core::ADForward<T>& x) \
 //
 // FORWARD_BINARY_FUNC(operator+, x.get_value() + y.get_value(), x.get_adjoint() + y.get_adjoint())
 // =>
-// template <class T>
-// inline auto operator+(const ad::core::ADForward<T>& x, ad::core::ADForward<T>& y)
+// template <class T, int N>
+// inline auto operator+(const ad::core::ADForward<T, N>& x, ad::core::ADForward<T, N>& y)
 // {
-//      return ad::core::ADForward<T>(x.get_value() + y.get_value(), x.get_adjoint() + y.get_adjoint());
+//      return ad::core::ADForward<T, N>(x.get_value() + y.get_value(), x.get_adjoint() + y.get_adjoint());
 // }
 #define FORWARD_BINARY_FUNC(f, first, second) \
-template <class T> \
-inline auto f(const ad::core::ADForward<T>& x, const ad::core::ADForward<T>& y) \
+template <class T, int N> \
+inline auto f(const ad::core::ADForward<T, N>& x, const ad::core::ADForward<T, N>& y) \
 { \
-	return ad::core::ADForward<T>(first, second); \
+	return ad::core::ADForward<T, N>(first, second); \
+} \
+
+// Binary function definition with function name "f" where one of the operands is a plain value c of type T.
+// "first_xc", "second_xc" compute f(x, c) and its directional derivative,
+// and "first_cx", "second_cx" compute f(c, x) and its directional derivative.
+// Since c has no tangents, these are cheaper than converting c to ADForward<T, N>.
+#define FORWARD_MIXED_FUNC(f, first_xc, second_xc, first_cx, second_cx) \
+template <class T, int N> \
+inline auto f(const ad::core::ADForward<T, N>& x, \
+              const typename ad::core::ADForward<T, N>::value_type& c) \
+{ \
+	return ad::core::ADForward<T, N>(first_xc, second_xc); \
+} \
+template <class T, int N> \
+inline auto f(const typename ad::core::ADForward<T, N>::value_type& c, \
+              const ad::core::ADForward<T, N>& x) \
+{ \
+	return ad::core::ADForward<T, N>(first_cx, second_cx); \
 } \
 
 namespace ad {
@@ -77,31 +98,52 @@ namespace core {
 // If x is an ADForward variable that is a result of composing functions of ADForward variables x1,...,xn
 // x.get_value() is the value of the function on these variables and x.get_adjoint() is the adjoint, i.e.
 // directional (total) derivative of the composed functions in the direction of x1.get_adjoint(),...,xn.get_adjoint()
-template <class T>
-struct ADForward : public core::DualNum<T>
+//
+// With N > 1, the adjoint holds N directional derivatives in N directions
+// so that one evaluation computes N columns of a Jacobian (see forward_jacobian).
+// With N = Eigen::Dynamic, the number of directions is the size of the adjoints
+// given on construction and must be the same for all variables of a computation.
+// Variables constructed from a value alone have 0 adjoint (no adjoints if N is dynamic)
+// and must only be combined with plain values.
+template <class T, int N = 1>
+struct ADForward : public core::DualNum<T, N>
 {
-    using data_t = core::DualNum<T>;
+    using data_t = core::DualNum<T, N>;
+    using typename data_t::tangent_type;
 
     ADForward()
-        : data_t(0, 0)
+        : data_t(0, details::tangent<T, N>::zero())
     {}
 
-    ADForward(T w, T df = 0)
+    ADForward(T w, const tangent_type& df = details::tangent<T, N>::zero())
         : data_t(w, df)
     {}
 
+    template <class Derived>
+    ADForward(T w, const Eigen::ArrayBase<Derived>& df)
+        : data_t(w, tangent_type(df))
+    {}
+
     ADForward& operator+=(const ADForward& x);
+    ADForward& operator-=(const ADForward& x);
+    ADForward& operator*=(const ADForward& x);
+    ADForward& operator/=(const ADForward& x);
 };
 
 } // namespace core
 
 // user-exposed forward variable alias 
-template <class T>
-using ForwardVar = core::ADForward<T>;
+template <class T, int N = 1>
+using ForwardVar = core::ADForward<T, N>;
 
 //================================================================================
 
 // Unary functions 
+// These are defined in ad::core so that they are found by argument-dependent lookup,
+// e.g. by Eigen when ADForward is the scalar type of an Eigen container,
+// and exposed in ad below.
+
+namespace core {
 
 // Negate forward variable
 FORWARD_UNARY_FUNC(operator-, -x.get_value(), -x.get_adjoint())
@@ -134,11 +176,24 @@ FORWARD_UNARY_FUNC(sqrt, tmp, x.get_adjoint() / (2 * tmp),
         auto tmp = std::sqrt(x.get_value());)
 // ad::erf(core::ADForward)
 FORWARD_UNARY_FUNC(erf, std::erf(x.get_value()), 
-        two_over_sqrt_pi * std::exp(-t_sq), 
+        two_over_sqrt_pi * std::exp(-t_sq) * x.get_adjoint(), 
         static constexpr double two_over_sqrt_pi =
                 1.1283791670955126;
         auto t_sq = x.get_value() * x.get_value();)
 
+} // namespace core
+
+using core::sin;
+using core::cos;
+using core::tan;
+using core::asin;
+using core::acos;
+using core::atan;
+using core::exp;
+using core::log;
+using core::sqrt;
+using core::erf;
+
 //================================================================================
 
 // Binary operators 
@@ -158,12 +213,104 @@ FORWARD_BINARY_FUNC(operator*, x.get_value() * y.get_value(),
 FORWARD_BINARY_FUNC(operator/, x.get_value() / y.get_value(), 
         (x.get_adjoint() * y.get_value() - x.get_value() * y.get_adjoint()) / (y.get_value() * y.get_value()))
 
+// Mixed operations with plain values
+FORWARD_MIXED_FUNC(operator+, 
+        x.get_value() + c, x.get_adjoint(),
+        c + x.get_value(), x.get_adjoint())
+FORWARD_MIXED_FUNC(operator-, 
+        x.get_value() - c, x.get_adjoint(),
+        c - x.get_value(), -x.get_adjoint())
+FORWARD_MIXED_FUNC(operator*, 
+        x.get_value() * c, x.get_adjoint() * c,
+        c * x.get_value(), c * x.get_adjoint())
+FORWARD_MIXED_FUNC(operator/, 
+        x.get_value() / c, x.get_adjoint() / c,
+        c / x.get_value(), -c * x.get_adjoint() / (x.get_value() * x.get_value()))
+
 // Add current forward variable with x and update current variable with the result.
-template <class T>
-inline ADForward<T>& ADForward<T>::operator+=(const ADForward<T>& x)
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator+=(const ADForward<T, N>& x)
 {
     return *this = *this + x;
 }
 
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator-=(const ADForward<T, N>& x)
+{
+    return *this = *this - x;
+}
+
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator*=(const ADForward<T, N>& x)
+{
+    return *this = *this * x;
+}
+
+template <class T, int N>
+inline ADForward<T, N>& ADForward<T, N>::operator/=(const ADForward<T, N>& x)
+{
+    return *this = *this / x;
+}
+
+// Comparisons only compare values.
+#define FORWARD_COMPARISON_FUNC(op) \
+template <class T, int N> \
+inline bool operator op(const ADForward<T, N>& x, const ADForward<T, N>& y) \
+{ return x.get_value() op y.get_value(); } \
+template <class T, int N> \
+inline bool operator op(const ADForward<T, N>& x, \
+                        const typename ADForward<T, N>::value_type& y) \
+{ return x.get_value() op y; } \
+template <class T, int N> \
+inline bool operator op(const typename ADForward<T, N>::value_type& x, \
+                        const ADForward<T, N>& y) \
+{ return x op y.get_value(); }
+
+FORWARD_COMPARISON_FUNC(<)
+FORWARD_COMPARISON_FUNC(<=)
+FORWARD_COMPARISON_FUNC(>)
+FORWARD_COMPARISON_FUNC(>=)
+FORWARD_COMPARISON_FUNC(==)
+FORWARD_COMPARISON_FUNC(!=)
+
+#undef FORWARD_COMPARISON_FUNC
+
 } // namespace core
 } // namespace ad
+
+namespace Eigen {
+
+// Allows ADForward as the scalar type of Eigen containers,
+// e.g. for reverse-mode expressions with ADForward values (see ad::hessian).
+template <class T, int N>
+struct NumTraits<ad::core::ADForward<T, N>> : GenericNumTraits<ad::core::ADForward<T, N>>
+{
+    using Real = ad::core::ADForward<T, N>;
+    using NonInteger = ad::core::ADForward<T, N>;
+    using Nested = ad::core::ADForward<T, N>;
+    using Literal = T;
+
+    // costs of the value and of the tangents (a guess if N is dynamic)
+    static constexpr int n_parts = 1 + ((N == Dynamic) ? 8 : N);
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = n_parts * NumTraits<T>::ReadCost,
+        AddCost = n_parts * NumTraits<T>::AddCost,
+        MulCost = (2 * n_parts - 1) * NumTraits<T>::MulCost
+    };
+};
+
+// Allows mixing ADForward<T, N> and T in Eigen expressions.
+template <class T, int N, class BinaryOp>
+struct ScalarBinaryOpTraits<ad::core::ADForward<T, N>, T, BinaryOp>
+{ using ReturnType = ad::core::ADForward<T, N>; };
+
+template <class T, int N, class BinaryOp>
+struct ScalarBinaryOpTraits<T, ad::core::ADForward<T, N>, BinaryOp>
+{ using ReturnType = ad::core::ADForward<T, N>; };
+
+} // namespace Eigen
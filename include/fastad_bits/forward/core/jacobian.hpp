@@ -0,0 +1,103 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <Eigen/Core>
+#include <fastad_bits/forward/core/forward.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+// Sets the tangents of x to the jth unit vector (0 if j is out of range).
+template <class T, int N>
+inline void set_unit_tangent(ADForward<T, N>& x, int j, int n_tangents)
+{
+    if constexpr (N == 1) {
+        (void)n_tangents;
+        x.set_adjoint((j == 0) ? 1 : 0);
+    } else {
+        auto& df = x.get_adjoint();
+        if constexpr (N == Eigen::Dynamic) {
+            df.resize(n_tangents);
+        }
+        df.setZero();
+        if (0 <= j && j < df.size()) df(j) = 1;
+    }
+}
+
+// Returns the jth tangent of x.
+template <class T, int N>
+inline T get_tangent(const ADForward<T, N>& x, int j)
+{
+    if constexpr (N == 1) {
+        (void)j;
+        return x.get_adjoint();
+    } else {
+        return x.get_adjoint()(j);
+    }
+}
+
+} // namespace details
+} // namespace core
+
+/**
+ * Computes the Jacobian of f at x with forward-mode in chunks of N directions.
+ * Every evaluation of f propagates N unit directions at once,
+ * so that the n columns of the Jacobian take ceil(n / N) evaluations instead of n.
+ * The tangents of every variable are stored contiguously and updated with SIMD instructions.
+ *
+ * f is called with an Eigen column vector of ForwardVar<T, N> and must return
+ * an Eigen column vector of ForwardVar<T, N>, e.g.
+ *
+ *      auto J = ad::forward_jacobian<4>([](const auto& x) {
+ *          Eigen::Matrix<std::decay_t<decltype(x(0))>, 2, 1> y;
+ *          y << x(0) * x(1), ad::sin(x(2));
+ *          return y;
+ *      }, x0);
+ *
+ * With N = Eigen::Dynamic, the chunk size is given at run-time
+ * and defaults to n (the whole Jacobian in one evaluation).
+ *
+ * @tparam  N           number of directions per evaluation
+ * @param   f           functor computing the outputs
+ * @param   x           point at which the Jacobian is computed
+ * @param   chunk_size  number of directions per evaluation if N is dynamic (ignored otherwise)
+ * @return  Jacobian as a dense matrix (outputs x inputs)
+ */
+template <int N = 1, class F, class Derived>
+inline auto forward_jacobian(F&& f,
+                             const Eigen::MatrixBase<Derived>& x,
+                             size_t chunk_size = 0)
+{
+    using value_t = typename Derived::Scalar;
+    using fvalue_t = ForwardVar<value_t, N>;
+    using fvector_t = Eigen::Matrix<fvalue_t, Eigen::Dynamic, 1>;
+
+    const int n = x.size();
+    const int k = (N != Eigen::Dynamic) ? N :
+                  (chunk_size == 0) ? std::max(n, 1) :
+                  static_cast<int>(chunk_size);
+    assert(k > 0);
+
+    Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic> J;
+    fvector_t xs(n);
+    for (int i = 0; i < n; ++i) xs(i).set_value(x(i));
+
+    for (int begin = 0; begin < n; begin += k) {
+        const int end = std::min(begin + k, n);
+        for (int i = 0; i < n; ++i) {
+            core::details::set_unit_tangent(xs(i), i - begin, k);
+        }
+        const auto& y = f(std::as_const(xs));
+        if (begin == 0) J.resize(y.size(), n);
+        for (int j = begin; j < end; ++j) {
+            for (int i = 0; i < y.size(); ++i) {
+                J(i, j) = core::details::get_tangent(y(i), j - begin);
+            }
+        }
+    }
+    return J;
+}
+
+} // namespace ad
@@ -2,3 +2,4 @@
 
 #include "reverse/core.hpp"
 #include "reverse/stat.hpp"
+#include "reverse/tape.hpp"
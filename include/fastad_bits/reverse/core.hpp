@@ -1,21 +1,35 @@
 #pragma once
+#include "fastad_bits/reverse/core/any_expr.hpp"
 #include "fastad_bits/reverse/core/binary.hpp"
 #include "fastad_bits/reverse/core/bind.hpp"
+#include "fastad_bits/reverse/core/checkpoint.hpp"
 #include "fastad_bits/reverse/core/constant.hpp"
+#include "fastad_bits/reverse/core/data_slot.hpp"
 #include "fastad_bits/reverse/core/dot.hpp"
 #include "fastad_bits/reverse/core/eq.hpp"
 #include "fastad_bits/reverse/core/eval.hpp"
 #include "fastad_bits/reverse/core/expr_base.hpp"
 #include "fastad_bits/reverse/core/for_each.hpp"
+#include "fastad_bits/reverse/core/fuse.hpp"
 #include "fastad_bits/reverse/core/glue.hpp"
+#include "fastad_bits/reverse/core/hessian.hpp"
 #include "fastad_bits/reverse/core/if_else.hpp"
+#include "fastad_bits/reverse/core/jacobian.hpp"
+#include "fastad_bits/reverse/core/lanes.hpp"
+#include "fastad_bits/reverse/core/llt.hpp"
+#include "fastad_bits/reverse/core/map_reduce.hpp"
+#include "fastad_bits/reverse/core/memo.hpp"
 #include "fastad_bits/reverse/core/norm.hpp"
+#include "fastad_bits/reverse/core/parallel.hpp"
 #include "fastad_bits/reverse/core/pow.hpp"
 #include "fastad_bits/reverse/core/prod.hpp"
+#include "fastad_bits/reverse/core/schedule.hpp"
+#include "fastad_bits/reverse/core/share.hpp"
+#include "fastad_bits/reverse/core/sparsity.hpp"
 #include "fastad_bits/reverse/core/sum.hpp"
 #include "fastad_bits/reverse/core/unary.hpp"
 #include "fastad_bits/reverse/core/value_view.hpp"
 #include "fastad_bits/reverse/core/var.hpp"
 #include "fastad_bits/reverse/core/var_view.hpp"
-//#include "fastad_bits/reverse/core/hessian.hpp"
+#include "fastad_bits/reverse/core/workspace.hpp"
 #include "fastad_bits/reverse/core/transpose.hpp"
\ No newline at end of file
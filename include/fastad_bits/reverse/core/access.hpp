@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/*
+ * Contiguous region [val, val + size) viewed by a leaf or placeholder
+ * and its corresponding adjoint region starting at adj.
+ */
+template <class ValueType>
+struct Access
+{
+    ValueType* val;
+    ValueType* adj;
+    size_t size;
+};
+
+/*
+ * Visitor that records every region read and written by a statement.
+ */
+template <class ValueType>
+struct AccessCollector
+{
+    template <class VarViewType>
+    void read(VarViewType& v)
+    { reads.push_back({v.data(), v.data_adj(), v.size()}); }
+
+    template <class VarViewType>
+    void write(VarViewType& v)
+    { writes.push_back({v.data(), v.data_adj(), v.size()}); }
+
+    std::vector<Access<ValueType>> reads;
+    std::vector<Access<ValueType>> writes;
+};
+
+// Whether the expression being bound reads frozen leaves
+// and whether it reads anything else.
+struct ActivitySummary
+{
+    bool frozen = false;
+    bool active = false;
+};
+
+/*
+ * While an ActivityScope is enabled on the calling thread,
+ * nodes find out at bind time which of their subexpressions are active
+ * (see bind_active) and skip backward evaluating the others.
+ * ExprBind enables it if any leaf of its expression is frozen (see Var::freeze),
+ * so that expressions without frozen leaves are bound as before.
+ *
+ * Activity is computed bottom-up in the same pass as the binding:
+ * leaves report themselves with read() when they are bound,
+ * and the reports are summarized for the subexpression currently being bound.
+ * Placeholders and shared subexpressions count as active,
+ * since their adjoints are propagated to leaves elsewhere.
+ */
+struct ActivityScope
+{
+    ActivityScope(bool enabled)
+        : prev_(enabled_)
+        , prev_summary_(summary_)
+    {
+        enabled_ = enabled;
+        summary_ = ActivitySummary();
+    }
+
+    ~ActivityScope()
+    {
+        enabled_ = prev_;
+        summary_ = prev_summary_;
+    }
+
+    ActivityScope(const ActivityScope&) =delete;
+    ActivityScope& operator=(const ActivityScope&) =delete;
+
+    static bool enabled() { return enabled_; }
+
+    // Reports a leaf read by the expression being bound.
+    static void read(bool frozen)
+    {
+        if (!enabled_) return;
+        if (frozen) summary_.frozen = true;
+        else summary_.active = true;
+    }
+
+    // Starts summarizing a new subexpression and returns the current summary.
+    static ActivitySummary push()
+    {
+        ActivitySummary out = summary_;
+        summary_ = ActivitySummary();
+        return out;
+    }
+
+    // Merges the summary of the subexpression into outer, which becomes current,
+    // and returns whether the subexpression is active.
+    static bool pop(const ActivitySummary& outer)
+    {
+        bool active = summary_.active || !summary_.frozen;
+        summary_.frozen |= outer.frozen;
+        summary_.active |= outer.active;
+        return active;
+    }
+
+private:
+    static inline thread_local bool enabled_ = false;
+    static inline thread_local ActivitySummary summary_;
+    bool prev_;
+    ActivitySummary prev_summary_;
+};
+
+/*
+ * While a ForwardOnlyScope is active on the calling thread,
+ * the subexpressions being bound are forward evaluated
+ * but never backward evaluated by their parent,
+ * e.g. the operands of a comparison or the condition of an if_else.
+ * Nodes that must be backward evaluated to propagate
+ * the seeds of other nodes (see SharedNode) check it at bind time.
+ */
+struct ForwardOnlyScope
+{
+    ForwardOnlyScope() : prev_(active_) { active_ = true; }
+    ~ForwardOnlyScope() { active_ = prev_; }
+    ForwardOnlyScope(const ForwardOnlyScope&) =delete;
+    ForwardOnlyScope& operator=(const ForwardOnlyScope&) =delete;
+
+    static bool active() { return active_; }
+
+private:
+    static inline thread_local bool active_ = false;
+    bool prev_;
+};
+
+/*
+ * Visitor that records whether a statement reads frozen leaves.
+ */
+struct FrozenCollector
+{
+    template <class VarViewType>
+    void read(VarViewType& v)
+    {
+        if constexpr (util::is_var_view_v<VarViewType>) {
+            if (v.is_frozen()) frozen = true;
+        }
+    }
+
+    template <class VarViewType>
+    void write(VarViewType&) {}
+
+    bool frozen = false;
+};
+
+// Whether expr reads any frozen leaf.
+template <class ExprType>
+inline bool has_frozen(ExprType& expr)
+{
+    FrozenCollector collector;
+    expr.visit(collector);
+    return collector.frozen;
+}
+
+// Calls bind(), which binds a subexpression, and returns whether
+// backward evaluating it may update an adjoint that is not frozen,
+// i.e. it reads no frozen leaf or reads something else as well.
+// Outside of an enabled ActivityScope, every expression is active.
+template <class F>
+inline bool bind_active(F&& bind)
+{
+    if (!ActivityScope::enabled()) { bind(); return true; }
+    auto outer = ActivityScope::push();
+    bind();
+    return ActivityScope::pop(outer);
+}
+
+// Calls bind(expr) on every expression of exprs from left to right
+// and returns their activity (see bind_active),
+// or an empty vector if they are all active.
+template <class VecType, class F>
+inline std::vector<bool> bind_activity(VecType& exprs, F&& bind)
+{
+    std::vector<bool> out;
+    if (!ActivityScope::enabled()) {
+        for (auto& expr : exprs) bind(expr);
+        return out;
+    }
+    out.reserve(exprs.size());
+    for (auto& expr : exprs) {
+        out.push_back(bind_active([&]() { bind(expr); }));
+    }
+    if (std::all_of(out.begin(), out.end(), [](bool a) { return a; })) out.clear();
+    return out;
+}
+
+/*
+ * Set of half-open pointer ranges that supports overlap queries.
+ * Ranges are sorted by their begin with a running maximum of their ends
+ * so that a query only scans ranges that can overlap.
+ */
+template <class ValueType>
+struct RangeIndex
+{
+    using value_t = ValueType;
+
+    void add(const value_t* begin, size_t size)
+    { ranges_.push_back({begin, begin + size}); }
+
+    void finalize()
+    {
+        std::sort(ranges_.begin(), ranges_.end(),
+                [](const auto& x, const auto& y) {
+                    return x.begin < y.begin ||
+                        (x.begin == y.begin && x.end < y.end);
+                });
+        ranges_.erase(std::unique(ranges_.begin(), ranges_.end(),
+                [](const auto& x, const auto& y) {
+                    return x.begin == y.begin && x.end == y.end;
+                }), ranges_.end());
+        max_end_.resize(ranges_.size());
+        for (size_t i = 0; i < ranges_.size(); ++i) {
+            max_end_[i] = (i == 0) ? ranges_[i].end :
+                std::max(max_end_[i-1], ranges_[i].end);
+        }
+    }
+
+    size_t size() const { return ranges_.size(); }
+
+    // Calls f(id) for every range that overlaps [begin, begin + size).
+    template <class F>
+    void overlapping(const value_t* begin, size_t size, F&& f) const
+    {
+        const value_t* end = begin + size;
+        auto it = std::lower_bound(ranges_.begin(), ranges_.end(), end,
+                [](const auto& r, const value_t* p) { return r.begin < p; });
+        for (size_t i = std::distance(ranges_.begin(), it); i-- > 0;) {
+            if (max_end_[i] <= begin) break;
+            if (ranges_[i].end > begin) f(i);
+        }
+    }
+
+    bool overlaps(const value_t* begin, size_t size) const
+    {
+        bool found = false;
+        overlapping(begin, size, [&](size_t) { found = true; });
+        return found;
+    }
+
+private:
+    struct Range
+    {
+        const value_t* begin;
+        const value_t* end;
+    };
+
+    std::vector<Range> ranges_;
+    std::vector<const value_t*> max_end_;
+};
+
+} // namespace details
+} // namespace core
+} // namespace ad
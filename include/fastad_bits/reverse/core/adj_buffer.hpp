@@ -0,0 +1,294 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ad {
+namespace core {
+
+/**
+ * AdjBuffer is a private accumulator for leaf adjoints.
+ * While a buffer is installed on the current thread (see AdjBufferGuard),
+ * every VarView bound on that thread views its adjoint in the buffer
+ * instead of the adjoint storage of its variable (see VarViewBase::bind_cache).
+ * Parallel nodes (see ParSumIterNode, ScheduleNode) bind every chunk of work
+ * with its own buffer, so that threads backward-evaluating expressions
+ * that share leaves never race on the shared adjoints,
+ * and backward evaluation itself does not look anything up.
+ * The buffered contributions are added with flush() to the adjoints
+ * the leaves would have viewed otherwise:
+ * the real adjoints or the buffer that was installed when this one was filled.
+ *
+ * Every distinct (adjoint pointer, size) pair gets its own slot,
+ * whose address is stable until the buffer is cleared.
+ * Adjoint ranges for which the optional bypass predicate returns true
+ * are not buffered; get() returns the original pointer for them.
+ *
+ * Copies are empty, since they are filled when their leaves are bound again.
+ *
+ * @tparam  ValueType   underlying value type of the adjoints
+ */
+
+template <class ValueType>
+struct AdjBuffer
+{
+    using value_t = ValueType;
+    using bypass_t = std::function<bool(const value_t*, size_t)>;
+
+    AdjBuffer(const bypass_t& bypass = bypass_t())
+        : bypass_(bypass)
+    {}
+
+    AdjBuffer(const AdjBuffer& other)
+        : bypass_(other.bypass_)
+    {}
+
+    AdjBuffer(AdjBuffer&&) =default;
+
+    AdjBuffer& operator=(const AdjBuffer& other)
+    {
+        clear();
+        bypass_ = other.bypass_;
+        return *this;
+    }
+
+    AdjBuffer& operator=(AdjBuffer&&) =default;
+
+    /**
+     * Returns the buffered storage for the adjoint range [adj, adj + size).
+     * Only called at bind time, while the buffer is installed.
+     */
+    value_t* get(value_t* adj, size_t size)
+    {
+        // few distinct leaves (the common case of shared parameters):
+        // a linear scan beats hashing.
+        if (entries_.size() <= linear_search_max_) {
+            for (const auto& entry : entries_) {
+                if (entry.adj == adj && entry.size == size) {
+                    return entry.buf.get();
+                }
+            }
+        } else {
+            auto range = index_.equal_range(adj);
+            for (auto it = range.first; it != range.second; ++it) {
+                const auto& entry = entries_[it->second];
+                if (entry.size == size) {
+                    return entry.buf.get();
+                }
+            }
+        }
+        // a range not buffered here is viewed as it would be without this buffer.
+        // Bypassed ranges are not recorded so that they never slow down the search
+        value_t* target = outer_ ? outer_->get(adj, size) : adj;
+        if (!adj || bypasses(adj, size)) return target;
+        index_.emplace(adj, entries_.size());
+        entries_.push_back({adj, size, target, std::make_unique<value_t[]>(size)});
+        return entries_.back().buf.get();
+    }
+
+    /**
+     * Returns true if the adjoint range [adj, adj + size) is never buffered.
+     */
+    bool bypasses(const value_t* adj, size_t size) const
+    {
+        return bypass_ && bypass_(adj, size);
+    }
+
+    /**
+     * Adds every buffered contribution to the adjoint it was redirected from
+     * and zeros the buffer.
+     * Entries are flushed in the order they were first seen,
+     * so the result is reproducible for a fixed sequence of beval calls.
+     */
+    void flush()
+    {
+        for (const auto& entry : entries_) {
+            value_t* buf = entry.buf.get();
+            for (size_t i = 0; i < entry.size; ++i) {
+                entry.target[i] += buf[i];
+                buf[i] = 0;
+            }
+        }
+    }
+
+    /**
+     * Removes every slot, e.g. before the leaves are bound again.
+     */
+    void clear()
+    {
+        entries_.clear();
+        index_.clear();
+    }
+
+    /**
+     * Returns the buffer installed on the current thread or nullptr if none.
+     */
+    static AdjBuffer*& current()
+    {
+        static thread_local AdjBuffer* buf = nullptr;
+        return buf;
+    }
+
+private:
+    template <class>
+    friend struct AdjBufferGuard;
+
+    struct Entry
+    {
+        value_t* adj;
+        size_t size;
+        value_t* target;                // adjoint the slot is flushed to
+        std::unique_ptr<value_t[]> buf; // slot, zero-initialized
+    };
+
+    std::vector<Entry> entries_;
+    std::unordered_multimap<value_t*, size_t> index_;
+    bypass_t bypass_;
+    AdjBuffer* outer_ = nullptr;    // buffer installed when this one is filled
+
+    static constexpr size_t linear_search_max_ = 16;
+};
+
+/**
+ * AdjBufferGuard installs an AdjBuffer on the current thread
+ * for the lifetime of the guard and restores the previous one on destruction.
+ * Parallel nodes install their buffers while binding their subexpressions.
+ */
+
+template <class ValueType>
+struct AdjBufferGuard
+{
+    using buffer_t = AdjBuffer<ValueType>;
+
+    AdjBufferGuard(buffer_t& buf)
+        : prev_(buffer_t::current())
+    {
+        buf.outer_ = prev_;
+        buffer_t::current() = &buf;
+    }
+
+    AdjBufferGuard(const AdjBufferGuard&) =delete;
+    AdjBufferGuard& operator=(const AdjBufferGuard&) =delete;
+
+    ~AdjBufferGuard() { buffer_t::current() = prev_; }
+
+private:
+    buffer_t* prev_;
+};
+
+/**
+ * AdjAccumulator accumulates the adjoints of the given leaves
+ * in a wider type than their values (mixed precision),
+ * e.g. float leaves whose gradient is summed over many evaluations in double.
+ * While an accumulator is alive, every backward pass run with ad::evaluate_adj
+ * or ad::autodiff on the constructing thread ends with collect(),
+ * which moves the adjoints of the leaves into the accumulator and zeros them.
+ * Backward evaluation itself is untouched, so a single pass accumulates in float
+ * and only the sum over passes is carried in the wider type.
+ * The accumulated adjoints are added (rounded to ValueType) to the leaves with flush()
+ * and on destruction.
+ *
+ * Subviews of a leaf (e.g. v[i]) write into the adjoints of the leaf
+ * and are accumulated with it.
+ * Adjoints of other views, in particular placeholders, are not collected.
+ *
+ * Only passes over expressions with float values consult an accumulator.
+ *
+ * @tparam  ValueType   underlying value type of the leaves
+ * @tparam  AccumType   type in which adjoints are accumulated
+ */
+
+template <class ValueType, class AccumType = double>
+struct AdjAccumulator
+{
+    using value_t = ValueType;
+    using accum_t = AccumType;
+
+    /**
+     * Takes over the current adjoints of the leaves.
+     */
+    template <class... Leaves>
+    explicit AdjAccumulator(Leaves&... leaves)
+        : prev_(current())
+    {
+        (add(leaves.data_adj(), leaves.size()), ...);
+        collect();
+        current() = this;
+    }
+
+    AdjAccumulator(const AdjAccumulator&) =delete;
+    AdjAccumulator& operator=(const AdjAccumulator&) =delete;
+
+    ~AdjAccumulator()
+    {
+        flush();
+        current() = prev_;
+    }
+
+    /**
+     * Adds the adjoints of the leaves to the accumulator
+     * and zeros them.
+     */
+    void collect()
+    {
+        for (const auto& entry : entries_) {
+            accum_t* buf = buf_.data() + entry.offset;
+            for (size_t i = 0; i < entry.size; ++i) {
+                buf[i] += static_cast<accum_t>(entry.adj[i]);
+                entry.adj[i] = 0;
+            }
+        }
+    }
+
+    /**
+     * Adds the accumulated adjoints to the adjoints of the leaves
+     * and zeros the accumulator.
+     */
+    void flush()
+    {
+        for (const auto& entry : entries_) {
+            accum_t* buf = buf_.data() + entry.offset;
+            for (size_t i = 0; i < entry.size; ++i) {
+                entry.adj[i] += static_cast<value_t>(buf[i]);
+                buf[i] = 0;
+            }
+        }
+    }
+
+    /**
+     * Returns the accumulator alive on the current thread or nullptr if none.
+     */
+    static AdjAccumulator*& current()
+    {
+        static thread_local AdjAccumulator* acc = nullptr;
+        return acc;
+    }
+
+private:
+    struct Entry
+    {
+        value_t* adj;
+        size_t size;
+        size_t offset;
+    };
+
+    void add(value_t* adj, size_t size)
+    {
+        entries_.push_back({adj, size, buf_.size()});
+        buf_.resize(buf_.size() + size, 0);
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<accum_t> buf_;
+    AdjAccumulator* prev_;
+};
+
+} // namespace core
+
+template <class ValueType, class AccumType = double>
+using AdjAccumulator = core::AdjAccumulator<ValueType, AccumType>;
+
+} // namespace ad
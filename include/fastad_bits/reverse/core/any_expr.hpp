@@ -0,0 +1,272 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <Eigen/Core>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/value_view.hpp>
+#include <fastad_bits/reverse/core/var_view.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/*
+ * Visitor interface seen by an erased expression.
+ * Every leaf and placeholder is passed as a flat vector view
+ * of its values and adjoints.
+ */
+template <class ValueType>
+struct AnyVisitor
+{
+    using flat_t = VarView<ValueType, ad::vec>;
+
+    virtual ~AnyVisitor() =default;
+    virtual void read(flat_t& v) =0;
+    virtual void write(flat_t& v) =0;
+};
+
+// AnyVisitor forwarding to a visitor of any type.
+template <class ValueType, class Visitor>
+struct AnyVisitorRef : AnyVisitor<ValueType>
+{
+    using typename AnyVisitor<ValueType>::flat_t;
+
+    AnyVisitorRef(Visitor& v) : v_(v) {}
+    void read(flat_t& v) override { v_.read(v); }
+    void write(flat_t& v) override { v_.write(v); }
+
+private:
+    Visitor& v_;
+};
+
+// Visitor passing every leaf of an erased expression to an AnyVisitor.
+template <class ValueType>
+struct AnyVisitorFlattener
+{
+    using flat_t = typename AnyVisitor<ValueType>::flat_t;
+
+    template <class VarViewType>
+    void read(VarViewType& v)
+    {
+        flat_t flat = flatten(v);
+        visitor.read(flat);
+    }
+
+    template <class VarViewType>
+    void write(VarViewType& v)
+    {
+        flat_t flat = flatten(v);
+        visitor.write(flat);
+    }
+
+    template <class VarViewType>
+    static flat_t flatten(VarViewType& v)
+    {
+        flat_t flat(v.data(), v.data_adj(), v.size());
+        if constexpr (util::is_var_view_v<VarViewType>) {
+            flat.bind_frozen(v.frozen_flag());
+        }
+        return flat;
+    }
+
+    AnyVisitor<ValueType>& visitor;
+};
+
+} // namespace details
+
+/**
+ * AnyExpr is a type-erased expression of a given value type and shape.
+ * Ex.
+ * AnyExpr<double, vec> layer = ad::tanh(ad::dot(W, x) + b);
+ * Any expression with the same value type and shape can be assigned to it,
+ * so that a model can be built from pieces chosen at runtime
+ * (e.g. a std::vector<AnyExpr<double>> summed with ad::sum)
+ * or defined in another translation unit behind a plain function signature.
+ * The type of an expression containing an AnyExpr no longer depends
+ * on the erased subtree, which bounds compile time and binary size.
+ *
+ * The erased expression is evaluated through one virtual call per
+ * forward and backward evaluation.
+ * AnyExpr caches the value and adjoint of the erased expression in its own cache,
+ * so it can be the root of a placeholder definition like any other node.
+ * The cost is one copy of the value and of the seed per evaluation.
+ *
+ * Copies of an AnyExpr deep copy the erased expression and moves transfer it.
+ * Visitors (see ScheduleNode, CheckpointNode and ad::jacobian)
+ * see the leaves of the erased expression as vector views
+ * of the same values and adjoints.
+ *
+ * @tparam  ValueType   type of values
+ * @tparam  ShapeType   shape of expression
+ */
+
+template <class ValueType, class ShapeType = ad::scl>
+struct AnyExpr:
+    ValueAdjView<ValueType, ShapeType>,
+    ExprBase<AnyExpr<ValueType, ShapeType>>
+{
+    using value_adj_view_t = ValueAdjView<ValueType, ShapeType>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+private:
+    using visitor_t = details::AnyVisitor<value_t>;
+
+    struct Concept
+    {
+        virtual ~Concept() =default;
+        virtual std::unique_ptr<Concept> clone() const =0;
+        virtual void feval(value_t* val) =0;
+        virtual void beval(const value_t* seed) =0;
+        virtual ptr_pack_t bind_cache(ptr_pack_t begin) =0;
+        virtual util::SizePack bind_cache_size() const =0;
+        virtual void visit(visitor_t& v) =0;
+    };
+
+    template <class ExprType>
+    struct Model : Concept
+    {
+        Model(const ExprType& expr) : expr(expr) {}
+
+        std::unique_ptr<Concept> clone() const override
+        { return std::make_unique<Model>(expr); }
+
+        // Forward evaluates and writes the value into val.
+        void feval(value_t* val) override
+        {
+            ValueView<value_t, shape_t> out(val, expr.rows(), expr.cols());
+            out.get() = expr.feval();
+        }
+
+        // Backward evaluates with the seed viewed by seed.
+        void beval(const value_t* seed) override
+        {
+            if constexpr (util::is_scl_v<ExprType>) {
+                expr.beval(*seed);
+            } else {
+                constexpr int cols = util::is_vec_v<ExprType> ? 1 : Eigen::Dynamic;
+                Eigen::Map<const Eigen::Array<value_t, Eigen::Dynamic, cols>>
+                    a_seed(seed, expr.rows(), expr.cols());
+                expr.beval(a_seed);
+            }
+        }
+
+        ptr_pack_t bind_cache(ptr_pack_t begin) override
+        { return expr.bind_cache(begin); }
+
+        util::SizePack bind_cache_size() const override
+        { return expr.bind_cache_size(); }
+
+        void visit(visitor_t& v) override
+        {
+            details::AnyVisitorFlattener<value_t> flattener{v};
+            expr.visit(flattener);
+        }
+
+        ExprType expr;
+    };
+
+public:
+    template <class Derived
+            , class = std::enable_if_t<
+                !std::is_same_v<Derived, AnyExpr> &&
+                std::is_same_v<typename util::expr_traits<Derived>::value_t, value_t> &&
+                std::is_same_v<typename util::shape_traits<Derived>::shape_t, shape_t> > >
+    AnyExpr(const ExprBase<Derived>& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.self().rows(), expr.self().cols())
+        , impl_(std::make_unique<Model<Derived>>(expr.self()))
+    {}
+
+    AnyExpr(const AnyExpr& other)
+        : value_adj_view_t(other)
+        , impl_(other.impl_->clone())
+    {}
+
+    // Moves made by ExprBind (in a details::CloneScope) still clone,
+    // so that the erased expression shares no state with other copies.
+    AnyExpr(AnyExpr&& other)
+        : value_adj_view_t(other)
+        , impl_(details::CloneScope::active() ?
+                other.impl_->clone() : std::move(other.impl_))
+    {}
+
+    AnyExpr& operator=(const AnyExpr& other)
+    {
+        value_adj_view_t::operator=(other);
+        impl_ = other.impl_->clone();
+        return *this;
+    }
+
+    AnyExpr& operator=(AnyExpr&&) =default;
+
+    /**
+     * Forward evaluates the erased expression and caches its value.
+     * @return  const reference of the cached value
+     */
+    const var_t& feval()
+    {
+        impl_->feval(this->data());
+        return this->get();
+    }
+
+    /**
+     * Sets current adjoint to seed and backward evaluates
+     * the erased expression with it.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        auto&& a_adj = util::to_array(this->get_adj());
+        a_adj = seed;
+        impl_->beval(this->data_adj());
+    }
+
+    /**
+     * Binds the erased expression then itself.
+     * @return  next pointer pack not bound by the expression and itself
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = impl_->bind_cache(begin);
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return impl_->bind_cache_size() + single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        if constexpr (std::is_base_of_v<visitor_t, Visitor>) {
+            impl_->visit(v);
+        } else {
+            details::AnyVisitorRef<value_t, Visitor> ref(v);
+            impl_->visit(ref);
+        }
+    }
+
+private:
+    std::unique_ptr<Concept> impl_;
+};
+
+} // namespace core
+
+template <class ValueType, class ShapeType = ad::scl>
+using AnyExpr = core::AnyExpr<ValueType, ShapeType>;
+
+} // namespace ad
@@ -1,4 +1,5 @@
 #pragma once
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
@@ -37,7 +38,7 @@ template <class Binary
         , class LeftExprType
         , class RightExprType>
 struct BinaryNode:
-    ValueAdjView<typename util::expr_traits<LeftExprType>::value_t,
+    ValueAdjView<util::common_value_t<LeftExprType, RightExprType>,
                  util::max_shape_t<typename util::shape_traits<LeftExprType>::shape_t,
                                    typename util::shape_traits<RightExprType>::shape_t>
                 >,
@@ -130,28 +131,39 @@ public:
             a_adj = seed;
             auto&& rhs_seed = Binary::brmap(a_adj, a_l, a_r, a_val);
             auto&& lhs_seed = Binary::blmap(a_adj, a_l, a_r, a_val);
-            expr_rhs_.beval(rhs_seed);
-            expr_lhs_.beval(lhs_seed);
+            if (lhs_active_ && rhs_active_) {
+                expr_rhs_.beval(rhs_seed);
+                expr_lhs_.beval(lhs_seed);
+                return;
+            }
+            if (rhs_active_) expr_rhs_.beval(rhs_seed);
+            if (lhs_active_) expr_lhs_.beval(lhs_seed);
         }
     }
 
     /**
      * Binds left expression, then right expression, then itself.
-     * If Binary operation is only comparison, bind value only.
+     * If Binary operation is only comparison, bind value only,
+     * and bind the expressions as forward evaluated only (see details::ForwardOnlyScope).
+     * An expression that only reads frozen leaves is not backward evaluated
+     * (see details::bind_active).
      *
      * @return  next pointer pack not bound by left, right, or itself.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        begin = expr_lhs_.bind_cache(begin);
-        begin = expr_rhs_.bind_cache(begin);
         if constexpr (Binary::is_comparison) {
+            details::ForwardOnlyScope scope;
+            begin = expr_lhs_.bind_cache(begin);
+            begin = expr_rhs_.bind_cache(begin);
             auto adj = begin.adj;
             begin.adj = nullptr;
             begin = value_adj_view_t::bind(begin);
             begin.adj = adj;
             return begin;
         } else {
+            lhs_active_ = details::bind_active([&]() { begin = expr_lhs_.bind_cache(begin); });
+            rhs_active_ = details::bind_active([&]() { begin = expr_rhs_.bind_cache(begin); });
             return value_adj_view_t::bind(begin);
         }
     }
@@ -179,9 +191,24 @@ public:
         }
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_lhs_.visit(v);
+        expr_rhs_.visit(v);
+    }
+
+    // Left and right expressions (see FusedNode).
+    left_t& lhs() { return expr_lhs_; }
+    const left_t& lhs() const { return expr_lhs_; }
+    right_t& rhs() { return expr_rhs_; }
+    const right_t& rhs() const { return expr_rhs_; }
+
 private:
     left_t expr_lhs_;
     right_t expr_rhs_;
+    bool lhs_active_ = true;
+    bool rhs_active_ = true;
 };
 
 /* 
@@ -244,8 +271,8 @@ template <class Derived1 \
 inline auto name(const Derived1& node1, \
                  const Derived2& node2) \
 { \
-    using expr1_t = util::convert_to_ad_t<Derived1>; \
-    using expr2_t = util::convert_to_ad_t<Derived2>; \
+    using expr1_t = util::convert_to_ad_like_t<Derived1, Derived2>; \
+    using expr2_t = util::convert_to_ad_like_t<Derived2, Derived1>; \
     expr1_t expr1 = node1; \
     expr2_t expr2 = node2; \
     if constexpr (util::is_constant_v<expr1_t> && \
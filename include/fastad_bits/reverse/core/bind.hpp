@@ -1,10 +1,158 @@
 #pragma once
-#include <vector>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/util/cache_pool.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 
 namespace ad {
 namespace core {
+namespace details {
+
+/*
+ * While a CloneScope is active on the calling thread,
+ * nodes with state shared between their copies (see SharedNode)
+ * give the copies a new state, cloned once per original state.
+ * ExprBind copies its expression in a CloneScope so that
+ * two bound expressions never share a state.
+ */
+struct CloneScope
+{
+    CloneScope() : prev_(active_) { active_ = this; }
+    ~CloneScope() { active_ = prev_; }
+    CloneScope(const CloneScope&) =delete;
+    CloneScope& operator=(const CloneScope&) =delete;
+
+    static CloneScope* active() { return active_; }
+
+    template <class StateType>
+    std::shared_ptr<StateType> clone(const std::shared_ptr<StateType>& state)
+    {
+        auto it = clones_.find(state.get());
+        if (it != clones_.end()) {
+            return std::static_pointer_cast<StateType>(it->second);
+        }
+        // copying the state may clone nested states, so insert afterwards
+        auto out = std::make_shared<StateType>(*state);
+        clones_.emplace(state.get(), out);
+        return out;
+    }
+
+private:
+    static inline thread_local CloneScope* active_ = nullptr;
+    CloneScope* prev_;
+    std::unordered_map<const void*, std::shared_ptr<void>> clones_;
+};
+
+/*
+ * While a ValueOnlyScope is active on the calling thread,
+ * expressions are bound for forward evaluation only (see ValueBind):
+ * there is no adjoint cache, so nodes are bound to null adjoints,
+ * and nodes may skip whatever they only keep for backward evaluation
+ * (see CheckpointNode).
+ */
+struct ValueOnlyScope
+{
+    ValueOnlyScope() : prev_(active_) { active_ = true; }
+    ~ValueOnlyScope() { active_ = prev_; }
+    ValueOnlyScope(const ValueOnlyScope&) =delete;
+    ValueOnlyScope& operator=(const ValueOnlyScope&) =delete;
+
+    static bool active() { return active_; }
+
+private:
+    static inline thread_local bool active_ = false;
+    bool prev_;
+};
+
+// Returns a copy of expr made in a CloneScope.
+// If expr is an rvalue, the copy is move-constructed from it.
+template <class ExprType>
+inline std::decay_t<ExprType> clone(ExprType&& expr)
+{
+    CloneScope scope;
+    return std::decay_t<ExprType>(std::forward<ExprType>(expr));
+}
+
+} // namespace details
+
+/**
+ * CacheBuffer owns a contiguous array of values used as an expression cache.
+ * The memory is drawn from a CachePool if one is given,
+ * and from the heap otherwise.
+ * Like Eigen vectors, trivially constructible values are left uninitialized.
+ *
+ * @tparam  ValueType   type of values
+ */
+
+template <class ValueType>
+struct CacheBuffer
+{
+    using value_t = ValueType;
+
+    CacheBuffer(size_t size = 0,
+                util::CachePool* pool = nullptr)
+        : data_(nullptr)
+        , size_(size)
+        , pool_(pool)
+    {
+        if (size_ == 0) return;
+        data_ = static_cast<value_t*>(pool_ ?
+                pool_->allocate(n_bytes()) :
+                ::operator new(n_bytes(), std::align_val_t(alignment)));
+        std::uninitialized_default_construct_n(data_, size_);
+    }
+
+    CacheBuffer(const CacheBuffer& other)
+        : CacheBuffer(other.size_, other.pool_)
+    {
+        std::copy_n(other.data_, size_, data_);
+    }
+
+    CacheBuffer(CacheBuffer&& other) noexcept
+        : data_(other.data_)
+        , size_(other.size_)
+        , pool_(other.pool_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    CacheBuffer& operator=(CacheBuffer other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(pool_, other.pool_);
+        return *this;
+    }
+
+    ~CacheBuffer()
+    {
+        if (!data_) return;
+        std::destroy_n(data_, size_);
+        if (pool_) {
+            pool_->deallocate(data_, n_bytes());
+        } else {
+            ::operator delete(data_, std::align_val_t(alignment));
+        }
+    }
+
+    value_t* data() { return data_; }
+    const value_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    static constexpr size_t alignment = util::CachePool::alignment;
+
+    size_t n_bytes() const { return size_ * sizeof(value_t); }
+
+    value_t* data_;
+    size_t size_;
+    util::CachePool* pool_;
+};
 
 /**
  * ExprBind is a helper class that wraps an AD expression
@@ -12,6 +160,21 @@ namespace core {
  * This is for convenience purposes so that users do not have
  * to worry about creating the cache line themselves.
  *
+ * If a CachePool is given, the cache is drawn from and given back to the pool.
+ * This avoids the system allocator when expressions are rebuilt often.
+ * The pool must outlive the ExprBind.
+ *
+ * Copies own a copy of the cache and are bound to it.
+ * Moves take over the cache and bind the expression to it again.
+ * An expression given as an rvalue is moved rather than copied.
+ * The expression is copied or moved in a details::CloneScope,
+ * so shared subexpressions (see ad::share) are not shared with other ExprBinds.
+ *
+ * If any leaf is frozen (see Var::freeze), the expression is bound
+ * in a details::ActivityScope so that nodes skip backward evaluating
+ * subexpressions that only read frozen leaves.
+ * After freezing or unfreezing leaves, call rebind().
+ *
  * @tparam  ExprType    expression type
  */
 
@@ -21,23 +184,154 @@ struct ExprBind
     using expr_t = ExprType;
     using value_t = typename util::expr_traits<expr_t>::value_t;
 
-    ExprBind(const expr_t& expr)
-        : expr_{expr}
-        , val_cache_()
-        , adj_cache_()
+    ExprBind(const expr_t& expr,
+             util::CachePool* pool = nullptr)
+        : expr_{details::clone(expr)}
+    {
+        bind_cache(pool);
+    }
+
+    ExprBind(expr_t&& expr,
+             util::CachePool* pool = nullptr)
+        : expr_{details::clone(std::move(expr))}
+    {
+        bind_cache(pool);
+    }
+
+    ExprBind(const ExprBind& other)
+        : expr_{details::clone(other.expr_)}
+        , val_cache_(other.val_cache_)
+        , adj_cache_(other.adj_cache_)
+    {
+        bind_expr();
+    }
+
+    // Nodes may point into themselves (e.g. ScheduleNode), so moves bind again.
+    ExprBind(ExprBind&& other)
+        : expr_{std::move(other.expr_)}
+        , val_cache_(std::move(other.val_cache_))
+        , adj_cache_(std::move(other.adj_cache_))
+    {
+        bind_expr();
+    }
+
+    ExprBind& operator=(const ExprBind& other)
+    {
+        return *this = ExprBind(other);
+    }
+
+    ExprBind& operator=(ExprBind&& other)
+    {
+        expr_ = std::move(other.expr_);
+        val_cache_ = std::move(other.val_cache_);
+        adj_cache_ = std::move(other.adj_cache_);
+        bind_expr();
+        return *this;
+    }
+
+    expr_t& get() { return expr_; }
+    const expr_t& get() const { return expr_; }
+
+    /**
+     * Binds the expression again to the same cache.
+     * Call it after freezing or unfreezing leaves (see Var::freeze)
+     * so that nodes find out which subexpressions are active.
+     */
+    void rebind() { bind_expr(); }
+
+private:
+    void bind_cache(util::CachePool* pool)
     {
         auto size_pack = expr_.bind_cache_size();
-        val_cache_.resize(size_pack(0));
-        adj_cache_.resize(size_pack(1));
+        val_cache_ = CacheBuffer<value_t>(size_pack(0), pool);
+        adj_cache_ = CacheBuffer<value_t>(size_pack(1), pool);
+        bind_expr();
+    }
+
+    void bind_expr()
+    {
+        details::ActivityScope scope(details::has_frozen(expr_));
         expr_.bind_cache({val_cache_.data(), adj_cache_.data()});
     }
-    
+
+    expr_t expr_;
+    CacheBuffer<value_t> val_cache_;
+    CacheBuffer<value_t> adj_cache_;
+};
+
+/**
+ * ValueBind is the forward-only counterpart of ExprBind.
+ * It binds the expression with a value cache only:
+ * no adjoint cache is allocated and nodes are bound to null adjoints,
+ * so the expression can only be forward evaluated (see ad::evaluate).
+ * Use it when only values are needed, e.g. to score a trained model.
+ *
+ * Copies, moves and cache pools behave as in ExprBind.
+ *
+ * @tparam  ExprType    expression type
+ */
+
+template <class ExprType>
+struct ValueBind
+{
+    using expr_t = ExprType;
+    using value_t = typename util::expr_traits<expr_t>::value_t;
+
+    ValueBind(const expr_t& expr,
+              util::CachePool* pool = nullptr)
+        : expr_{details::clone(expr)}
+    {
+        val_cache_ = CacheBuffer<value_t>(expr_.bind_cache_size()(0), pool);
+        bind_cache();
+    }
+
+    ValueBind(expr_t&& expr,
+              util::CachePool* pool = nullptr)
+        : expr_{details::clone(std::move(expr))}
+    {
+        val_cache_ = CacheBuffer<value_t>(expr_.bind_cache_size()(0), pool);
+        bind_cache();
+    }
+
+    ValueBind(const ValueBind& other)
+        : expr_{details::clone(other.expr_)}
+        , val_cache_(other.val_cache_)
+    {
+        bind_cache();
+    }
+
+    ValueBind(ValueBind&& other)
+        : expr_{std::move(other.expr_)}
+        , val_cache_(std::move(other.val_cache_))
+    {
+        bind_cache();
+    }
+
+    ValueBind& operator=(const ValueBind& other)
+    {
+        return *this = ValueBind(other);
+    }
+
+    ValueBind& operator=(ValueBind&& other)
+    {
+        expr_ = std::move(other.expr_);
+        val_cache_ = std::move(other.val_cache_);
+        bind_cache();
+        return *this;
+    }
+
     expr_t& get() { return expr_; }
+    const expr_t& get() const { return expr_; }
 
 private:
-    expr_t expr_; 
-    Eigen::Matrix<value_t, Eigen::Dynamic, 1> val_cache_;
-    Eigen::Matrix<value_t, Eigen::Dynamic, 1> adj_cache_;
+    void bind_cache()
+    {
+        details::ValueOnlyScope scope;
+        expr_.bind_cache({val_cache_.data(), nullptr});
+    }
+
+    expr_t expr_;
+    CacheBuffer<value_t> val_cache_;
 };
 
 } // namespace core
@@ -48,4 +342,58 @@ inline auto bind(const core::ExprBase<Derived>& expr)
     return core::ExprBind<Derived>(expr.self());
 }
 
+template <class Derived>
+inline auto bind(core::ExprBase<Derived>&& expr)
+{
+    return core::ExprBind<Derived>(std::move(expr.self()));
+}
+
+/**
+ * Binds expr with a cache drawn from pool.
+ * Use util::CachePool::local() for the calling thread's pool.
+ */
+template <class Derived>
+inline auto bind(const core::ExprBase<Derived>& expr,
+                 util::CachePool& pool)
+{
+    return core::ExprBind<Derived>(expr.self(), &pool);
+}
+
+template <class Derived>
+inline auto bind(core::ExprBase<Derived>&& expr,
+                 util::CachePool& pool)
+{
+    return core::ExprBind<Derived>(std::move(expr.self()), &pool);
+}
+
+/**
+ * Binds expr for forward evaluation only (see core::ValueBind).
+ * Optionally, the value cache is drawn from pool.
+ */
+template <class Derived>
+inline auto bind_value(const core::ExprBase<Derived>& expr)
+{
+    return core::ValueBind<Derived>(expr.self());
+}
+
+template <class Derived>
+inline auto bind_value(core::ExprBase<Derived>&& expr)
+{
+    return core::ValueBind<Derived>(std::move(expr.self()));
+}
+
+template <class Derived>
+inline auto bind_value(const core::ExprBase<Derived>& expr,
+                       util::CachePool& pool)
+{
+    return core::ValueBind<Derived>(expr.self(), &pool);
+}
+
+template <class Derived>
+inline auto bind_value(core::ExprBase<Derived>&& expr,
+                       util::CachePool& pool)
+{
+    return core::ValueBind<Derived>(std::move(expr.self()), &pool);
+}
+
 } // namespace ad
@@ -0,0 +1,363 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <fastad_bits/reverse/core/access.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/ptr_pack.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/*
+ * Number of steps that can be reversed with c snapshots (including the initial one)
+ * if every step is evaluated forward at most r times beyond the first sweep,
+ * i.e. the binomial coefficient (c + r choose c) (Griewank, 1992).
+ * Saturates at cap.
+ */
+inline size_t revolve_beta(size_t c, size_t r, size_t cap)
+{
+    size_t b = 1;
+    for (size_t i = 1; i <= c; ++i) {
+        b = b * (r + i) / i;
+        if (b >= cap) return cap;
+    }
+    return b;
+}
+
+/*
+ * Offset of the next snapshot when reversing n > 1 steps with c > 1 snapshots.
+ * The steps after the snapshot are reversed with c - 1 snapshots
+ * and the ones before it with c snapshots, both within the minimal number of repetitions.
+ */
+inline size_t revolve_split(size_t n, size_t c)
+{
+    size_t r = 0;
+    while (revolve_beta(c, r, n) < n) ++r;
+    size_t right = revolve_beta(c - 1, r, n);
+    return (n > right) ? n - right : 1;
+}
+
+} // namespace details
+
+/**
+ * CheckpointNode represents a sequence of steps like ForEachIterNode,
+ * but trades computation for memory in the backward evaluation.
+ * It is intended for long time-stepping models where every step updates
+ * the same placeholders (e.g. x += dt * f(x)).
+ *
+ * All steps share one cache region, so the cache size is the maximum
+ * (not the sum) over the steps.
+ * Forward evaluation keeps at most n_checkpoints snapshots of the state,
+ * i.e. the values of the placeholders that are written by more than one step
+ * or read before they are written.
+ * Backward evaluation restores a snapshot and re-evaluates forward up to every step
+ * before backward evaluating it, placing new snapshots in the freed slots
+ * following the binomial (revolve) schedule.
+ * With c snapshots and T steps, every step is re-evaluated at most r times
+ * where r is the smallest integer with (c + r choose c) >= T.
+ * When n_checkpoints is 0, ceil(log2(T)) snapshots are kept.
+ *
+ * Adjoints are exactly those of the equivalent ForEachIterNode.
+ * Since the steps must run sequentially, this node is a single statement
+ * for ScheduleNode.
+ *
+ * @tparam  ExprType    type of a step expression
+ */
+
+template <class ExprType>
+struct CheckpointNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<CheckpointNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+    using expr_shape_t = typename util::shape_traits<expr_t>::shape_t;
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t, expr_shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    CheckpointNode(const std::vector<expr_t>& steps,
+                   size_t n_checkpoints)
+        : CheckpointNode(std::vector<expr_t>(steps), n_checkpoints)
+    {}
+
+    CheckpointNode(std::vector<expr_t>&& steps,
+                   size_t n_checkpoints)
+        : value_adj_view_t(nullptr, nullptr,
+                           steps.empty() ? 0 : steps[0].rows(),
+                           steps.empty() ? 0 : steps[0].cols())
+        , steps_(std::move(steps))
+        , n_checkpoints_(n_checkpoints)
+    {
+        if (n_checkpoints_ == 0) {
+            n_checkpoints_ = std::max<size_t>(1,
+                    std::ceil(std::log2(std::max<size_t>(steps_.size(), 1))));
+        }
+    }
+
+    /**
+     * Forward evaluates every step and saves the snapshots
+     * that the backward evaluation starts from.
+     *
+     * @return  forward evaluation value of the last step
+     */
+    const var_t& feval()
+    {
+        if (steps_.empty()) return this->get();
+        size_t k = 0;
+        for (size_t t = 0; t < steps_.size(); ++t) {
+            if (k < chain_.size() && chain_[k] == t) save(k++);
+            steps_[t].feval();
+        }
+        return this->get() = steps_.back().get();
+    }
+
+    /**
+     * Backward evaluates the last step with seed, whose cache is still in place,
+     * then every other step in reverse order with 0 seed
+     * after restoring and re-evaluating its forward state.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        if (steps_.empty()) return;
+        size_t n = steps_.size();
+        steps_.back().beval(seed);
+        for (size_t k = chain_.size(); k-- > 0;) {
+            size_t end = (k + 1 < chain_.size()) ? chain_[k+1] : n - 1;
+            restore(k);
+            reverse(chain_[k], end, n_checkpoints_ - k, k);
+        }
+    }
+
+    /**
+     * Binds every step to the same region starting at begin,
+     * then binds itself to the next region.
+     * The placeholders to snapshot are found by visiting every step.
+     *
+     * @return  the next pointer not bound by any of the steps and itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        if (steps_.empty()) return begin;
+        ptr_pack_t next = begin;
+        for (auto& step : steps_) {
+            auto step_next = step.bind_cache(begin);
+            next.val = std::max(next.val, step_next.val);
+            next.adj = std::max(next.adj, step_next.adj);
+        }
+        next = value_adj_view_t::bind(next);
+        init_snapshots();
+        return next;
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        util::SizePack out = util::SizePack::Zero();
+        for (const auto& step : steps_) {
+            out = out.max(step.bind_cache_size());
+        }
+        return out + single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        for (auto& step : steps_) {
+            step.visit(v);
+        }
+    }
+
+    size_t n_checkpoints() const { return n_checkpoints_; }
+
+    // number of values in one snapshot of the state
+    size_t state_size() const { return state_size_; }
+
+private:
+    using access_t = details::Access<value_t>;
+
+    /*
+     * Reverses steps [s, e) given that the state is that of step s,
+     * a snapshot of which is at level, and that c snapshots
+     * (including that one) are available.
+     */
+    void reverse(size_t s, size_t e, size_t c, size_t level)
+    {
+        size_t n = e - s;
+        if (n == 0) return;
+        if (n == 1) {
+            steps_[s].feval();
+            steps_[s].beval(0);
+            return;
+        }
+        if (c <= 1) {
+            for (size_t t = e; t-- > s;) {
+                if (t + 1 != e) restore(level);
+                for (size_t i = s; i <= t; ++i) steps_[i].feval();
+                steps_[t].beval(0);
+            }
+            return;
+        }
+        size_t m = s + details::revolve_split(n, c);
+        for (size_t i = s; i < m; ++i) steps_[i].feval();
+        save(level + 1);
+        reverse(m, e, c - 1, level + 1);
+        restore(level);
+        reverse(s, m, c, level);
+    }
+
+    void save(size_t level)
+    {
+        value_t* out = snapshots_.data() + level * state_size_;
+        for (const auto& r : state_) {
+            out = std::copy_n(r.val, r.size, out);
+        }
+    }
+
+    void restore(size_t level)
+    {
+        const value_t* in = snapshots_.data() + level * state_size_;
+        for (const auto& r : state_) {
+            std::copy_n(in, r.size, r.val);
+            in += r.size;
+        }
+    }
+
+    /*
+     * Finds the state as the union of written regions that are written
+     * by more than one step or read by a step no later than their first writer.
+     * Regions written once are never clobbered by re-evaluation.
+     * Also computes the snapshot positions of the first descent of the
+     * backward evaluation over all but the last step, which are saved in feval.
+     */
+    void init_snapshots()
+    {
+        // no snapshots when bound for forward evaluation only
+        if (details::ValueOnlyScope::active()) {
+            state_.clear();
+            state_size_ = 0;
+            chain_.clear();
+            snapshots_.clear();
+            return;
+        }
+
+        size_t n = steps_.size();
+        std::vector<details::AccessCollector<value_t>> accesses(n);
+        for (size_t t = 0; t < n; ++t) {
+            steps_[t].visit(accesses[t]);
+        }
+
+        // merge written regions into disjoint sorted regions
+        std::vector<access_t> writes;
+        for (const auto& a : accesses) {
+            writes.insert(writes.end(), a.writes.begin(), a.writes.end());
+        }
+        std::sort(writes.begin(), writes.end(),
+                [](const auto& x, const auto& y) { return x.val < y.val; });
+        std::vector<access_t> regions;
+        for (const auto& w : writes) {
+            if (!regions.empty() &&
+                w.val <= regions.back().val + regions.back().size) {
+                auto& r = regions.back();
+                r.size = std::max(r.val + r.size, w.val + w.size) - r.val;
+            } else {
+                regions.push_back(w);
+            }
+        }
+
+        details::RangeIndex<value_t> index;
+        for (const auto& r : regions) index.add(r.val, r.size);
+        index.finalize();
+
+        // first and last writer, number of writers and whether it is read before written
+        std::vector<size_t> first(regions.size(), n);
+        std::vector<size_t> last(regions.size(), n);
+        std::vector<size_t> n_writers(regions.size(), 0);
+        std::vector<bool> read_first(regions.size(), false);
+        for (size_t t = 0; t < n; ++t) {
+            for (const auto& w : accesses[t].writes) {
+                index.overlapping(w.val, w.size, [&](size_t i) {
+                    if (last[i] == t) return;
+                    if (first[i] == n) first[i] = t;
+                    last[i] = t;
+                    ++n_writers[i];
+                });
+            }
+        }
+        for (size_t t = 0; t < n; ++t) {
+            for (const auto& r : accesses[t].reads) {
+                index.overlapping(r.val, r.size, [&](size_t i) {
+                    if (t <= first[i]) read_first[i] = true;
+                });
+            }
+        }
+
+        state_.clear();
+        state_size_ = 0;
+        for (size_t i = 0; i < regions.size(); ++i) {
+            if (n_writers[i] > 1 || read_first[i]) {
+                state_.push_back(regions[i]);
+                state_size_ += regions[i].size;
+            }
+        }
+
+        chain_.clear();
+        size_t s = 0;
+        size_t e = n - 1;
+        for (size_t c = n_checkpoints_; s < e; --c) {
+            chain_.push_back(s);
+            if (e - s == 1 || c <= 1) break;
+            s += details::revolve_split(e - s, c);
+        }
+        snapshots_.resize(chain_.empty() ? 0 : n_checkpoints_ * state_size_);
+    }
+
+    std::vector<expr_t> steps_;
+    size_t n_checkpoints_;
+    std::vector<access_t> state_;
+    size_t state_size_ = 0;
+    std::vector<size_t> chain_;
+    std::vector<value_t> snapshots_;
+};
+
+} // namespace core
+
+/**
+ * Helper function to create a CheckpointNode.
+ * It is a drop-in replacement of ad::for_each(begin, end, f)
+ * that keeps at most n_checkpoints snapshots of the state (see CheckpointNode).
+ */
+template <class Iter, class Lmda>
+inline auto checkpoint_for_each(Iter begin, Iter end, Lmda f,
+                                size_t n_checkpoints = 0)
+{
+    using expr_t = std::decay_t<decltype(f(*begin))>;
+    std::vector<expr_t> steps;
+    steps.reserve(std::distance(begin, end));
+    std::for_each(begin, end,
+            [&](const auto& x) {
+                steps.emplace_back(f(x));
+            });
+    return core::CheckpointNode<expr_t>(std::move(steps), n_checkpoints);
+}
+
+} // namespace ad
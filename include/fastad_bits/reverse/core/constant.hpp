@@ -1,4 +1,6 @@
 #pragma once
+#include <memory>
+#include <utility>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_view.hpp>
 #include <fastad_bits/util/shape_traits.hpp>
@@ -11,7 +13,13 @@ namespace core {
 
 template <class Derived>
 struct ConstantBase: ExprBase<Derived>
-{};
+{
+    /**
+     * Constants are neither leaves nor placeholders, so there is nothing to visit.
+     */
+    template <class Visitor>
+    constexpr void visit(Visitor&) const {}
+};
 
 /**
  * ConstantView represents constants in a mathematical formula.
@@ -79,6 +87,19 @@ private:
     var_t val_;
 };
 
+/**
+ * Constant represents constants in a mathematical formula.
+ * Unlike ConstantView, it owns the constant value(s).
+ *
+ * Vector and matrix values are held in shared immutable storage,
+ * so that copying a Constant (e.g. when it is wrapped by a node,
+ * passed to ad::bind or copied into a vector of expressions)
+ * never copies the values.
+ *
+ * @tparam  ValueType   underlying data type
+ * @tparam  ShapeType   shape of constant
+ */
+
 template <class ValueType, class ShapeType>
 struct Constant:
     ConstantBase<Constant<ValueType, ShapeType>>
@@ -92,12 +113,25 @@ public:
     using value_adj_view_t = Constant<value_t, shape_t>;
     using ptr_pack_t = util::PtrPack<value_t>;
 
+private:
+    using storage_t = std::conditional_t<
+        std::is_same_v<shape_t, ad::scl>,
+        var_t, std::shared_ptr<const var_t> >;
+
+public:
     template <class T>
     Constant(const T& c)
-        :c_(c)
+        : c_(make_storage(c))
+    {}
+
+    /**
+     * Takes over the values of c without copying them.
+     */
+    Constant(var_t&& c)
+        : c_(make_storage(std::move(c)))
     {}
 
-    const var_t& feval() const { return c_; }
+    const var_t& feval() const { return get(); }
 
     template <class T>
     void beval(const T&) const {}
@@ -111,14 +145,21 @@ public:
     util::SizePack bind_cache_size() const { return {0,0}; }
     util::SizePack single_bind_cache_size() const { return {0,0}; }
 
-    const var_t& get() const { return c_; }
+    const var_t& get() const {
+        if constexpr (util::is_scl_v<this_t>) {
+            return c_;
+        } else {
+            return *c_;
+        }
+    }
+
     const value_t& get(size_t i, size_t j) const { 
         if constexpr (util::is_scl_v<this_t>) {
             static_cast<void>(i);
             static_cast<void>(j);
             return c_;
         } else {
-            return c_(i,j); 
+            return (*c_)(i,j); 
         }
     }
 
@@ -126,7 +167,7 @@ public:
         if constexpr (util::is_scl_v<this_t>) {
             return &c_;
         } else {
-            return c_.data(); 
+            return c_->data(); 
         }
     }
 
@@ -134,7 +175,7 @@ public:
         if constexpr (util::is_scl_v<this_t>) {
             return 1;
         } else {
-            return c_.rows(); 
+            return c_->rows(); 
         }
     }
 
@@ -142,12 +183,22 @@ public:
         if constexpr (util::is_scl_v<this_t>) {
             return 1;
         } else {
-            return c_.cols(); 
+            return c_->cols(); 
         }
     }
 
 private:
-    var_t c_;
+    template <class T>
+    static storage_t make_storage(T&& c)
+    {
+        if constexpr (util::is_scl_v<this_t>) {
+            return c;
+        } else {
+            return std::make_shared<const var_t>(std::forward<T>(c));
+        }
+    }
+
+    storage_t c_;
 };
 
 } // namespace core
@@ -185,6 +236,16 @@ inline auto constant(const Eigen::EigenBase<Derived>& x)
     return core::Constant<value_t, ad::vec>(x);
 }
 
+/**
+ * Moves the values of a temporary (or std::move'd) vector into the constant
+ * instead of copying them.
+ */
+template <class ValueType>
+inline auto constant(Eigen::Matrix<ValueType, Eigen::Dynamic, 1>&& x)
+{
+    return core::Constant<ValueType, ad::vec>(std::move(x));
+}
+
 /** 
  * By default, uses ad::mat as shape, but if user knows and
  * wishes to treat the matrix as a self-adjoint matrix, they can 
@@ -199,4 +260,15 @@ inline auto constant(const Eigen::EigenBase<Derived>& x)
     return core::Constant<value_t, ShapeType>(x);
 }
 
+/**
+ * Moves the values of a temporary (or std::move'd) matrix into the constant
+ * instead of copying them.
+ */
+template <class ShapeType = ad::mat
+        , class ValueType>
+inline auto constant(Eigen::Matrix<ValueType, Eigen::Dynamic, Eigen::Dynamic>&& x)
+{
+    return core::Constant<ValueType, ShapeType>(std::move(x));
+}
+
 } // namespace ad
@@ -0,0 +1,175 @@
+#pragma once
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <Eigen/Core>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * DataSlot represents data that changes between evaluations,
+ * like the current row or minibatch of a dataset.
+ * Ex.
+ * auto xi = ad::data_slot(X.col(0).data(), X.rows());
+ * auto expr = ad::bind(ad::pow<2>(y - ad::sum(xi * w)));
+ * for (int i = 0; i < X.cols(); ++i) {
+ *     xi.set_data(X.col(i).data());
+ *     ad::autodiff(expr);
+ * }
+ * Like ConstantView, it views the data without copying it
+ * and has no adjoint.
+ * Unlike ConstantView, all copies of a DataSlot refer to one pointer,
+ * so that the copies inside a bound expression view the new data
+ * as soon as any copy calls set_data.
+ * This is O(1) and needs no copy of the data and no rebinding.
+ * For the same reason a DataSlot is not a constant (see util::is_constant_v):
+ * nodes fold constant operands or cache values computed from them when they are built,
+ * whereas the data of a slot is read on every forward evaluation.
+ *
+ * The shape is fixed at construction, since every node that consumes
+ * the data sizes its cache when the expression is bound.
+ * Batches of different sizes can be fed through ad::map_reduce.
+ * A vector slot can be sliced with segment; slices share the pointer
+ * of the slot, so they follow set_data on any of them.
+ *
+ * @tparam  ValueType   underlying data type
+ * @tparam  ShapeType   shape of data (one of scl, vec, mat)
+ */
+
+template <class ValueType
+        , class ShapeType>
+struct DataSlot:
+    ExprBase<DataSlot<ValueType, ShapeType>>
+{
+private:
+    using this_t = DataSlot<ValueType, ShapeType>;
+    using map_t = Eigen::Map<const util::constant_var_t<ValueType, ShapeType>>;
+
+public:
+    using value_t = ValueType;
+    using shape_t = ShapeType;
+    using value_adj_view_t = this_t;
+    using var_t = std::conditional_t<
+        util::is_scl_v<this_t>, value_t, map_t>;
+    using ptr_pack_t = util::PtrPack<value_t>;
+
+    DataSlot(const value_t* begin,
+             size_t rows,
+             size_t cols)
+        : data_(std::make_shared<const value_t*>(begin))
+        , rows_(rows)
+        , cols_(cols)
+    {}
+
+    /**
+     * Points every copy of this slot to new data of the same shape.
+     * The data must outlive the evaluations that read it.
+     * Called on a slice, it points the slot the slice was taken from.
+     */
+    void set_data(const value_t* begin) { *data_ = begin; }
+
+    /**
+     * Returns the vector slot of the rows elements starting at offset,
+     * which views the data of this slot.
+     */
+    DataSlot<value_t, ad::vec> segment(size_t offset, size_t rows) const
+    {
+        static_assert(std::is_same_v<shape_t, ad::vec>);
+        assert(offset + rows <= rows_);
+        return DataSlot<value_t, ad::vec>(data_, offset_ + offset, rows);
+    }
+
+    /**
+     * Forward evaluation returns the data currently pointed to.
+     * @return  value (scalar) or view (vector or matrix) of the data
+     */
+    decltype(auto) feval() const { return get(); }
+
+    /**
+     * Backward evaluation does nothing.
+     */
+    template <class T>
+    void beval(const T&) const {}
+
+    template <class T>
+    constexpr T bind(T begin) const { return begin; }
+
+    template <class T>
+    constexpr T bind_cache(T begin) const { return begin; }
+
+    util::SizePack bind_cache_size() const { return {0,0}; }
+    util::SizePack single_bind_cache_size() const { return {0,0}; }
+
+    /**
+     * Data is neither a leaf nor a placeholder, so there is nothing to visit.
+     */
+    template <class Visitor>
+    constexpr void visit(Visitor&) const {}
+
+    decltype(auto) get() const
+    {
+        assert(*data_);
+        if constexpr (util::is_scl_v<this_t>) {
+            return static_cast<const value_t&>(*data());
+        } else {
+            return map_t(data(), rows_, cols_);
+        }
+    }
+
+    value_t get(size_t i, size_t j) const { return data()[i + j * rows_]; }
+    size_t size() const { return rows_ * cols_; }
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    const value_t* data() const { return *data_ + offset_; }
+
+private:
+    template <class, class>
+    friend struct DataSlot;
+
+    DataSlot(const std::shared_ptr<const value_t*>& data,
+             size_t offset,
+             size_t rows)
+        : data_(data)
+        , offset_(offset)
+        , rows_(rows)
+        , cols_(1)
+    {}
+
+    std::shared_ptr<const value_t*> data_;
+    size_t offset_ = 0;
+    size_t rows_;
+    size_t cols_;
+};
+
+} // namespace core
+
+// Helper function:
+// ad::data_slot(...)
+
+template <class ValueType>
+inline auto data_slot(const ValueType* x)
+{
+    return core::DataSlot<ValueType, ad::scl>(x, 1, 1);
+}
+
+template <class ValueType>
+inline auto data_slot(const ValueType* x,
+                      size_t rows)
+{
+    return core::DataSlot<ValueType, ad::vec>(x, rows, 1);
+}
+
+template <class ShapeType = ad::mat, class ValueType>
+inline auto data_slot(const ValueType* x,
+                      size_t rows,
+                      size_t cols)
+{
+    return core::DataSlot<ValueType, ShapeType>(x, rows, cols);
+}
+
+} // namespace ad
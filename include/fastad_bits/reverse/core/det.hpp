@@ -2,6 +2,7 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/value.hpp>
@@ -50,9 +51,19 @@ public:
         assert(expr.rows() == expr.cols());
     }
 
+    /**
+     * If the expression is an ad::llt expression,
+     * the decomposition reuses its factor.
+     */
     const var_t& feval()
     {
-        return this->get() = decomp_.fmap(expr_.feval());
+        auto&& x = expr_.feval();
+        if constexpr (details::is_llt_v<expr_t>) {
+            static_cast<void>(x);
+            return this->get() = decomp_.fmap(expr_.expr().llt());
+        } else {
+            return this->get() = decomp_.fmap(x);
+        }
     }
 
     void beval(value_t seed)
@@ -83,6 +94,12 @@ public:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
 private:
     using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
     expr_t expr_;
@@ -168,6 +185,7 @@ template <class ValueType>
 struct DetLLT
 {
     using value_t = ValueType;
+    using llt_t = typename core::details::LLTCache<value_t>::llt_t;
 
     DetLLT(size_t rows)
         : llt_(rows)
@@ -178,26 +196,39 @@ struct DetLLT
     value_t fmap(const Eigen::MatrixBase<T>& X)
     {
         llt_.compute(X);
-        value_t det = llt_.matrixL().determinant();
-        return det * det;
+        return fmap();
+    }
+
+    // Reuses the factor of an ad::llt expression.
+    value_t fmap(const llt_t& llt)
+    {
+        llt_.share(llt);
+        return fmap();
     }
 
     // Important to save the inverse, since otherwise Eigen
     // will dynamically allocate every time and result in bad-alloc.
+    // The inverse is computed by triangular solves with the factor.
     const auto& bmap() 
     {
-        size_t n = llt_.rows();
-        return inv_ = llt_.solve(mat_t::Identity(n, n));
+        size_t n = llt_.get().rows();
+        return inv_ = llt_.get().solve(mat_t::Identity(n, n));
     }
 
     bool valid() const 
     {
-        return (llt_.info() == Eigen::Success); 
+        return llt_.valid(); 
     }
 
 private:
+    value_t fmap()
+    {
+        value_t det = llt_.get().matrixLLT().diagonal().prod();
+        return det * det;
+    }
+
     using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
-    Eigen::LLT<mat_t> llt_;
+    core::details::LLTCache<value_t> llt_;
     mat_t inv_;
 };
 
@@ -226,7 +257,11 @@ inline auto det(const T& x)
         var_t out = expr.feval().determinant();
         return ad::constant(out);
     } else {
-        return core::DetNode<DecompType<value_t>, expr_t>(expr);
+        // an ad::llt expression is always decomposed with its own factor
+        using decomp_t = std::conditional_t<
+            core::details::is_llt_v<expr_t>,
+            DetLLT<value_t>, DecompType<value_t>>;
+        return core::DetNode<decomp_t, expr_t>(expr);
     }
 }
 
@@ -1,6 +1,8 @@
 #pragma once
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/value_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
@@ -47,6 +49,11 @@ using dot_shape_t = typename dot_shape<T,U>::type;
  * We assert that the value type be the same for the two expressions.
  * The output shape is always a (column) vector.
  *
+ * The seeds of the two expressions are written into a workspace
+ * bound right after the expressions in the adjoint cache,
+ * so backward evaluation does not allocate.
+ * No seed is computed for a constant expression.
+ *
  * @tparam  LHSExprType     type of left expression
  * @tparam  RHSExprType     type of right expression
  */
@@ -63,12 +70,19 @@ private:
     using rhs_t = RHSExprType;
     using lhs_value_t = typename 
         util::expr_traits<lhs_t>::value_t;
+    using lhs_adj_view_t = ValueView<lhs_value_t,
+          typename util::shape_traits<lhs_t>::shape_t>;
+    using rhs_adj_view_t = ValueView<lhs_value_t,
+          typename util::shape_traits<rhs_t>::shape_t>;
 
     // assert that both expressions have same value type
     static_assert(std::is_same_v<
             typename util::expr_traits<lhs_t>::value_t,
             typename util::expr_traits<rhs_t>::value_t>);
 
+    static constexpr bool lhs_is_constant = util::is_data_v<lhs_t>;
+    static constexpr bool rhs_is_constant = util::is_data_v<rhs_t>;
+
 public:
     using value_adj_view_t = ValueAdjView<lhs_value_t,
           details::dot_shape_t<lhs_t, rhs_t> >;
@@ -82,37 +96,70 @@ public:
         : value_adj_view_t(nullptr, nullptr, lhs.rows(), rhs.cols())
         , lhs_{lhs}
         , rhs_{rhs}
+        , lhs_adj_(nullptr, lhs.rows(), lhs.cols())
+        , rhs_adj_(nullptr, rhs.rows(), rhs.cols())
     {
         assert(lhs.cols() == rhs.rows());
     }
 
+    /**
+     * Forward evaluates both expressions and caches their product.
+     * The product is written directly into the cache
+     * unless the cache overlaps one of the operands
+     * (e.g. v = ad::dot(m, v) binds the cache to v).
+     */
     const var_t& feval()
     {
         auto&& lhs_val = lhs_.feval();
         auto&& rhs_val = rhs_.feval();
-        return this->get() = lhs_val * rhs_val;
+        if (overlaps(lhs_val) || overlaps(rhs_val)) {
+            return this->get() = lhs_val * rhs_val;
+        }
+        this->get().noalias() = lhs_val * rhs_val;
+        return this->get();
     }
 
+    /**
+     * Sets current adjoint to seed, writes the seeds of the expressions
+     * into the workspace and backward evaluates them from right to left.
+     * Constant expressions are skipped,
+     * and so are expressions that only read frozen leaves (see details::bind_active).
+     */
     template <class T>
     void beval(const T& seed)
     {
         util::to_array(this->get_adj()) = seed;
-        auto a_ladj = util::to_array(this->get_adj() * rhs_.get().transpose());
-        auto a_radj = util::to_array(lhs_.get().transpose() * this->get_adj());
-        rhs_.beval(a_radj);
-        lhs_.beval(a_ladj);
+        if constexpr (!rhs_is_constant) {
+            if (rhs_active_) {
+                rhs_adj_.get().noalias() = lhs_.get().transpose() * this->get_adj();
+                rhs_.beval(util::to_array(rhs_adj_.get()));
+            }
+        }
+        if constexpr (!lhs_is_constant) {
+            if (lhs_active_) {
+                lhs_adj_.get().noalias() = this->get_adj() * rhs_.get().transpose();
+                lhs_.beval(util::to_array(lhs_adj_.get()));
+            }
+        }
     }
 
+    /**
+     * Binds the expressions, then the workspace and itself last,
+     * so that an EqNode can rebind the root alone (see EqNode::bind_cache).
+     */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        begin = lhs_.bind_cache(begin);
-        begin = rhs_.bind_cache(begin);
+        lhs_active_ = details::bind_active([&]() { begin = lhs_.bind_cache(begin); });
+        rhs_active_ = details::bind_active([&]() { begin = rhs_.bind_cache(begin); });
+        if constexpr (!lhs_is_constant) begin.adj = lhs_adj_.bind(begin.adj);
+        if constexpr (!rhs_is_constant) begin.adj = rhs_adj_.bind(begin.adj);
         return value_adj_view_t::bind(begin);
     }
 
     util::SizePack bind_cache_size() const 
     { 
         return single_bind_cache_size() + 
+                workspace_size() +
                 lhs_.bind_cache_size() + 
                 rhs_.bind_cache_size();
     }
@@ -122,10 +169,34 @@ public:
         return {this->size(), this->size()};
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        lhs_.visit(v);
+        rhs_.visit(v);
+    }
 
 private:
+    util::SizePack workspace_size() const
+    {
+        return {0, (lhs_is_constant ? 0 : lhs_adj_.size()) +
+                   (rhs_is_constant ? 0 : rhs_adj_.size())};
+    }
+
+    template <class T>
+    bool overlaps(const T& x) const
+    {
+        const value_t* begin = this->data();
+        return (x.data() < begin + this->size()) &&
+               (begin < x.data() + x.size());
+    }
+
     lhs_t lhs_;
     rhs_t rhs_;
+    lhs_adj_view_t lhs_adj_;    // seed of lhs
+    rhs_adj_view_t rhs_adj_;    // seed of rhs
+    bool lhs_active_ = true;
+    bool rhs_active_ = true;
 };
 
 } // namespace core
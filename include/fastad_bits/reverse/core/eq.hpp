@@ -1,6 +1,8 @@
 #pragma once
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/adj_buffer.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/ptr_pack.hpp>
@@ -114,10 +116,18 @@ public:
      * are viewing the same values to save space and copying.
      * Ignores expression if it is a VarView.
      *
+     * Reads of the placeholder must not be redirected to an AdjBuffer
+     * since its full adjoint is needed in beval,
+     * so placeholders must not be defined inside a parallel sum
+     * (ScheduleNode bypasses buffering for placeholders).
+     *
      * @return  next pointer not bound by expression.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
+        assert(!AdjBuffer<value_t>::current() ||
+               AdjBuffer<value_t>::current()->bypasses(
+                   var_view_.data_adj(), var_view_.size()));
         ptr_pack_t var_ptr_pack(var_view_.data(), var_view_.data_adj());
 
         // bind current eqnode to var_view's values
@@ -153,6 +163,13 @@ public:
     util::SizePack single_bind_cache_size() const
     { return {0,0}; }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+        v.write(var_view_);
+    }
+
 private:
     var_view_t var_view_;
     expr_t expr_;
@@ -279,8 +296,13 @@ public:
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
+        assert(!AdjBuffer<value_t>::current() ||
+               AdjBuffer<value_t>::current()->bypasses(
+                   var_view_.data_adj(), var_view_.size()));
         value_adj_view_t::bind({var_view_.data(), var_view_.data_adj()});
         begin = expr_.bind_cache(begin);
+        // the previous value of the variable is read as well
+        details::ActivityScope::read(var_view_.is_frozen());
         begin = cache_.bind(begin);
         return begin;
     }
@@ -296,6 +318,14 @@ public:
         return {cache_.size(), cache_.size()}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+        v.read(var_view_);
+        v.write(var_view_);
+    }
+
 private:
     value_adj_view_t cache_;
     var_view_t var_view_;
@@ -4,6 +4,7 @@
 #include <tuple>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/adj_buffer.hpp>
 #include <fastad_bits/util/value.hpp>
 
 namespace ad {
@@ -33,6 +34,37 @@ inline auto evaluate(core::ExprBind<ExprType>&& expr)
     return expr.get().feval();
 }
 
+template <class ExprType>
+inline auto evaluate(core::ValueBind<ExprType>& expr)
+{
+    return expr.get().feval();
+}
+
+template <class ExprType>
+inline auto evaluate(core::ValueBind<ExprType>&& expr)
+{
+    return expr.get().feval();
+}
+
+namespace details {
+
+/*
+ * Moves the float leaf adjoints of the AdjAccumulator alive on this thread
+ * (if any) into its double storage after every backward pass.
+ * Other value types never consult an accumulator.
+ */
+template <class ValueType>
+inline void collect_adj()
+{
+    if constexpr (std::is_same_v<ValueType, float>) {
+        if (auto* acc = core::AdjAccumulator<ValueType>::current()) {
+            acc->collect();
+        }
+    }
+}
+
+} // namespace details
+
 /* 
  * Evaluates expression in the backward direction of reverse-mode AD.
  * Default parameter should fail exactly when expression is multi-dimensional.
@@ -46,6 +78,8 @@ evaluate_adj(ExprType&& expr,
              typename util::expr_traits<std::decay_t<ExprType>>::value_t seed = 1.)
 {
     expr.beval(seed);
+    details::collect_adj<typename util::expr_traits<
+        std::decay_t<ExprType>>::value_t>();
 }
 
 template <class ExprType, class T>
@@ -54,6 +88,8 @@ evaluate_adj(ExprType&& expr,
              const Eigen::ArrayBase<T>& seed)
 {
     expr.beval(seed);
+    details::collect_adj<typename util::expr_traits<
+        std::decay_t<ExprType>>::value_t>();
 }
 
 template <class ExprType>
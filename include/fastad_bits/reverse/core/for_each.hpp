@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <iterator>
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/util/type_traits.hpp>
@@ -37,10 +40,14 @@ public:
     using typename value_adj_view_t::ptr_pack_t;
 
     ForEachIterNode(const VecType& vec)
+        : ForEachIterNode(VecType(vec))
+    {}
+
+    ForEachIterNode(VecType&& vec)
         : value_adj_view_t(nullptr, nullptr,
                            (vec.size() == 0) ? 0 : vec[0].rows(),
                            (vec.size() == 0) ? 0 : vec[0].cols())
-        , vec_(vec)
+        , vec_(std::move(vec))
     {}
 
     /** 
@@ -69,45 +76,87 @@ public:
     template <class T>
     void beval(const T& seed)
     {
-        if (vec_.size() == 0) return;
-        auto it = vec_.rbegin();
-        it->beval(seed);
-        std::for_each(std::next(it), vec_.rend(), 
-                [&](auto& expr) {
-                    expr.beval(0); 
-                }
-        );
+        const size_t n = vec_.size();
+        if (n == 0) return;
+        if (active_.empty()) {
+            auto it = vec_.rbegin();
+            it->beval(seed);
+            std::for_each(std::next(it), vec_.rend(), 
+                    [&](auto& expr) {
+                        expr.beval(0); 
+                    }
+            );
+            return;
+        }
+        if (active_[n-1]) vec_.back().beval(seed);
+        for (size_t i = n-1; i-- > 0;) {
+            if (active_[i]) vec_[i].beval(0); 
+        }
     }
 
     /**
      * Bind every expression from left to right then bind itself
      * to the last expression.
+     * Like GlueNode, the expressions are backward evaluated one after the other,
+     * so they bind their values to disjoint regions but their adjoints from the same pointer.
+     * Expressions that only read frozen leaves are not backward evaluated
+     * (see details::bind_active).
      *
      * @return  the next pointer not bound by any of the expressions and itself.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
         if (vec_.size() == 0) return begin;
-        for (auto& expr : vec_) {
-            begin = expr.bind_cache(begin);
-        }
+        value_t* adj_end = begin.adj;
+        active_ = details::bind_activity(vec_, [&](auto& expr) {
+            auto next = expr.bind_cache(begin);
+            begin.val = next.val;
+            adj_end = std::max(adj_end, next.adj);
+        });
         value_adj_view_t::bind({vec_.back().data(), vec_.back().data_adj()});
-        return begin;
+        return {begin.val, adj_end};
     }
 
     util::SizePack bind_cache_size() const 
     { 
         util::SizePack out = util::SizePack::Zero();
         for (const auto& expr : vec_) {
-            out += expr.bind_cache_size();
+            auto size = expr.bind_cache_size();
+            out(0) += size(0);
+            out(1) = std::max(out(1), size(1));
         }
         return out;
     }
 
     util::SizePack single_bind_cache_size() const { return {0,0}; }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        for (auto& expr : vec_) {
+            expr.visit(v);
+        }
+    }
+
+    /**
+     * Applies f on every expression from left to right.
+     * Used to flatten a program into its sequence of statements (see ScheduleNode).
+     */
+    template <class F>
+    void for_each_statement(F&& f) 
+    { 
+        for (auto& expr : vec_) f(expr); 
+    }
+
+    template <class F>
+    void for_each_statement(F&& f) const
+    { 
+        for (const auto& expr : vec_) f(expr); 
+    }
+
 private:
     std::vector<vec_elem_t> vec_;
+    std::vector<bool> active_;  // empty if every expression is active
 };
 
 } // namespace core
@@ -125,7 +174,7 @@ inline auto for_each(Iter begin, Iter end, Lmda f)
             [&](const auto& x) {
                 exprs.emplace_back(f(x));
             });
-    return core::ForEachIterNode<std::vector<expr_t>>(exprs);
+    return core::ForEachIterNode<std::vector<expr_t>>(std::move(exprs));
 }
 
 } // namespace ad
@@ -0,0 +1,594 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/*
+ * Elementwise nodes that a FusedNode compiles into one Eigen array expression.
+ * Comparisons are not fused since they have no adjoint.
+ */
+template <class T>
+struct is_fusable : std::false_type {};
+
+template <class Unary, class ExprType>
+struct is_fusable<UnaryNode<Unary, ExprType>> : std::true_type {};
+
+template <class Binary, class LeftExprType, class RightExprType>
+struct is_fusable<BinaryNode<Binary, LeftExprType, RightExprType>>
+    : std::bool_constant<!Binary::is_comparison> {};
+
+template <class T>
+inline constexpr bool is_fusable_v = is_fusable<T>::value;
+
+template <class T>
+struct is_unary_node : std::false_type {};
+
+template <class Unary, class ExprType>
+struct is_unary_node<UnaryNode<Unary, ExprType>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_unary_node_v = is_unary_node<T>::value;
+
+template <class T>
+struct fused_op;
+
+template <class Unary, class ExprType>
+struct fused_op<UnaryNode<Unary, ExprType>> { using type = Unary; };
+
+template <class Binary, class LeftExprType, class RightExprType>
+struct fused_op<BinaryNode<Binary, LeftExprType, RightExprType>> { using type = Binary; };
+
+template <class T>
+using fused_op_t = typename fused_op<T>::type;
+
+template <class T>
+using fused_child_t = std::decay_t<decltype(std::declval<T&>().expr())>;
+template <class T>
+using fused_lhs_t = std::decay_t<decltype(std::declval<T&>().lhs())>;
+template <class T>
+using fused_rhs_t = std::decay_t<decltype(std::declval<T&>().rhs())>;
+
+/*
+ * Number of nodes and number of inputs of the chain rooted at T.
+ * FusedNode numbers the nodes in pre-order from the root (0)
+ * and the inputs from left to right.
+ */
+template <class T>
+constexpr size_t n_fused_nodes()
+{
+    if constexpr (!is_fusable_v<T>) return 0;
+    else if constexpr (is_unary_node_v<T>) return 1 + n_fused_nodes<fused_child_t<T>>();
+    else return 1 + n_fused_nodes<fused_lhs_t<T>>() + n_fused_nodes<fused_rhs_t<T>>();
+}
+
+template <class T>
+constexpr size_t n_fused_inputs()
+{
+    if constexpr (!is_fusable_v<T>) return 1;
+    else if constexpr (is_unary_node_v<T>) return n_fused_inputs<fused_child_t<T>>();
+    else return n_fused_inputs<fused_lhs_t<T>>() + n_fused_inputs<fused_rhs_t<T>>();
+}
+
+} // namespace details
+
+/**
+ * FusedNode evaluates a chain of elementwise nodes (UnaryNode and BinaryNode)
+ * as one Eigen array expression.
+ * Ex.
+ * ad::fuse(ad::sigmoid(ad::dot(A, y) + b) + x)
+ * The chain is the maximal subtree of elementwise nodes from the root
+ * and its inputs are the first non-elementwise subexpressions (here dot(A, y), b and x).
+ *
+ * Only the inputs and the root are bound to values, so the nodes inside the chain
+ * neither reserve nor write an intermediate array.
+ * Forward evaluation evaluates the inputs and then writes the root value
+ * in one pass over the inputs.
+ * Backward evaluation walks the root adjoint in blocks of block_size elements.
+ * For each block, it recomputes the values of the nodes inside the chain once,
+ * from the inputs up, then writes their seeds from the root down,
+ * both into small block buffers.
+ * The seeds of the inputs are gathered in buffers as large as the inputs,
+ * and every input is backward evaluated once after the last block.
+ * A variable used several times in the chain gets one buffer
+ * and is backward evaluated once.
+ * Scalar nodes inside a vector or matrix chain are evaluated once
+ * and their seeds are summed over the blocks.
+ * The block and input seed buffers are bound in the adjoint cache.
+ * Fusion thus trades memory traffic for one recomputation of the chain,
+ * which pays off for long chains of cheap operations on large vectors.
+ *
+ * The value type and shape type are the same as those of the chain.
+ *
+ * @tparam  ExprType    type of the root of the chain
+ */
+
+template <class ExprType>
+struct FusedNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<FusedNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    static_assert(util::is_expr_v<expr_t>);
+    static_assert(details::is_fusable_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<
+        typename util::expr_traits<expr_t>::value_t,
+        typename util::shape_traits<expr_t>::shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    static constexpr size_t block_size = 256;
+
+    FusedNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_(expr)
+        , block_(std::min(block_size, this->size()))
+    {}
+
+    /**
+     * Forward evaluates the inputs from left to right
+     * and caches the value of the chain.
+     *
+     * @return  const reference of the cached result.
+     */
+    const var_t& feval()
+    {
+        feval_inputs(expr_);
+        util::to_array(this->get()) = fmap(expr_);
+        return this->get();
+    }
+
+    /**
+     * Sets current adjoint to seed, computes the seeds of the inputs
+     * block by block and backward evaluates the inputs from right to left.
+     * It is assumed that feval is called before beval.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        util::to_array(this->get_adj()) = seed;
+        reset_seeds(expr_, 0, 0);
+        if constexpr (util::is_scl_v<expr_t>) {
+            fill_children<true>(expr_, 0, 0, 1);
+            seed_children<true>(expr_, 0, 0, this->get_adj(), this->get(), 0, 1);
+        } else {
+            fill_scl(expr_, 0);
+            const value_t* adj = this->get_adj().data();
+            const value_t* val = this->get().data();
+            for (size_t i = 0; i < this->size(); i += block_) {
+                size_t len = std::min(block_, this->size() - i);
+                fill_children<false>(expr_, 0, i, len);
+                seed_children<false>(expr_, 0, 0,
+                                     cmap_t(adj + i, len),
+                                     cmap_t(val + i, len),
+                                     i, len);
+            }
+            seed_scl(expr_, 0, 0);
+        }
+        beval_inputs(expr_, 0);
+    }
+
+    /**
+     * Binds the inputs from left to right, then the block and input seed buffers,
+     * then binds itself.
+     * @return  next pointer pack not bound by the inputs and itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = bind_inputs(expr_, begin);
+        work_ = begin.adj;
+        begin.adj += work_size();
+        auto layout = layout_seeds();
+        for (size_t j = 0; j < n_inputs_; ++j) {
+            seeds_[j] = begin.adj + layout.offset[j];
+            shared_[j] = layout.shared[j];
+        }
+        begin.adj += layout.size;
+        return value_adj_view_t::bind(begin);
+    }
+
+    /**
+     * Recursively gets the total number of values needed by the expression:
+     * that of the inputs, the seed buffers and the result of the chain.
+     * @return  size pack
+     */
+    util::SizePack bind_cache_size() const
+    {
+        return single_bind_cache_size() +
+                util::SizePack(0, work_size() + layout_seeds().size) +
+                inputs_bind_cache_size(expr_);
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), this->size()};
+    }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
+private:
+    using array_t = Eigen::Array<value_t, Eigen::Dynamic, 1>;
+    using map_t = Eigen::Map<array_t>;
+    using cmap_t = Eigen::Map<const array_t>;
+
+    template <class E>
+    using lhs_t = details::fused_lhs_t<E>;
+
+    template <class E>
+    static constexpr size_t n_nodes() { return details::n_fused_nodes<E>(); }
+    template <class E>
+    static constexpr size_t n_inputs() { return details::n_fused_inputs<E>(); }
+
+    // Node k > 0 owns a block of values and a block of seeds in work_.
+    size_t work_size() const { return 2 * block_ * (n_nodes<expr_t>() - 1); }
+    value_t* node_val(size_t k) const { return work_ + 2 * block_ * (k - 1); }
+    value_t* node_adj(size_t k) const { return node_val(k) + block_; }
+
+    template <class E>
+    static void feval_inputs(E& e)
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            e.feval();
+        } else if constexpr (details::is_unary_node_v<E>) {
+            feval_inputs(e.expr());
+        } else {
+            feval_inputs(e.lhs());
+            feval_inputs(e.rhs());
+        }
+    }
+
+    // Lazy array expression (or scalar) of the value of e given its inputs' values.
+    template <class E>
+    static auto fmap(E& e)
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            return util::to_array(e.get());
+        } else {
+            using op_t = details::fused_op_t<E>;
+            using e_value_t = typename util::expr_traits<E>::value_t;
+            if constexpr (details::is_unary_node_v<E>) {
+                return op_t::fmap(fmap(e.expr()));
+            } else {
+                return util::cast_to<e_value_t>(
+                        op_t::fmap(fmap(e.lhs()), fmap(e.rhs())));
+            }
+        }
+    }
+
+    /*
+     * Value of node k (e) on the elements [i, i+len) of the current block.
+     * A scalar is returned as is.
+     */
+    template <class E>
+    auto value(E& e, size_t k, size_t i, size_t len) const
+    {
+        if constexpr (details::is_fusable_v<E>) {
+            static_cast<void>(e);
+            static_cast<void>(i);
+            if constexpr (util::is_scl_v<E>) {
+                static_cast<void>(len);
+                return *node_val(k);
+            } else {
+                return cmap_t(node_val(k), len);
+            }
+        } else if constexpr (util::is_scl_v<E>) {
+            static_cast<void>(k);
+            static_cast<void>(i);
+            static_cast<void>(len);
+            return e.get();
+        } else {
+            static_cast<void>(k);
+            using e_value_t = typename util::expr_traits<E>::value_t;
+            using e_map_t = Eigen::Map<const Eigen::Array<e_value_t, Eigen::Dynamic, 1>>;
+            return e_map_t(e.get().data() + i, len);
+        }
+    }
+
+    /*
+     * Writes the value of node k (e) into its block if e is scalar and scl is true,
+     * or if e is not scalar and scl is false.
+     * Scalar nodes of a vector or matrix chain are filled once by fill_scl.
+     */
+    template <bool scl, class E>
+    void fill(E& e, size_t k, size_t i, size_t len) const
+    {
+        if constexpr (details::is_fusable_v<E> && util::is_scl_v<E> == scl) {
+            fill_children<scl>(e, k, i, len);
+            using op_t = details::fused_op_t<E>;
+            using e_value_t = typename util::expr_traits<E>::value_t;
+            if constexpr (details::is_unary_node_v<E>) {
+                auto x = value(e.expr(), k+1, i, len);
+                if constexpr (scl) *node_val(k) = op_t::fmap(x);
+                else map_t(node_val(k), len) = op_t::fmap(x);
+            } else {
+                constexpr size_t r = 1 + n_nodes<lhs_t<E>>();
+                auto x = util::cast_to<e_value_t>(
+                    op_t::fmap(value(e.lhs(), k+1, i, len),
+                               value(e.rhs(), k+r, i, len)));
+                if constexpr (scl) *node_val(k) = x;
+                else map_t(node_val(k), len) = x;
+            }
+        }
+    }
+
+    template <bool scl, class E>
+    void fill_children(E& e, size_t k, size_t i, size_t len) const
+    {
+        if constexpr (details::is_unary_node_v<E>) {
+            fill<scl>(e.expr(), k+1, i, len);
+        } else {
+            fill<scl>(e.lhs(), k+1, i, len);
+            fill<scl>(e.rhs(), k+1+n_nodes<lhs_t<E>>(), i, len);
+        }
+    }
+
+    // Fills the scalar subchains of a vector or matrix chain.
+    template <class E>
+    void fill_scl(E& e, size_t k) const
+    {
+        if constexpr (details::is_fusable_v<E>) {
+            if constexpr (util::is_scl_v<E>) {
+                fill<true>(e, k, 0, 1);
+            } else if constexpr (details::is_unary_node_v<E>) {
+                fill_scl(e.expr(), k+1);
+            } else {
+                fill_scl(e.lhs(), k+1);
+                fill_scl(e.rhs(), k+1+n_nodes<lhs_t<E>>());
+            }
+        }
+    }
+
+    /*
+     * Given the seed and value f of node k (e) with first input j,
+     * propagates the seed to the children of e.
+     */
+    template <bool scl, class E, class S, class F>
+    void seed_children(E& e, size_t k, size_t j,
+                       const S& seed, const F& f,
+                       size_t i, size_t len) const
+    {
+        using op_t = details::fused_op_t<E>;
+        if constexpr (details::is_unary_node_v<E>) {
+            auto x = value(e.expr(), k+1, i, len);
+            seed_node<scl>(e.expr(), k+1, j, op_t::bmap(seed, x, f), i, len);
+        } else {
+            constexpr size_t r = 1 + n_nodes<lhs_t<E>>();
+            constexpr size_t rj = n_inputs<lhs_t<E>>();
+            auto x = value(e.lhs(), k+1, i, len);
+            auto y = value(e.rhs(), k+r, i, len);
+            seed_node<scl>(e.rhs(), k+r, j+rj, op_t::brmap(seed, x, y, f), i, len);
+            seed_node<scl>(e.lhs(), k+1, j, op_t::blmap(seed, x, y, f), i, len);
+        }
+    }
+
+    /*
+     * Writes the seed of node k (e) with first input j and propagates it.
+     * Inputs write their seeds into their buffers and scalar nodes
+     * of a vector or matrix chain (scl is false) sum them up for seed_scl.
+     */
+    template <bool scl, class E, class S>
+    void seed_node(E& e, size_t k, size_t j,
+                   const S& seed, size_t i, size_t len) const
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            static_cast<void>(k);
+            if constexpr (util::is_data_v<E>) {
+                static_cast<void>(j);
+                static_cast<void>(seed);
+                static_cast<void>(i);
+                static_cast<void>(len);
+            } else if constexpr (util::is_scl_v<E>) {
+                static_cast<void>(i);
+                static_cast<void>(len);
+                *seeds_[j] += seed;
+            } else if (shared_[j]) {
+                map_t(seeds_[j] + i, len) += seed;
+            } else {
+                map_t(seeds_[j] + i, len) = seed;
+            }
+        } else if constexpr (scl) {
+            seed_children<true>(e, k, j, value_t(seed), *node_val(k), i, len);
+        } else if constexpr (util::is_scl_v<E>) {
+            static_cast<void>(j);
+            static_cast<void>(i);
+            static_cast<void>(len);
+            *node_adj(k) += seed;
+        } else {
+            map_t adj(node_adj(k), len);
+            adj = seed;
+            seed_children<false>(e, k, j, adj, cmap_t(node_val(k), len), i, len);
+        }
+    }
+
+    // Propagates the summed seeds of the scalar subchains of a vector or matrix chain.
+    template <class E>
+    void seed_scl(E& e, size_t k, size_t j) const
+    {
+        if constexpr (details::is_fusable_v<E>) {
+            if constexpr (util::is_scl_v<E>) {
+                seed_children<true>(e, k, j, *node_adj(k), *node_val(k), 0, 1);
+            } else if constexpr (details::is_unary_node_v<E>) {
+                seed_scl(e.expr(), k+1, j);
+            } else {
+                seed_scl(e.lhs(), k+1, j);
+                seed_scl(e.rhs(), k+1+n_nodes<lhs_t<E>>(), j+n_inputs<lhs_t<E>>());
+            }
+        }
+    }
+
+    // Zeroes the seeds that are summed up: those of scalar nodes and inputs.
+    template <class E>
+    void reset_seeds(E& e, size_t k, size_t j) const
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            static_cast<void>(k);
+            if constexpr (util::is_scl_v<E> && !util::is_data_v<E>) {
+                *seeds_[j] = 0;
+            } else {
+                static_cast<void>(j);
+            }
+        } else {
+            if constexpr (util::is_scl_v<E>) {
+                if (k) *node_adj(k) = 0;
+            }
+            if constexpr (details::is_unary_node_v<E>) {
+                reset_seeds(e.expr(), k+1, j);
+            } else {
+                reset_seeds(e.lhs(), k+1, j);
+                reset_seeds(e.rhs(), k+1+n_nodes<lhs_t<E>>(), j+n_inputs<lhs_t<E>>());
+            }
+        }
+    }
+
+    // Backward evaluates the inputs of e from right to left with their seeds.
+    template <class E>
+    void beval_inputs(E& e, size_t j) const
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            if constexpr (util::is_data_v<E>) {
+                static_cast<void>(e);
+                static_cast<void>(j);
+            } else if (shared_[j]) {
+                return;
+            } else if constexpr (util::is_scl_v<E>) {
+                e.beval(*seeds_[j]);
+            } else {
+                using e_map_t = Eigen::Map<const Eigen::Array<
+                    value_t, Eigen::Dynamic, Eigen::Dynamic>>;
+                e.beval(e_map_t(seeds_[j], e.rows(), e.cols()));
+            }
+        } else if constexpr (details::is_unary_node_v<E>) {
+            beval_inputs(e.expr(), j);
+        } else {
+            beval_inputs(e.rhs(), j+n_inputs<lhs_t<E>>());
+            beval_inputs(e.lhs(), j);
+        }
+    }
+
+    template <class E>
+    static ptr_pack_t bind_inputs(E& e, ptr_pack_t begin)
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            return e.bind_cache(begin);
+        } else if constexpr (details::is_unary_node_v<E>) {
+            return bind_inputs(e.expr(), begin);
+        } else {
+            begin = bind_inputs(e.lhs(), begin);
+            return bind_inputs(e.rhs(), begin);
+        }
+    }
+
+    // Calls f(e, j) on every input e (with number j) in the order their seeds are written.
+    template <class E, class F>
+    static void for_each_input(const E& e, size_t j, F&& f)
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            f(e, j);
+        } else if constexpr (details::is_unary_node_v<E>) {
+            for_each_input(e.expr(), j, f);
+        } else {
+            for_each_input(e.rhs(), j+n_inputs<lhs_t<E>>(), f);
+            for_each_input(e.lhs(), j, f);
+        }
+    }
+
+    static constexpr size_t n_inputs_ = details::n_fused_inputs<expr_t>();
+
+    struct seeds_layout_t
+    {
+        std::array<size_t, n_inputs_> offset = {};
+        std::array<bool, n_inputs_> shared = {};
+        size_t size = 0;
+    };
+
+    /*
+     * Lays out the seed buffers of the inputs, except constants.
+     * Non-scalar views of the same variable share the buffer of the first one
+     * whose seed is written: the others add their seeds to it
+     * and are not backward evaluated.
+     */
+    seeds_layout_t layout_seeds() const
+    {
+        seeds_layout_t layout;
+        std::array<const value_t*, n_inputs_> adj = {};
+        std::array<size_t, n_inputs_> size = {};
+        for_each_input(expr_, 0, [&](const auto& e, size_t j) {
+            using e_t = std::decay_t<decltype(e)>;
+            if constexpr (!util::is_data_v<e_t>) {
+                if constexpr (util::is_var_view_v<e_t> && !util::is_scl_v<e_t>) {
+                    adj[j] = e.data_adj();
+                    size[j] = e.size();
+                    for (size_t k = 0; k < n_inputs_; ++k) {
+                        if (k != j && adj[k] == adj[j] && size[k] == size[j] &&
+                            !layout.shared[k]) {
+                            layout.offset[j] = layout.offset[k];
+                            layout.shared[j] = true;
+                            return;
+                        }
+                    }
+                }
+                layout.offset[j] = layout.size;
+                layout.size += e.size();
+            }
+        });
+        return layout;
+    }
+
+    template <class E>
+    static util::SizePack inputs_bind_cache_size(const E& e)
+    {
+        if constexpr (!details::is_fusable_v<E>) {
+            return e.bind_cache_size();
+        } else if constexpr (details::is_unary_node_v<E>) {
+            return inputs_bind_cache_size(e.expr());
+        } else {
+            return inputs_bind_cache_size(e.lhs()) +
+                    inputs_bind_cache_size(e.rhs());
+        }
+    }
+
+    expr_t expr_;
+    size_t block_;                                  // elements per block
+    value_t* work_ = nullptr;                       // blocks of the nodes
+    std::array<value_t*, n_inputs_> seeds_ = {};    // seeds of the inputs
+    std::array<bool, n_inputs_> shared_ = {};       // seed buffer owned by another input
+};
+
+} // namespace core
+
+/**
+ * Fuses the chain of elementwise nodes at the root of expr (see FusedNode).
+ * Returns expr unchanged if its root is not elementwise.
+ */
+template <class Derived>
+inline auto fuse(const core::ExprBase<Derived>& expr)
+{
+    if constexpr (core::details::is_fusable_v<Derived>) {
+        return core::FusedNode<Derived>(expr.self());
+    } else {
+        return expr.self();
+    }
+}
+
+} // namespace ad
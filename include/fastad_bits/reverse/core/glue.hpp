@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/util/type_traits.hpp>
@@ -56,6 +58,15 @@ public:
         , expr_rhs_(expr_rhs)
     {}
 
+    GlueNode(left_t&& expr_lhs, 
+             right_t&& expr_rhs)
+        : value_adj_view_t(nullptr, nullptr,
+                           expr_rhs.rows(),
+                           expr_rhs.cols())
+        , expr_lhs_(std::move(expr_lhs))
+        , expr_rhs_(std::move(expr_rhs))
+    {}
+
     /** 
      * Forward evaluates the left expression first,
      * then the right expression and returns the cached result.
@@ -81,61 +92,95 @@ public:
     template <class T>
     void beval(const T& seed)
     {
-        expr_rhs_.beval(seed); 
-        expr_lhs_.beval(0);
+        if (rhs_active_) expr_rhs_.beval(seed); 
+        if (lhs_active_) expr_lhs_.beval(0);
     }
 
     /**
      * Binds left, then right expression, and binds itself
      * to whatever the right expression root is bound to.
+     * The values of both expressions are needed until backward evaluation,
+     * but the left expression is backward evaluated only after the right one is done,
+     * so both expressions bind their adjoints from the same pointer.
+     * An expression that only reads frozen leaves is not backward evaluated
+     * (see details::bind_active).
      *
      * @return  the next pointer pack not bound by left or right expressions
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        begin = expr_lhs_.bind_cache(begin);
-        begin = expr_rhs_.bind_cache(begin);
+        ptr_pack_t lhs_next = begin;
+        ptr_pack_t rhs_next = begin;
+        lhs_active_ = details::bind_active([&]() {
+            lhs_next = expr_lhs_.bind_cache(begin);
+        });
+        rhs_active_ = details::bind_active([&]() {
+            rhs_next = expr_rhs_.bind_cache({lhs_next.val, begin.adj});
+        });
         value_adj_view_t::bind({expr_rhs_.data(), expr_rhs_.data_adj()});
-        return begin;
+        return {rhs_next.val, std::max(lhs_next.adj, rhs_next.adj)};
     }
 
     /**
      * Recursively gets the total number of values needed by the expression.
      * Since a GlueNode simply binds to that of right expression,
      * it does not bind any extra amount.
+     * The adjoints of the two expressions overlap (see bind_cache).
      *
      * @return  bind size
      */
     util::SizePack bind_cache_size() const 
     { 
-        return expr_lhs_.bind_cache_size() + 
-                expr_rhs_.bind_cache_size();
+        auto lhs_size = expr_lhs_.bind_cache_size();
+        auto rhs_size = expr_rhs_.bind_cache_size();
+        return {lhs_size(0) + rhs_size(0),
+                std::max(lhs_size(1), rhs_size(1))};
     }
 
     util::SizePack single_bind_cache_size() const
     { return {0,0}; }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_lhs_.visit(v);
+        expr_rhs_.visit(v);
+    }
+
+    /**
+     * Applies f on the left then the right expression.
+     * Used to flatten a program into its sequence of statements (see ScheduleNode).
+     */
+    template <class F>
+    void for_each_statement(F&& f) { f(expr_lhs_); f(expr_rhs_); }
+
+    template <class F>
+    void for_each_statement(F&& f) const { f(expr_lhs_); f(expr_rhs_); }
+
 private:
     left_t expr_lhs_;
     right_t expr_rhs_;
+    bool lhs_active_ = true;
+    bool rhs_active_ = true;
 };
 
 // operator, overload to create GlueNode
+// Expressions passed as rvalues (e.g. the left operand of a chain) are moved.
 template <class Derived1
         , class Derived2
         , class = std::enable_if_t<
-            util::is_convertible_to_ad_v<Derived1> &&
-            util::is_convertible_to_ad_v<Derived2> &&
-            util::any_ad_v<Derived1, Derived2>
+            util::is_convertible_to_ad_v<std::decay_t<Derived1>> &&
+            util::is_convertible_to_ad_v<std::decay_t<Derived2>> &&
+            util::any_ad_v<std::decay_t<Derived1>, std::decay_t<Derived2>>
         >>
-inline auto operator,(const Derived1& node1, 
-                      const Derived2& node2)
+inline auto operator,(Derived1&& node1, 
+                      Derived2&& node2)
 {
-    using expr1_t = util::convert_to_ad_t<Derived1>;
-    using expr2_t = util::convert_to_ad_t<Derived2>;
-    expr1_t expr1 = node1;
-    expr2_t expr2 = node2;
-    return GlueNode<expr1_t, expr2_t>(expr1, expr2);
+    using expr1_t = util::convert_to_ad_t<std::decay_t<Derived1>>;
+    using expr2_t = util::convert_to_ad_t<std::decay_t<Derived2>>;
+    expr1_t expr1 = std::forward<Derived1>(node1);
+    expr2_t expr2 = std::forward<Derived2>(node2);
+    return GlueNode<expr1_t, expr2_t>(std::move(expr1), std::move(expr2));
 }
 
 } // namespace core
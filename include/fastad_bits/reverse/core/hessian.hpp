@@ -1,133 +1,182 @@
 #pragma once
 #include <type_traits>
-#include <algorithm>
-#include "eval.hpp"
-#include "forward.hpp"
-#include "type_traits.hpp"
+#include <utility>
+#include <Eigen/Core>
+#include <fastad_bits/forward/core/forward.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/parallel.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
 
 namespace ad {
 namespace core {
 
-template <class Iter, class T>
-Iter compute_hess(Iter it, const Vec<ForwardVar<T>>& x)
-{
-    std::for_each(x.cbegin(), x.cend(),
-        [&it](const typename Vec<ForwardVar<T>>::value_type& xi) mutable {
-            *it = xi.get_adjoint().get_adjoint();
-            ++it;
-        });
-    return it;
-}
+/**
+ * HessianWorker computes second-order derivatives by forward-over-reverse:
+ * the reverse expression f(x) is evaluated with ADForward<T> values.
+ * If the tangents of x are set to a direction v,
+ * then after one forward and backward evaluation
+ * the values of the adjoints of x are the gradient of f
+ * and their tangents are the Hessian-vector product H * v.
+ *
+ * A worker owns its variable x and f(x) bound to its own cache,
+ * so that workers can run concurrently.
+ *
+ * @tparam  T   underlying value type
+ * @tparam  F   functor that creates the expression from a vector Var x
+ */
 
-template <size_t... opt_sizes, class HessIter, class T, class Exgen>
-inline void hessian_gen(HessIter hess_begin, Vec<ForwardVar<T>>& x, Exgen&& gen)
+template <class T, class F>
+struct HessianWorker
 {
-    auto it = hess_begin;
-    auto expr = std::get<0>(gen.template generate<opt_sizes...>(x));
+    using value_t = T;
+    using fvalue_t = ADForward<value_t>;
+    using fvar_t = Var<fvalue_t, ad::vec>;
+    using vector_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+    using expr_t = std::decay_t<decltype(ad::bind(
+                std::declval<F&>()(std::declval<fvar_t&>())))>;
 
-    for (size_t i = 0; i < x.size(); ++i)
+    template <class Derived>
+    HessianWorker(F& f, const Eigen::MatrixBase<Derived>& x)
+        : x_(x.size())
+        , expr_(ad::bind(f(x_)))
     {
-        x.reset_adjoint();
-        if (i > 0) {
-            x[i-1].get_value().set_adjoint(0);  // set the (i-1)th forward variable's adjoint back to 0
+        for (int i = 0; i < x.size(); ++i) {
+            x_.get()(i) = fvalue_t(x(i), 0);
         }
-        x[i].get_value().set_adjoint(1); // set the ith forward variable's adjoint to 1
-        autodiff(expr);
-        // Record Hessian first column
-        // Advance iterator to next column of matrix
-        it = compute_hess(it, x);
     }
-}
 
-template <size_t... opt_sizes, class HessIter, class GradIter, class T, class Exgen>
-inline void hessian_gen(HessIter hess_begin, GradIter grad_begin, Vec<ForwardVar<T>>& x, Exgen&& gen)
-{
-    auto it = hess_begin;
-    auto expr = std::get<0>(gen.template generate<opt_sizes...>(x));
-
-    for (size_t i = 0; i < x.size(); ++i)
+    /**
+     * Evaluates f with the tangents of x set to v.
+     * @return  value of f
+     */
+    template <class Derived>
+    value_t run(const Eigen::MatrixBase<Derived>& v)
     {
-        x.reset_adjoint();
-        if (i > 0) {
-            x[i-1].get_value().set_adjoint(0);  // set the (i-1)th forward variable's adjoint back to 0
+        auto& x = x_.get();
+        for (int i = 0; i < x.size(); ++i) {
+            x(i).set_adjoint(v(i));
         }
-        x[i].get_value().set_adjoint(1); // set the ith forward variable's adjoint to 1
-        autodiff(expr);
+        x_.reset_adj();
+        return ad::autodiff(expr_, fvalue_t(1, 0)).get_value();
+    }
 
-        // Record gradient
-        *grad_begin = expr.get_value().get_adjoint(); // get expression forward value's adjoint
-        ++grad_begin;
-        // Record Hessian first column
-        // Advance iterator to next column of matrix
-        it = compute_hess(it, x);
+    // Evaluates f with the tangents of x set to the ith unit vector.
+    value_t run_unit(size_t i)
+    {
+        return run(vector_t::Unit(x_.size(), i));
     }
-}
 
-} // namespace core
+    /*
+     * Outputs are taken by const reference so that blocks (e.g. H.col(j)) can be passed
+     * (see "Writing Functions Taking Eigen Types as Parameters" in the Eigen documentation).
+     */
 
-// The function will store only the hessian into object pointed by hess_begin.
-// This overload will only be enabled if all of the iterators
-// are dereferenceable like a pointer, i.e., valid iterators.
-// @param   hess_begin  column-wise iterator of a 2d-array or matrix to store hessian
-// @param   begin       iterator to first underlying data
-// @param   end         iterator to one past last underlying data
-// @param   f           lambda function to compute hessian and gradient of
-//                      it is expected that the arguments follow the specs of exgen
-//                      and in addition are declared with auto or Vec<ForwardVar<T>> for some T.
-template <size_t... opt_sizes, class HessIter, class Iter, class F
-    , class = std::enable_if_t<
-    utils::is_pointer_like_dereferenceable<HessIter>::value &&
-    utils::is_pointer_like_dereferenceable<Iter>::value
-    >
->
-inline void hessian(HessIter hess_begin, Iter begin, Iter end, F&& f)
-{
-    using T = typename std::iterator_traits<Iter>::value_type;
-    auto gen = make_exgen<ForwardVar<T>>(std::forward<F>(f));
-    Vec<ForwardVar<T>> x(begin, end);
-    core::hessian_gen<opt_sizes...>(hess_begin, x, gen);
-}
+    // Writes the gradient of f from the last run into g.
+    template <class Derived>
+    void gradient(const Eigen::MatrixBase<Derived>& g_) const
+    {
+        auto& g = const_cast<Eigen::MatrixBase<Derived>&>(g_);
+        const auto& adj = x_.get_adj();
+        for (int i = 0; i < adj.size(); ++i) g(i) = adj(i).get_value();
+    }
+
+    // Writes H * v from the last run into hv.
+    template <class Derived>
+    void hessian_vector(const Eigen::MatrixBase<Derived>& hv_) const
+    {
+        auto& hv = const_cast<Eigen::MatrixBase<Derived>&>(hv_);
+        const auto& adj = x_.get_adj();
+        for (int i = 0; i < adj.size(); ++i) hv(i) = adj(i).get_adjoint();
+    }
 
-// The function will store the hessian into object pointed by hess_begin,
-// and store gradient as well into object pointed by grad_begin.
-// This overload will only be enabled if all of the iterators
-// are dereferenceable like a pointer, i.e., valid iterators.
-// @param   hess_begin  column-wise iterator of a 2d-array or matrix to store hessian
-// @param   grad_begin  iterator of a array or 1-d matrix to store gradient
-// @param   begin       iterator to first underlying data
-// @param   end         iterator to one past last underlying data
-// @param   f           lambda function to compute hessian and gradient of
-//                      it is expected that the arguments follow the specs of exgen
-//                      and in addition are declared with auto or Vec<ForwardVar<T>> for some T.
-template <size_t... opt_sizes, class HessIter, class GradIter, class Iter, class F
-    , class = std::enable_if_t<
-    utils::is_pointer_like_dereferenceable<HessIter>::value &&
-    utils::is_pointer_like_dereferenceable<GradIter>::value &&
-    utils::is_pointer_like_dereferenceable<Iter>::value
-    > >
-inline void hessian(HessIter hess_begin, GradIter grad_begin, Iter begin, Iter end, F&& f)
+private:
+    fvar_t x_;
+    expr_t expr_;
+};
+
+} // namespace core
+
+/**
+ * Computes the Hessian of f at x by forward-over-reverse,
+ * one forward and backward evaluation per column.
+ *
+ * f is called with a vector Var x (Var<ForwardVar<T>, vec>) and must return
+ * a scalar expression of x, e.g.
+ *
+ *      auto H = ad::hessian([](auto& x) {
+ *          return ad::sum(x * x) + ad::sin(x[0] * x[1]);
+ *      }, x0);
+ *
+ * Any expression and any function of reverse/core can be used.
+ * Elements and segments of x are x[i], x.head(n) and x.tail(n).
+ *
+ * @param   f       functor creating the scalar expression
+ * @param   x       point at which the Hessian is computed
+ * @return  Hessian as a dense matrix
+ */
+template <class F, class Derived>
+inline auto hessian(F&& f, const Eigen::MatrixBase<Derived>& x)
 {
-    using T = typename std::iterator_traits<Iter>::value_type;
-    auto gen = make_exgen<ForwardVar<T>>(std::forward<F>(f));
-    Vec<ForwardVar<T>> x(begin, end);
-    core::hessian_gen<opt_sizes...>(hess_begin, grad_begin, x, gen);
+    using value_t = typename Derived::Scalar;
+    size_t n = x.size();
+    Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic> H(n, n);
+    core::HessianWorker<value_t, std::remove_reference_t<F>> worker(f, x);
+    for (size_t j = 0; j < n; ++j) {
+        worker.run_unit(j);
+        worker.hessian_vector(H.col(j));
+    }
+    return H;
 }
 
-template <size_t... opt_sizes, class Matrix_T, class Iter, class F>
-inline void hessian(Mat<Matrix_T>& hess_mat, Iter begin, Iter end, F&& f)
+/**
+ * Same as hessian(f, x) but computes the columns in parallel.
+ * Every thread calls f once to create its own expression bound to its own cache,
+ * so f must be safe to call concurrently.
+ * The result does not depend on the number of threads.
+ *
+ * @param   policy  parallel policy (see ad::par)
+ */
+template <class F, class Derived>
+inline auto hessian(const ParallelPolicy& policy,
+                    F&& f,
+                    const Eigen::MatrixBase<Derived>& x)
 {
-    const size_t n = static_cast<size_t>(std::distance(begin, end));
-    hess_mat.zeros(n, n);
-    hessian<opt_sizes...>(hess_mat.begin(), begin, end, std::forward<F>(f));
+    using value_t = typename Derived::Scalar;
+    size_t n = x.size();
+    Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic> H(n, n);
+    size_t n_threads = policy.n_threads();
+    policy.pool->run([&](size_t id) {
+        if (id >= n) return;
+        core::HessianWorker<value_t, std::remove_reference_t<F>> worker(f, x);
+        for (size_t j = id; j < n; j += n_threads) {
+            worker.run_unit(j);
+            worker.hessian_vector(H.col(j));
+        }
+    });
+    return H;
 }
 
-template <size_t... opt_sizes, class Matrix_T, class F, class Iter>
-inline void hessian(Mat<Matrix_T>& hess_mat, Mat<Matrix_T>& grad_mat, Iter begin, Iter end, F&& f)
+/**
+ * Computes the Hessian-vector product H * v of f at x with a single
+ * forward and backward evaluation (see hessian(f, x) for the requirements on f).
+ *
+ * @param   f       functor creating the scalar expression
+ * @param   x       point at which the Hessian is computed
+ * @param   v       direction
+ * @return  H * v as a dense vector
+ */
+template <class F, class Derived1, class Derived2>
+inline auto hessian_vector(F&& f,
+                           const Eigen::MatrixBase<Derived1>& x,
+                           const Eigen::MatrixBase<Derived2>& v)
 {
-    const size_t n = static_cast<size_t>(std::distance(begin, end));
-    hess_mat.zeros(n, n);
-    grad_mat.zeros(1, n);
-    hessian<opt_sizes...>(hess_mat.begin(), grad_mat.begin(), begin, end, std::forward<F>(f));
+    using value_t = typename Derived1::Scalar;
+    Eigen::Matrix<value_t, Eigen::Dynamic, 1> hv(x.size());
+    core::HessianWorker<value_t, std::remove_reference_t<F>> worker(f, x);
+    worker.run(v);
+    worker.hessian_vector(hv);
+    return hv;
 }
 
 } // namespace ad
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
@@ -18,6 +20,7 @@ namespace core {
  *
  * Both if and else expressions must have same value and shape type.
  * Currently, condition expression can only be a scalar.
+ * The two branches share their cache since only one is evaluated at a time.
  *
  * @tparam  CondExprType    type of condition expression
  * @tparam  IfExprType      type of expression in if-statement
@@ -91,23 +94,43 @@ public:
         } 
     }
 
+    /**
+     * Binds the condition, which is never backward evaluated
+     * (see details::ForwardOnlyScope), then binds both branches from the same pointers
+     * since only one of them is evaluated in a forward and backward evaluation.
+     *
+     * @return  next pointer pack not bound by the condition or either branch.
+     */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        begin = cond_expr_.bind_cache(begin);
-        begin = if_expr_.bind_cache(begin);
-        return else_expr_.bind_cache(begin);
+        {
+            details::ForwardOnlyScope scope;
+            begin = cond_expr_.bind_cache(begin);
+        }
+        auto if_next = if_expr_.bind_cache(begin);
+        auto else_next = else_expr_.bind_cache(begin);
+        return {std::max(if_next.val, else_next.val),
+                std::max(if_next.adj, else_next.adj)};
     }
 
     util::SizePack bind_cache_size() const 
     { 
         return cond_expr_.bind_cache_size() +
-                if_expr_.bind_cache_size() + 
-                else_expr_.bind_cache_size();
+                if_expr_.bind_cache_size().max(
+                        else_expr_.bind_cache_size());
     }
 
     util::SizePack single_bind_cache_size() const
     { return {0,0}; }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        cond_expr_.visit(v);
+        if_expr_.visit(v);
+        else_expr_.visit(v);
+    }
+
 private:
     cond_t cond_expr_;
     if_t if_expr_;
@@ -129,8 +152,8 @@ inline constexpr auto if_else(const CondType& c,
                               const ElseType& e)
 {
     using cond_t = util::convert_to_ad_t<CondType>;
-    using if_t = util::convert_to_ad_t<IfType>;
-    using else_t = util::convert_to_ad_t<ElseType>;
+    using if_t = util::convert_to_ad_like_t<IfType, ElseType, CondType>;
+    using else_t = util::convert_to_ad_like_t<ElseType, IfType, CondType>;
     using if_value_t = typename util::expr_traits<if_t>::value_t;
     using if_shape_t = typename util::shape_traits<if_t>::shape_t;
 
@@ -0,0 +1,309 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <Eigen/Core>
+#include <fastad_bits/forward/core/jacobian.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/lanes.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+/*
+ * Visitor that sets the adjoints of every leaf and placeholder to 0
+ * so that an expression can be backward evaluated again with a new seed.
+ */
+struct AdjResetter
+{
+    template <class VarViewType>
+    void read(VarViewType& v) { reset(v); }
+
+    template <class VarViewType>
+    void write(VarViewType& v) { reset(v); }
+
+    template <class VarViewType>
+    static void reset(VarViewType& v)
+    {
+        using value_t = std::decay_t<decltype(*v.data_adj())>;
+        std::fill_n(v.data_adj(), v.size(), value_t(0));
+    }
+};
+
+/*
+ * Seed type of a backward evaluation of an expression with value type V:
+ * V if the expression is a scalar and an array of V of the same shape otherwise.
+ */
+template <class ExprType, class V>
+using jacobian_seed_t = std::conditional_t<
+    util::is_scl_v<ExprType>, V,
+    std::conditional_t<util::is_vec_v<ExprType>,
+        Eigen::Array<V, Eigen::Dynamic, 1>,
+        Eigen::Array<V, Eigen::Dynamic, Eigen::Dynamic>>>;
+
+} // namespace details
+
+/**
+ * JacobianWorker computes blocks of K rows or K columns of the Jacobian of
+ * an expression f(x) of a vector Var x.
+ *
+ * In reverse mode, f(x) is built with Lanes<T, K> values
+ * and the seed of lane l is the unit vector of output i + l,
+ * so that one forward and backward evaluation computes K rows at once
+ * with every adjoint holding its K rows contiguously.
+ * Nodes still compute lane-wise: this saves sweeps over the expression,
+ * not arithmetic, and matrix products (DotNode) are not turned into matrix-matrix products.
+ * In forward mode, f(x) is built with ForwardVar<T, K> values
+ * and the tangents of x are K unit vectors,
+ * so that one forward evaluation computes K columns at once.
+ *
+ * @tparam  T       underlying value type
+ * @tparam  K       number of rows (reverse) or columns (forward) per evaluation
+ * @tparam  F       functor that creates the expression from a vector Var x
+ * @tparam  Forward true for forward mode
+ */
+
+template <class T, int K, class F, bool Forward>
+struct JacobianWorker
+{
+    using value_t = T;
+    using wvalue_t = std::conditional_t<Forward,
+                                        ForwardVar<value_t, K>,
+                                        Lanes<value_t, K>>;
+    using wvar_t = Var<wvalue_t, ad::vec>;
+    using expr_t = std::decay_t<decltype(ad::bind(
+                std::declval<F&>()(std::declval<wvar_t&>())))>;
+    using seed_t = details::jacobian_seed_t<typename expr_t::expr_t, wvalue_t>;
+
+    template <class Derived>
+    JacobianWorker(F& f, const Eigen::MatrixBase<Derived>& x)
+        : x_(x.size())
+        , expr_(ad::bind(f(x_)))
+    {
+        for (int i = 0; i < x.size(); ++i) {
+            x_.get()(i) = wvalue_t(x(i));
+        }
+    }
+
+    size_t n_inputs() const { return x_.size(); }
+    size_t n_outputs() const { return expr_.get().size(); }
+
+    /**
+     * Reverse mode: writes the rows [begin, begin + K) of the Jacobian
+     * (truncated to the number of outputs) into the corresponding rows of J.
+     */
+    template <class Derived>
+    void rows(size_t begin, const Eigen::MatrixBase<Derived>& J_)
+    {
+        auto& J = const_cast<Eigen::MatrixBase<Derived>&>(J_);
+        size_t m = n_outputs();
+        size_t k = std::min<size_t>(K, m - begin);
+        vjp(Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>::Identity(m, m)
+                .middleCols(begin, k),
+            J.middleRows(begin, k));
+    }
+
+    /**
+     * Forward mode: writes the columns [begin, begin + K) of the Jacobian
+     * (truncated to the number of inputs) into the corresponding columns of J.
+     */
+    template <class Derived>
+    void cols(size_t begin, const Eigen::MatrixBase<Derived>& J_)
+    {
+        auto& J = const_cast<Eigen::MatrixBase<Derived>&>(J_);
+        size_t n = n_inputs();
+        size_t k = std::min<size_t>(K, n - begin);
+        jvp(Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>::Identity(n, n)
+                .middleCols(begin, k),
+            J.middleCols(begin, k));
+    }
+
+    /**
+     * Reverse mode: computes W^T J for the (at most K) columns of W
+     * as seeds of the outputs (column-major if f(x) is a matrix)
+     * with one forward and backward evaluation.
+     *
+     * @param   W   n_outputs x k seeds
+     * @param   WJ  k x n_inputs output
+     */
+    template <class Derived1, class Derived2>
+    void vjp(const Eigen::MatrixBase<Derived1>& W,
+             const Eigen::MatrixBase<Derived2>& WJ_)
+    {
+        static_assert(!Forward);
+        auto& WJ = const_cast<Eigen::MatrixBase<Derived2>&>(WJ_);
+        auto& root = expr_.get();
+        const int k = W.cols();
+        assert(k <= K);
+
+        seed_t seed;
+        if constexpr (util::is_scl_v<typename expr_t::expr_t>) {
+            for (int l = 0; l < k; ++l) seed[l] = W(0, l);
+        } else {
+            seed.setZero(root.rows(), root.cols());
+            for (int i = 0; i < W.rows(); ++i) {
+                for (int l = 0; l < k; ++l) seed(i)[l] = W(i, l);
+            }
+        }
+
+        details::AdjResetter r;
+        root.visit(r);
+        ad::autodiff(expr_, seed);
+
+        const auto& adj = x_.get_adj();
+        for (int j = 0; j < adj.size(); ++j) {
+            for (int l = 0; l < k; ++l) WJ(l, j) = adj(j)[l];
+        }
+    }
+
+    /**
+     * Forward mode: computes J S for the (at most K) columns of S
+     * as tangents of x with one forward evaluation.
+     *
+     * @param   S   n_inputs x k directions
+     * @param   JS  n_outputs x k output
+     */
+    template <class Derived1, class Derived2>
+    void jvp(const Eigen::MatrixBase<Derived1>& S,
+             const Eigen::MatrixBase<Derived2>& JS_)
+    {
+        static_assert(Forward);
+        auto& JS = const_cast<Eigen::MatrixBase<Derived2>&>(JS_);
+        auto& x = x_.get();
+        const int k = S.cols();
+        assert(k <= K);
+        for (int j = 0; j < x.size(); ++j) {
+            if constexpr (K == 1) {
+                x(j).set_adjoint((k > 0) ? value_t(S(j, 0)) : value_t(0));
+            } else {
+                auto& df = x(j).get_adjoint();
+                df.setZero();
+                for (int l = 0; l < k; ++l) df(l) = S(j, l);
+            }
+        }
+
+        auto& root = expr_.get();
+        ad::evaluate(expr_);
+        const wvalue_t* y = root.data();
+        for (size_t i = 0; i < root.size(); ++i) {
+            for (int l = 0; l < k; ++l) JS(i, l) = details::get_tangent(y[i], l);
+        }
+    }
+
+private:
+    wvar_t x_;
+    expr_t expr_;
+};
+
+} // namespace core
+
+/**
+ * Computes the Jacobian of f at x, where f is called with a vector Var x
+ * and returns an expression of x of any shape, e.g.
+ *
+ *      auto J = ad::jacobian([](auto& x) {
+ *          return ad::exp(x) * x[0] + ad::sum(x);
+ *      }, x0);
+ *
+ * The rows of J are the outputs (column-major if f(x) is a matrix) and the columns are the inputs.
+ * Forward mode is used if there are at most as many inputs as outputs
+ * and reverse mode otherwise.
+ * Either way, K rows or columns are computed per evaluation (see JacobianWorker),
+ * so that the Jacobian takes ceil(min(n_inputs, n_outputs) / K) evaluations.
+ *
+ * f is called twice (once with a Var<T, vec> to find the number of outputs
+ * and once for the chosen mode) and must not depend on the values of x.
+ * Non-scalar constants in f must have the value type of x,
+ * i.e. typename std::decay_t<decltype(x)>::value_t.
+ * Matrix products with Lanes values use Eigen's generic product,
+ * so expressions dominated by ad::dot gain nothing from K > 1
+ * and can be slower than one row per sweep (see jacobian_benchmark).
+ *
+ * @tparam  K   number of rows or columns per evaluation
+ * @param   f   functor creating the expression
+ * @param   x   point at which the Jacobian is computed
+ * @return  Jacobian as a dense matrix
+ */
+template <int K = 4, class F, class Derived>
+inline auto jacobian(F&& f, const Eigen::MatrixBase<Derived>& x)
+{
+    using value_t = typename Derived::Scalar;
+    using f_t = std::remove_reference_t<F>;
+    Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic> J;
+    size_t n = x.size();
+
+    // the number of outputs is known from the unbound expression
+    Var<value_t, ad::vec> x_probe(n);
+    size_t m = f(x_probe).size();
+    J.resize(m, n);
+
+    if (n <= m) {
+        core::JacobianWorker<value_t, K, f_t, true> fworker(f, x);
+        for (size_t j = 0; j < n; j += K) fworker.cols(j, J);
+    } else {
+        core::JacobianWorker<value_t, K, f_t, false> rworker(f, x);
+        for (size_t i = 0; i < m; i += K) rworker.rows(i, J);
+    }
+    return J;
+}
+
+/**
+ * Computes the Jacobian of a bound expression with respect to the given leaves
+ * by reverse mode, one forward and backward evaluation per output.
+ * The values and adjoints of expr have a single lane, so outputs are not blocked;
+ * use jacobian<K>(f, x) to push K seeds per sweep.
+ * The forward evaluation is repeated since backward evaluation may overwrite values
+ * (e.g. checkpoints recompute steps in a shared cache).
+ * The adjoints of every leaf and placeholder of expr are reset before every evaluation,
+ * so no manual reset is needed; the adjoints of the leaves hold the last row afterwards.
+ *
+ * The rows of J are the outputs (column-major if expr is a matrix) and the columns are
+ * the elements of the leaves in the order they are given (column-major for matrices).
+ *
+ * @param   expr    bound expression
+ * @param   leaves  variables (Var or VarView) to differentiate with respect to
+ * @return  Jacobian as a dense matrix
+ */
+template <class ExprType, class... Leaves>
+inline auto jacobian(core::ExprBind<ExprType>& expr, Leaves&... leaves)
+{
+    using value_t = typename core::ExprBind<ExprType>::value_t;
+    using seed_t = core::details::jacobian_seed_t<ExprType, value_t>;
+    auto& root = expr.get();
+    size_t m = root.size();
+    size_t n = (0 + ... + leaves.size());
+    Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic> J(m, n);
+
+    seed_t seed;
+    if constexpr (!util::is_scl_v<ExprType>) {
+        seed.setZero(root.rows(), root.cols());
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+        if constexpr (util::is_scl_v<ExprType>) {
+            seed = 1;
+        } else {
+            if (i > 0) seed(i-1) = 0;
+            seed(i) = 1;
+        }
+        core::details::AdjResetter r;
+        root.visit(r);
+        ad::autodiff(expr, seed);
+
+        size_t offset = 0;
+        ([&](const auto& leaf) {
+            for (size_t j = 0; j < leaf.size(); ++j) {
+                J(i, offset + j) = leaf.data_adj()[j];
+            }
+            offset += leaf.size();
+        }(leaves), ...);
+    }
+    return J;
+}
+
+} // namespace ad
@@ -0,0 +1,156 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+#include <Eigen/Core>
+#include <unsupported/Eigen/SpecialFunctions>       // needed for erf
+
+namespace ad {
+
+/**
+ * Lanes is a value type that holds W independent values (lanes) of type T
+ * and applies every arithmetic operation and mathematical function lane-wise.
+ * It is backed by a fixed-size Eigen array so that operations compile
+ * to SIMD instructions when the target's vector extensions are enabled (e.g. -march=native)
+ * and W * sizeof(T) is a multiple of the vector width.
+ *
+ * Using Lanes as the value type of an expression (e.g. Var<Lanes<double, 4>>)
+ * evaluates W independent inputs in one forward and backward sweep.
+ * Leaves that differ per input hold one input per lane.
+ * Leaves that are shared by all inputs (e.g. parameters) hold the same value
+ * in every lane (Lanes(x) broadcasts x) and their adjoint holds
+ * the contribution of every input in its own lane.
+ * The total adjoint of a shared leaf is the sum over lanes, i.e. adj.sum().
+ *
+ * Only lane-wise operations are supported (arithmetic, unary functions, sum, for_each, etc.).
+ * Ordering comparisons are not, since they do not reduce to a single bool.
+ * Equality compares every lane (it is needed by Eigen's matrix products, e.g. in DotNode).
+ *
+ * @tparam  T   underlying value type of every lane
+ * @tparam  W   number of lanes
+ */
+
+template <class T, int W>
+struct Lanes
+{
+    using scalar_t = T;
+    using array_t = Eigen::Array<T, W, 1>;
+    static constexpr int width = W;
+
+    Lanes()
+        : arr_(array_t::Zero())
+    {}
+
+    // broadcasts x to every lane
+    Lanes(const T& x)
+        : arr_(array_t::Constant(x))
+    {}
+
+    template <class Derived>
+    explicit Lanes(const Eigen::ArrayBase<Derived>& x)
+        : arr_(x)
+    {}
+
+    T& operator[](int i) { return arr_(i); }
+    const T& operator[](int i) const { return arr_(i); }
+
+    array_t& array() { return arr_; }
+    const array_t& array() const { return arr_; }
+
+    /**
+     * Reduces the lanes by summation.
+     * This is the total adjoint of a leaf shared by every lane.
+     */
+    T sum() const { return arr_.sum(); }
+
+    Lanes& operator+=(const Lanes& x) { arr_ += x.arr_; return *this; }
+    Lanes& operator-=(const Lanes& x) { arr_ -= x.arr_; return *this; }
+    Lanes& operator*=(const Lanes& x) { arr_ *= x.arr_; return *this; }
+    Lanes& operator/=(const Lanes& x) { arr_ /= x.arr_; return *this; }
+
+    friend Lanes operator-(const Lanes& x) { return Lanes(-x.arr_); }
+
+    friend Lanes operator+(const Lanes& x, const Lanes& y) { return Lanes(x.arr_ + y.arr_); }
+    friend Lanes operator+(const Lanes& x, const T& y) { return Lanes(x.arr_ + y); }
+    friend Lanes operator+(const T& x, const Lanes& y) { return Lanes(x + y.arr_); }
+
+    friend Lanes operator-(const Lanes& x, const Lanes& y) { return Lanes(x.arr_ - y.arr_); }
+    friend Lanes operator-(const Lanes& x, const T& y) { return Lanes(x.arr_ - y); }
+    friend Lanes operator-(const T& x, const Lanes& y) { return Lanes(x - y.arr_); }
+
+    friend Lanes operator*(const Lanes& x, const Lanes& y) { return Lanes(x.arr_ * y.arr_); }
+    friend Lanes operator*(const Lanes& x, const T& y) { return Lanes(x.arr_ * y); }
+    friend Lanes operator*(const T& x, const Lanes& y) { return Lanes(x * y.arr_); }
+
+    friend Lanes operator/(const Lanes& x, const Lanes& y) { return Lanes(x.arr_ / y.arr_); }
+    friend Lanes operator/(const Lanes& x, const T& y) { return Lanes(x.arr_ / y); }
+    friend Lanes operator/(const T& x, const Lanes& y) { return Lanes(x / y.arr_); }
+
+    friend bool operator==(const Lanes& x, const Lanes& y) { return (x.arr_ == y.arr_).all(); }
+    friend bool operator!=(const Lanes& x, const Lanes& y) { return !(x == y); }
+
+private:
+    array_t arr_;
+};
+
+/*
+ * Defines lane-wise unary function f on Lanes
+ * using the corresponding Eigen array function "eigen_f".
+ * These are found by argument-dependent lookup from the unary functors (see UNARY_STRUCT).
+ */
+#define LANES_UNARY_FUNC(f, eigen_f) \
+template <class T, int W> \
+inline Lanes<T, W> f(const Lanes<T, W>& x) \
+{ \
+    return Lanes<T, W>(x.array().eigen_f()); \
+}
+
+LANES_UNARY_FUNC(sin, sin)
+LANES_UNARY_FUNC(cos, cos)
+LANES_UNARY_FUNC(tan, tan)
+LANES_UNARY_FUNC(asin, asin)
+LANES_UNARY_FUNC(acos, acos)
+LANES_UNARY_FUNC(atan, atan)
+LANES_UNARY_FUNC(exp, exp)
+LANES_UNARY_FUNC(log, log)
+LANES_UNARY_FUNC(sqrt, sqrt)
+LANES_UNARY_FUNC(erf, erf)
+LANES_UNARY_FUNC(abs, abs)
+
+#undef LANES_UNARY_FUNC
+
+} // namespace ad
+
+namespace std {
+
+// Lanes<T, W> is the common type of Lanes<T, W> and T (see BinaryNode).
+template <class T, int W>
+struct common_type<ad::Lanes<T, W>, T> { using type = ad::Lanes<T, W>; };
+
+template <class T, int W>
+struct common_type<T, ad::Lanes<T, W>> { using type = ad::Lanes<T, W>; };
+
+} // namespace std
+
+namespace Eigen {
+
+// Allows Lanes as the scalar type of Eigen containers (e.g. vector and matrix Var).
+template <class T, int W>
+struct NumTraits<ad::Lanes<T, W>> : GenericNumTraits<ad::Lanes<T, W>>
+{
+    using Real = ad::Lanes<T, W>;
+    using NonInteger = ad::Lanes<T, W>;
+    using Nested = ad::Lanes<T, W>;
+    using Literal = T;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = W * NumTraits<T>::ReadCost,
+        AddCost = W * NumTraits<T>::AddCost,
+        MulCost = W * NumTraits<T>::MulCost
+    };
+};
+
+} // namespace Eigen
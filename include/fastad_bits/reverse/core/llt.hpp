@@ -0,0 +1,322 @@
+#pragma once
+#include <type_traits>
+#include <Eigen/Cholesky>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/share.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/numeric.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * LLTNode represents a symmetric positive definite matrix
+ * together with its Cholesky factorization.
+ * Its value is the value of the matrix expression
+ * and it factors the matrix once per forward evaluation.
+ * Backward evaluation passes the seed to the expression unchanged.
+ *
+ * LLTNode is not used directly, but through ad::llt,
+ * which shares it (see SharedNode) so that every node using it
+ * (ad::det, ad::log_det, ad::inv_quad_form, ad::normal_adj_log_pdf,
+ * ad::wishart_adj_log_pdf) reads the same factor
+ * instead of factoring the matrix again.
+ *
+ * @tparam  ExprType    type of matrix expression
+ */
+
+template <class ExprType>
+struct LLTNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t, ad::mat>,
+    ExprBase<LLTNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+
+    static_assert(util::is_mat_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t, ad::mat>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    using llt_t = Eigen::LLT<mat_t, Eigen::Lower>;
+
+    LLTNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_{expr}
+        , llt_(expr.rows())
+    {
+        assert(expr.rows() == expr.cols());
+    }
+
+    const var_t& feval()
+    {
+        this->get() = expr_.feval();
+        llt_.compute(this->get());
+        return this->get();
+    }
+
+    template <class T>
+    void beval(const T& seed)
+    {
+        expr_.beval(seed);
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = expr_.bind_cache(begin);
+        auto adj = begin.adj;
+        begin.adj = nullptr;
+        begin = value_adj_view_t::bind(begin);
+        begin.adj = adj;
+        return begin;
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return expr_.bind_cache_size() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), 0};
+    }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
+    const llt_t& llt() const { return llt_; }
+
+private:
+    expr_t expr_;
+    llt_t llt_;
+};
+
+namespace details {
+
+/*
+ * Checks if T is the type returned by ad::llt.
+ */
+template <class T>
+struct is_llt : std::false_type {};
+
+template <class ExprType>
+struct is_llt<SharedNode<LLTNode<ExprType>>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_llt_v = is_llt<T>::value;
+
+/*
+ * LLTCache is the Cholesky factor used by a node:
+ * either its own factorization of a matrix
+ * or a view of the factor of an ad::llt expression.
+ */
+template <class ValueType>
+struct LLTCache
+{
+    using value_t = ValueType;
+    using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    using llt_t = Eigen::LLT<mat_t, Eigen::Lower>;
+
+    LLTCache(size_t rows)
+        : llt_(rows)
+    {}
+
+    // Factors X.
+    template <class Derived>
+    void compute(const Eigen::MatrixBase<Derived>& X)
+    {
+        llt_.compute(X);
+        shared_ = nullptr;
+    }
+
+    // Views the factor of another node.
+    void share(const llt_t& llt) { shared_ = &llt; }
+
+    /*
+     * Factors the value of expr unless it is an ad::llt expression,
+     * in which case its factor is viewed.
+     * It is assumed that expr is forward evaluated.
+     */
+    template <class ExprType>
+    void update(const ExprType& expr)
+    {
+        if constexpr (is_llt_v<ExprType>) share(expr.expr().llt());
+        else compute(expr.get());
+    }
+
+    const llt_t& get() const { return shared_ ? *shared_ : llt_; }
+
+    bool valid() const { return get().info() == Eigen::Success; }
+
+    // log of the determinant of the factor, i.e. half the log determinant of X
+    value_t log_det_factor() const
+    {
+        return get().matrixLLT().diagonal().array().log().sum();
+    }
+
+private:
+    llt_t llt_;
+    const llt_t* shared_ = nullptr;
+};
+
+} // namespace details
+
+/**
+ * InvQuadFormNode represents the quadratic form x^T S^{-1} x
+ * of a symmetric positive definite matrix S and a vector x.
+ * S is factored (or its ad::llt factor reused) and S^{-1} x is computed
+ * by triangular solves, so no inverse is formed in the forward evaluation.
+ * The value is infinite if S is not positive definite.
+ *
+ * @tparam  SigmaExprType   type of matrix expression
+ * @tparam  XExprType       type of vector expression
+ */
+
+template <class SigmaExprType, class XExprType>
+struct InvQuadFormNode:
+    ValueAdjView<typename util::expr_traits<XExprType>::value_t, ad::scl>,
+    ExprBase<InvQuadFormNode<SigmaExprType, XExprType>>
+{
+private:
+    using sigma_t = SigmaExprType;
+    using x_t = XExprType;
+    using expr_value_t = typename util::expr_traits<x_t>::value_t;
+
+    static_assert(util::is_mat_v<sigma_t>);
+    static_assert(util::is_vec_v<x_t>);
+    static_assert(std::is_same_v<
+            typename util::expr_traits<sigma_t>::value_t, expr_value_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t, ad::scl>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    InvQuadFormNode(const sigma_t& sigma,
+                    const x_t& x)
+        : value_adj_view_t(nullptr, nullptr, 1, 1)
+        , sigma_{sigma}
+        , x_{x}
+        , llt_(sigma.rows())
+        , z_(x.rows())
+    {
+        assert(sigma.rows() == sigma.cols());
+        assert(sigma.rows() == x.rows());
+    }
+
+    const var_t& feval()
+    {
+        sigma_.feval();
+        auto&& x = x_.feval();
+        llt_.update(sigma_);
+        if (!llt_.valid()) {
+            return this->get() = util::inf<value_t>;
+        }
+        z_ = llt_.get().solve(x);
+        return this->get() = x.dot(z_);
+    }
+
+    void beval(value_t seed)
+    {
+        if (seed == 0 || !llt_.valid()) return;
+        x_.beval((2 * seed) * z_.array());
+        sigma_.beval(((-seed) * z_ * z_.transpose()).array());
+    }
+
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        begin = sigma_.bind_cache(begin);
+        begin = x_.bind_cache(begin);
+        auto adj = begin.adj;
+        begin.adj = nullptr;
+        begin = value_adj_view_t::bind(begin);
+        begin.adj = adj;
+        return begin;
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return sigma_.bind_cache_size() +
+                x_.bind_cache_size() +
+                single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    {
+        return {this->size(), 0};
+    }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        sigma_.visit(v);
+        x_.visit(v);
+    }
+
+private:
+    using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+
+    sigma_t sigma_;
+    x_t x_;
+    details::LLTCache<value_t> llt_;
+    vec_t z_;
+};
+
+} // namespace core
+
+/**
+ * Creates the Cholesky factorization of a symmetric positive definite
+ * matrix expression x, shared by all copies of the result (see LLTNode).
+ * The result is a matrix expression with the same value as x.
+ * Ex.
+ *
+ *      auto S = ad::llt(sigma);
+ *      auto expr = ad::normal_adj_log_pdf(y, mu, S) + ad::log_det(S);
+ *
+ * factors sigma once per forward evaluation.
+ */
+template <class T
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T> &&
+            util::any_ad_v<T> > >
+inline auto llt(const T& x)
+{
+    using expr_t = util::convert_to_ad_t<T>;
+    expr_t expr = x;
+    return ad::share(core::LLTNode<expr_t>(expr));
+}
+
+/**
+ * Creates the quadratic form x^T S^{-1} x (see InvQuadFormNode).
+ */
+template <class T1
+        , class T2
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<T1> &&
+            util::is_convertible_to_ad_v<T2> &&
+            util::any_ad_v<T1, T2> > >
+inline auto inv_quad_form(const T1& sigma,
+                          const T2& x)
+{
+    using sigma_expr_t = util::convert_to_ad_t<T1>;
+    using x_expr_t = util::convert_to_ad_t<T2>;
+    sigma_expr_t sigma_expr = sigma;
+    x_expr_t x_expr = x;
+    return core::InvQuadFormNode<sigma_expr_t, x_expr_t>(sigma_expr, x_expr);
+}
+
+} // namespace ad
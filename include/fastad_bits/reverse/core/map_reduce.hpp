@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/data_slot.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/parallel.hpp>
+#include <fastad_bits/reverse/core/var_view.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * MapReduceWorker evaluates f(row, w) over a range of rows of a dataset
+ * and accumulates the values and the gradients with respect to w.
+ *
+ * A worker owns a DataSlot of the current row
+ * and a view w of the parameters that shares their values
+ * but accumulates into the worker's own adjoints.
+ * The slot views the rows of the data in place when they are contiguous
+ * and of the parameters' value type (row-major data, or the transpose
+ * of column-major data with one observation per column).
+ * Otherwise every row is copied into a buffer viewed by the slot.
+ * The expression is bound once to the worker's own cache,
+ * so that workers can run concurrently.
+ *
+ * @tparam  T       underlying value type
+ * @tparam  Shape   shape of the parameters
+ * @tparam  F       functor that creates the scalar expression from a row and w
+ */
+
+template <class T, class Shape, class F>
+struct MapReduceWorker
+{
+    using value_t = T;
+    using row_t = DataSlot<value_t, ad::vec>;
+    using param_t = VarView<value_t, Shape>;
+    using vector_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+    using expr_t = std::decay_t<decltype(ad::bind(
+                std::declval<F&>()(std::declval<row_t&>(),
+                                   std::declval<param_t&>())))>;
+
+    template <class ParamType>
+    MapReduceWorker(F& f, size_t n_cols, ParamType& params)
+        : adj_(vector_t::Zero(params.size()))
+        , row_(nullptr, n_cols, 1)
+        , w_(const_cast<value_t*>(params.data()), adj_.data(),
+             params.rows(), params.cols())
+        , expr_(ad::bind(f(row_, w_)))
+    {}
+
+    /**
+     * Evaluates f on every row of data in [begin, end)
+     * and adds the values and gradients to the worker's totals.
+     */
+    template <class Derived>
+    void run(const Eigen::MatrixBase<Derived>& data, size_t begin, size_t end)
+    {
+        if constexpr (is_row_contiguous_v<Derived>) {
+            if (data.derived().innerStride() == 1) {
+                const value_t* row = data.derived().data();
+                size_t stride = data.derived().outerStride();
+                for (size_t i = begin; i < end; ++i) {
+                    row_.set_data(row + i * stride);
+                    value_ += ad::autodiff(expr_);
+                }
+                return;
+            }
+        }
+        row_buf_.resize(row_.size());
+        row_.set_data(row_buf_.data());
+        for (size_t i = begin; i < end; ++i) {
+            row_buf_ = data.row(i).transpose().template cast<value_t>();
+            value_ += ad::autodiff(expr_);
+        }
+    }
+
+    value_t value() const { return value_; }
+
+    // Adds the accumulated gradient to the adjoints of params.
+    template <class ParamType>
+    void add_adj_to(ParamType& params) const
+    {
+        Eigen::Map<vector_t>(params.data_adj(), params.size()) += adj_;
+    }
+
+private:
+    // rows of Derived are contiguous arrays of value_t up to the inner stride
+    template <class Derived>
+    static constexpr bool is_row_contiguous_v =
+        std::is_same_v<typename Derived::Scalar, value_t> &&
+        bool(Derived::Flags & Eigen::RowMajorBit) &&
+        bool(Derived::Flags & Eigen::DirectAccessBit);
+
+    vector_t row_buf_;      // copy of the current row if it cannot be viewed
+    vector_t adj_;
+    value_t value_ = 0;
+    row_t row_;
+    param_t w_;
+    expr_t expr_;
+};
+
+} // namespace core
+
+/**
+ * Computes the sum over the rows of data of f(row, w),
+ * where w views the parameters params,
+ * and adds its gradient to the adjoints of params, e.g.
+ *
+ *      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+ *          data(n, p + 1);             // rows (x, y)
+ *      VarView<double, mat> params(theta.data(), grad.data(), 1, p);
+ *      double loss = ad::map_reduce(data, [p](const auto& row, auto& w) {
+ *          auto x = row.segment(0, p);
+ *          auto y = row.segment(p, 1);
+ *          return ad::sum(ad::pow<2>(y - ad::dot(w, x)));
+ *      }, params);
+ *
+ * f is called with a vector slot of a row (DataSlot<T, vec>)
+ * and a view of the parameters (VarView<T, Shape> of the same shape as params)
+ * and must return a scalar expression.
+ * Slices of the row must be taken with row.segment, which follows the current row;
+ * row.data() is not set yet when f is called.
+ * The expression is created and bound once and the slot is pointed at every row.
+ * Rows of row-major data (e.g. the transpose of column-major data
+ * with one observation per column) with the value type of params
+ * are viewed in place; rows of any other data are copied into a buffer first.
+ *
+ * Like autodiff, the adjoints of params are not reset.
+ *
+ * @param   data    dataset with one observation per row
+ * @param   f       functor creating the scalar expression of a row
+ * @param   params  parameters (Var or VarView)
+ * @return  sum of f over the rows
+ */
+template <class Derived, class F, class ParamType>
+inline auto map_reduce(const Eigen::MatrixBase<Derived>& data,
+                       F&& f,
+                       ParamType& params)
+{
+    using value_t = typename ParamType::value_t;
+    using shape_t = typename ParamType::shape_t;
+    core::MapReduceWorker<value_t, shape_t, std::remove_reference_t<F>>
+        worker(f, data.cols(), params);
+    worker.run(data, 0, data.rows());
+    worker.add_adj_to(params);
+    return worker.value();
+}
+
+/**
+ * Same as map_reduce(data, f, params) but shards the rows across the threads
+ * of the pool given by the policy.
+ *
+ * The rows are split into contiguous chunks like ParSumIterNode.
+ * Every partial result is computed by its own worker (see MapReduceWorker),
+ * which calls f once on the thread that first needs it,
+ * so f must be safe to call concurrently.
+ * Expressions returned by f that use the pool of the policy are evaluated serially.
+ * The partial values and gradients are reduced in a fixed order at the end,
+ * so params is only updated by the calling thread.
+ * If the policy is deterministic, there is exactly one chunk per partial
+ * and the result does not depend on how chunks were scheduled.
+ *
+ * @param   policy  parallel policy (see ad::par)
+ */
+template <class Derived, class F, class ParamType>
+inline auto map_reduce(const ParallelPolicy& policy,
+                       const Eigen::MatrixBase<Derived>& data,
+                       F&& f,
+                       ParamType& params)
+{
+    using value_t = typename ParamType::value_t;
+    using shape_t = typename ParamType::shape_t;
+    using worker_t = core::MapReduceWorker<
+        value_t, shape_t, std::remove_reference_t<F>>;
+
+    // number of chunks per thread when scheduling dynamically
+    constexpr size_t chunks_per_thread = 8;
+
+    size_t n_rows = data.rows();
+    size_t n_threads = policy.n_threads();
+    size_t n_chunks = std::min(n_rows,
+            n_threads * (policy.deterministic ? 1 : chunks_per_thread));
+    size_t n_partials = policy.deterministic ? n_chunks : n_threads;
+
+    std::vector<std::unique_ptr<worker_t>> workers(n_partials);
+    policy.pool->parallel_for(n_chunks,
+        [&](size_t chunk, size_t worker) {
+            auto& w = workers[policy.deterministic ? chunk : worker];
+            if (!w) w = std::make_unique<worker_t>(f, data.cols(), params);
+            w->run(data, (chunk * n_rows) / n_chunks,
+                   ((chunk + 1) * n_rows) / n_chunks);
+        });
+
+    value_t value = 0;
+    for (const auto& w : workers) {
+        if (!w) continue;
+        value += w->value();
+        w->add_adj_to(params);
+    }
+    return value;
+}
+
+} // namespace ad
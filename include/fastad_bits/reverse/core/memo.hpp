@@ -0,0 +1,251 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <fastad_bits/reverse/core/access.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * MemoNode represents a subexpression that is only forward evaluated again
+ * when its inputs have changed since its last forward evaluation.
+ * Ex.
+ * auto expr = ad::bind(ad::memo(ad::sum(ad::dot(X1, w1))) +
+ *                      ad::memo(ad::sum(ad::dot(X2, w2))));
+ * for (...) {
+ *     w1.get()(j) += step;         // the second block is not recomputed
+ *     ad::autodiff(expr);
+ * }
+ * The inputs are the leaves and placeholders read by the subexpression
+ * and their values are stamped by content:
+ * at bind time, the subexpression is visited to find the regions it reads
+ * and the regions it writes (placeholders and its own value),
+ * and every forward evaluation copies them.
+ * The next forward evaluation is skipped if the regions read hold the same values
+ * and the regions written have not been overwritten by anything else since.
+ * Leaves are written through plain references (e.g. w.get() = ...),
+ * so comparing values is the only stamp that cannot go stale.
+ * It costs one comparison per input value rather than one evaluation of the subexpression.
+ * Values viewed by constants and data slots are not compared, since they are not inputs
+ * of the computation tree: data changed behind them is not noticed.
+ * Likewise, uses of a shared subexpression (see ad::share) must be
+ * either all inside or all outside of the memoized subexpression.
+ *
+ * When the subexpression is skipped, its nodes keep the values
+ * of their last forward evaluation, which is what backward evaluation reads.
+ * So that no other node can overwrite them (e.g. the other branch of ad::if_else
+ * or another step of a checkpoint, which reuse the same part of the cache),
+ * the subexpression is bound to a cache owned by the node
+ * instead of the cache of the enclosing expression.
+ * Copies of a bound node share that cache until they are bound again.
+ * The node copies the value of the subexpression into its own value
+ * in the enclosing cache after every forward evaluation, skipped or not,
+ * so that it can also be the root of a placeholder definition (see EqNode).
+ * Backward evaluation is skipped if the seed is zero,
+ * unless the subexpression writes placeholders, whose adjoints may come from elsewhere.
+ *
+ * The value type and shape type are the same as those of the subexpression.
+ *
+ * @tparam  ExprType    type of the memoized subexpression
+ */
+
+template <class ExprType>
+struct MemoNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<MemoNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    static_assert(util::is_expr_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<
+        typename util::expr_traits<expr_t>::value_t,
+        typename util::shape_traits<expr_t>::shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    MemoNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_(expr)
+    {}
+
+    MemoNode(expr_t&& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_(std::move(expr))
+    {}
+
+    /**
+     * Forward evaluates the subexpression unless its inputs are unchanged,
+     * then copies its value.
+     *
+     * @return  const reference of the subexpression value
+     */
+    const var_t& feval()
+    {
+        if (!valid_ || !unchanged()) {
+            save(reads_, read_vals_);
+            expr_.feval();
+            save(writes_, write_vals_);
+            valid_ = true;
+        }
+        return this->get() = expr_.get();
+    }
+
+    /**
+     * Backward evaluates the subexpression with seed.
+     * It is assumed that feval is called before beval.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        if (!writes_placeholders_ && is_zero(seed)) return;
+        expr_.beval(seed);
+    }
+
+    /**
+     * Binds the subexpression to a new cache owned by the node
+     * (without adjoints if bound for forward evaluation only),
+     * then binds its own value only, since the seed is passed down unchanged.
+     * The regions read and written by the subexpression are collected
+     * and the next forward evaluation is not skipped.
+     *
+     * @return  next pointer pack not bound by itself,
+     *          since the subexpression does not use the given cache
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        auto size = expr_.bind_cache_size();
+        cache_ = std::make_shared<cache_t>();
+        cache_->val.resize(size(0));
+        if (!details::ValueOnlyScope::active()) cache_->adj.resize(size(1));
+        expr_.bind_cache({cache_->val.data(),
+                          cache_->adj.empty() ? nullptr : cache_->adj.data()});
+
+        details::AccessCollector<value_t> collector;
+        expr_.visit(collector);
+        reads_ = std::move(collector.reads);
+        writes_ = std::move(collector.writes);
+        writes_placeholders_ = !writes_.empty();
+        writes_.push_back({const_cast<value_t*>(expr_.data()), nullptr, this->size()});
+        read_vals_.resize(total_size(reads_));
+        write_vals_.resize(total_size(writes_));
+        valid_ = false;
+
+        auto adj = begin.adj;
+        begin.adj = nullptr;
+        begin = value_adj_view_t::bind(begin);
+        begin.adj = adj;
+        return begin;
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        return single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    { return {this->size(), 0}; }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
+    // memoized subexpression
+    const expr_t& expr() const { return expr_; }
+
+private:
+    using access_t = details::Access<value_t>;
+
+    struct cache_t
+    {
+        std::vector<value_t> val;
+        std::vector<value_t> adj;
+    };
+
+    static size_t total_size(const std::vector<access_t>& regions)
+    {
+        size_t size = 0;
+        for (const auto& r : regions) size += r.size;
+        return size;
+    }
+
+    // Copies the regions into vals, back to back.
+    static void save(const std::vector<access_t>& regions,
+                     std::vector<value_t>& vals)
+    {
+        auto it = vals.begin();
+        for (const auto& r : regions) {
+            it = std::copy_n(r.val, r.size, it);
+        }
+    }
+
+    // Whether the regions hold the same bits as vals.
+    static bool same(const std::vector<access_t>& regions,
+                     const std::vector<value_t>& vals)
+    {
+        const value_t* saved = vals.data();
+        for (const auto& r : regions) {
+            if (std::memcmp(r.val, saved, r.size * sizeof(value_t))) return false;
+            saved += r.size;
+        }
+        return true;
+    }
+
+    bool unchanged() const
+    {
+        return same(reads_, read_vals_) && same(writes_, write_vals_);
+    }
+
+    template <class T>
+    static bool is_zero(const T& seed)
+    {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return seed == 0;
+        } else {
+            return (util::to_array(seed) == 0).all();
+        }
+    }
+
+    expr_t expr_;
+    std::shared_ptr<cache_t> cache_;     // what the subexpression is bound to
+    std::vector<access_t> reads_;
+    std::vector<access_t> writes_;
+    std::vector<value_t> read_vals_;
+    std::vector<value_t> write_vals_;
+    bool writes_placeholders_ = false;
+    bool valid_ = false;
+};
+
+} // namespace core
+
+/**
+ * Memoizes expr: it is only forward evaluated again
+ * when the leaves or placeholders it reads have changed (see core::MemoNode).
+ */
+template <class Derived
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<std::decay_t<Derived>> &&
+            util::any_ad_v<std::decay_t<Derived>> >>
+inline auto memo(Derived&& x)
+{
+    using expr_t = util::convert_to_ad_t<std::decay_t<Derived>>;
+    expr_t expr = std::forward<Derived>(x);
+    return core::MemoNode<expr_t>(std::move(expr));
+}
+
+} // namespace ad
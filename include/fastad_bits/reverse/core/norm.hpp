@@ -54,7 +54,7 @@ public:
     void beval(value_t seed)
     {
         auto&& a_expr = util::to_array(expr_.get());
-        expr_.beval(seed * 2. * a_expr);
+        expr_.beval(2 * seed * a_expr);
     }
 
     ptr_pack_t bind_cache(ptr_pack_t begin)
@@ -78,6 +78,12 @@ public:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
 private:
     expr_t expr_;
 };
@@ -0,0 +1,56 @@
+#pragma once
+#include <memory>
+#include <fastad_bits/util/thread_pool.hpp>
+
+namespace ad {
+
+/**
+ * ParallelPolicy selects multi-threaded evaluation for nodes that support it.
+ * It owns (a shared handle to) the thread pool used for evaluation,
+ * so copies of the policy and of the nodes constructed with it share one pool.
+ *
+ * If deterministic is true, work is split into a fixed number of contiguous
+ * chunks (one per thread) and partial results are always reduced in chunk order,
+ * so repeated evaluations produce bitwise identical results.
+ * Otherwise, work is split into finer chunks that are scheduled dynamically
+ * for better load balancing, and the floating-point reduction order may vary.
+ *
+ * The pool runs one job at a time: a node evaluated on the pool that uses
+ * the same pool again (e.g. a parallel sum of parallel sums with one policy)
+ * runs the inner evaluation serially.
+ * Use policies with different pools to nest parallel evaluations.
+ */
+
+struct ParallelPolicy
+{
+    ParallelPolicy(size_t n_threads = 0,
+                   bool deterministic = false)
+        : pool(std::make_shared<util::ThreadPool>(n_threads))
+        , deterministic(deterministic)
+    {}
+
+    ParallelPolicy(const std::shared_ptr<util::ThreadPool>& pool,
+                   bool deterministic = false)
+        : pool(pool)
+        , deterministic(deterministic)
+    {}
+
+    size_t n_threads() const { return pool->size(); }
+
+    std::shared_ptr<util::ThreadPool> pool;
+    bool deterministic;
+};
+
+/**
+ * Helper function to create a ParallelPolicy.
+ *
+ * @param   n_threads       number of threads (0 means hardware concurrency)
+ * @param   deterministic   if true, fixes the reduction order
+ */
+inline ParallelPolicy par(size_t n_threads = 0,
+                          bool deterministic = false)
+{
+    return ParallelPolicy(n_threads, deterministic);
+}
+
+} // namespace ad
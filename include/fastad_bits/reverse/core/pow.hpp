@@ -39,7 +39,7 @@ struct PowFunc<0, true>
 {
     template <class BaseType>
     constexpr static auto evaluate(const BaseType&)
-    { return 1.; }
+    { return util::literal_t<BaseType>(1); }
 };
 
 // Specialization: exp < 0
@@ -51,7 +51,7 @@ struct PowFunc<n, false>
     {
         return (base == 0) ? 
             std::numeric_limits<BaseType>::infinity() : 
-            PowFunc<-n>::evaluate(1./base);
+            PowFunc<-n>::evaluate(util::literal_t<BaseType>(1) / base);
     }
 };
 
@@ -105,7 +105,7 @@ public:
 
         // derivative of x^0 = c is 0
         if constexpr (exp == 0) {
-            expr_.beval(0.);
+            expr_.beval(value_t(0));
 
         // derivative of x^1 is 1
         } else if constexpr (exp == 1) {
@@ -190,6 +190,12 @@ public:
         }
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
 private:
     expr_t expr_;
     static constexpr int64_t exp_ = exp;
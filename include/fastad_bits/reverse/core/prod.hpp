@@ -40,10 +40,14 @@ public:
     using typename value_adj_view_t::ptr_pack_t;
 
     ProdIterNode(const VecType& exprs)
+        : ProdIterNode(VecType(exprs))
+    {}
+
+    ProdIterNode(VecType&& exprs)
         : value_adj_view_t(nullptr, nullptr,
                        (exprs.size() == 0) ? 0 : exprs[0].rows(),
                        (exprs.size() == 0) ? 0 : exprs[0].cols())
-        , exprs_{exprs}
+        , exprs_{std::move(exprs)}
     {}
 
     /** 
@@ -130,6 +134,14 @@ public:
         return {this->size(), this->size()}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        for (auto& expr : exprs_) {
+            expr.visit(v);
+        }
+    }
+
 private:
     VecType exprs_;
 };
@@ -238,6 +250,12 @@ public:
         return {this->size(), expr_.size()}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
 private:
     using value_view_t = ValueView<value_t, expr_shape_t>;
     expr_t expr_;
@@ -281,7 +299,7 @@ inline auto prod(Iter begin, Iter end, Lmda f)
                 [&](const auto& x) {
                     exprs.emplace_back(f(x));
                 });
-        return core::ProdIterNode<std::vector<expr_t>>(exprs);
+        return core::ProdIterNode<std::vector<expr_t>>(std::move(exprs));
     }
 }
 
@@ -0,0 +1,466 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <Eigen/Core>
+#include <fastad_bits/reverse/core/access.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/reverse/core/adj_buffer.hpp>
+#include <fastad_bits/reverse/core/parallel.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/util/thread_pool.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/ptr_pack.hpp>
+
+namespace ad {
+namespace core {
+namespace details {
+
+// Programs are expressions made of statements: GlueNode and ForEachIterNode.
+template <class T>
+struct is_program : std::false_type {};
+template <class LeftExprType, class RightExprType>
+struct is_program<GlueNode<LeftExprType, RightExprType>> : std::true_type {};
+template <class VecType>
+struct is_program<ForEachIterNode<VecType>> : std::true_type {};
+template <class T>
+inline constexpr bool is_program_v = is_program<std::decay_t<T>>::value;
+
+/*
+ * Applies f on every statement of a (possibly nested) program in program order.
+ * Any expression that is not a program is a single statement.
+ */
+template <class ExprType, class F>
+inline void for_each_statement(ExprType& expr, F&& f)
+{
+    if constexpr (is_program_v<ExprType>) {
+        expr.for_each_statement([&](auto& e) { for_each_statement(e, f); });
+    } else {
+        f(expr);
+    }
+}
+
+/*
+ * Type-erased statement of a program.
+ * Only the last statement is seeded with a non-zero seed,
+ * which is materialized with the shape of the program.
+ */
+template <class ValueType, class ShapeType>
+struct Statement
+{
+    using value_t = ValueType;
+    using shape_t = ShapeType;
+    using ptr_pack_t = util::PtrPack<value_t>;
+    using seed_t = std::conditional_t<
+        std::is_same_v<shape_t, ad::scl>, value_t,
+        std::conditional_t<
+            std::is_same_v<shape_t, ad::vec>,
+            Eigen::Array<value_t, Eigen::Dynamic, 1>,
+            Eigen::Array<value_t, Eigen::Dynamic, Eigen::Dynamic> > >;
+
+    template <class ExprType>
+    Statement(ExprType& expr)
+        : expr(&expr)
+        , feval([](void* e) { static_cast<ExprType*>(e)->feval(); })
+        , beval([](void* e) { static_cast<ExprType*>(e)->beval(0); })
+        , beval_seed([](void* e, const seed_t& seed) {
+                if constexpr (std::is_same_v<shape_t,
+                        typename util::shape_traits<ExprType>::shape_t>) {
+                    static_cast<ExprType*>(e)->beval(seed);
+                } else {
+                    static_cast<void>(e);
+                    static_cast<void>(seed);
+                }
+            })
+        , bind_cache([](void* e, ptr_pack_t begin) {
+                return static_cast<ExprType*>(e)->bind_cache(begin);
+            })
+        , data([](void* e) {
+                auto* expr = static_cast<ExprType*>(e);
+                return ptr_pack_t(expr->data(), expr->data_adj());
+            })
+        , visit([](void* e, AccessCollector<value_t>& v) {
+                static_cast<ExprType*>(e)->visit(v);
+            })
+    {}
+
+    void* expr;
+    void (*feval)(void*);
+    void (*beval)(void*);
+    void (*beval_seed)(void*, const seed_t&);
+    ptr_pack_t (*bind_cache)(void*, ptr_pack_t);
+    ptr_pack_t (*data)(void*);
+    void (*visit)(void*, AccessCollector<value_t>&);
+};
+
+} // namespace details
+
+/**
+ * ScheduleNode evaluates a program (expressions glued with operator,
+ * or created with ad::for_each) in parallel while respecting
+ * the dependencies between its statements.
+ *
+ * At bind time, every statement is visited to find the leaves and placeholders it
+ * reads and the placeholders it writes (EqNode, OpEqNode).
+ * Statement j depends on an earlier statement i if one writes a region
+ * the other reads or writes.
+ * These dependencies form a DAG that is run on a work-stealing pool
+ * in the forward sweep and in reverse in the backward sweep.
+ *
+ * In the backward sweep, statements reading the same placeholder also
+ * accumulate into the same adjoint, so they are additionally serialized.
+ * Leaves that no statement writes (e.g. parameters) can be read by many statements;
+ * once they are found, the statements are bound again with their own AdjBuffer
+ * for the adjoints of these leaves, and the buffers are reduced at the end.
+ * If the policy is deterministic, statements reading the same leaf are serialized 
+ * in program order instead so that the result is reproducible.
+ *
+ * Statements that themselves use the pool of the policy (e.g. a parallel sum
+ * with the same pool) run their own parallel evaluation serially.
+ *
+ * Every statement gets its own disjoint region of the cache.
+ *
+ * @tparam  ExprType    type of program to schedule
+ */
+
+template <class ExprType>
+struct ScheduleNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<ScheduleNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    using expr_value_t = typename util::expr_traits<expr_t>::value_t;
+    using expr_shape_t = typename util::shape_traits<expr_t>::shape_t;
+    using stmt_t = details::Statement<expr_value_t, expr_shape_t>;
+    using collector_t = details::AccessCollector<expr_value_t>;
+    using range_index_t = details::RangeIndex<expr_value_t>;
+    using adj_buffer_t = AdjBuffer<expr_value_t>;
+
+    static_assert(util::is_expr_v<expr_t>);
+
+public:
+    using value_adj_view_t = ValueAdjView<expr_value_t, expr_shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    ScheduleNode(const expr_t& expr,
+                 const ParallelPolicy& policy)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , expr_(expr)
+        , policy_(policy)
+    {}
+
+    // Statements point into expr_, so copies and moves collect them again.
+    ScheduleNode(const ScheduleNode& other)
+        : value_adj_view_t(other)
+        , expr_(other.expr_)
+        , policy_(other.policy_)
+        , fwd_graph_(other.fwd_graph_)
+        , rev_graph_(other.rev_graph_)
+        , shared_adj_(other.shared_adj_)
+        , seed_(other.seed_)
+    {
+        relink(!other.stmts_.empty(), !other.adj_bufs_.empty());
+    }
+
+    ScheduleNode(ScheduleNode&& other)
+        : value_adj_view_t(other)
+        , expr_(std::move(other.expr_))
+        , policy_(std::move(other.policy_))
+        , fwd_graph_(std::move(other.fwd_graph_))
+        , rev_graph_(std::move(other.rev_graph_))
+        , shared_adj_(std::move(other.shared_adj_))
+        , seed_(std::move(other.seed_))
+    {
+        relink(!other.stmts_.empty(), !other.adj_bufs_.empty());
+    }
+
+    ScheduleNode& operator=(const ScheduleNode& other)
+    {
+        return *this = ScheduleNode(other);
+    }
+
+    ScheduleNode& operator=(ScheduleNode&& other)
+    {
+        const bool bound = !other.stmts_.empty();
+        const bool buffered = !other.adj_bufs_.empty();
+        value_adj_view_t::operator=(other);
+        expr_ = std::move(other.expr_);
+        policy_ = std::move(other.policy_);
+        fwd_graph_ = std::move(other.fwd_graph_);
+        rev_graph_ = std::move(other.rev_graph_);
+        shared_adj_ = std::move(other.shared_adj_);
+        seed_ = std::move(other.seed_);
+        relink(bound, buffered);
+        return *this;
+    }
+
+    /**
+     * Forward evaluates every statement as soon as the statements it depends on
+     * have been evaluated.
+     *
+     * @return  last statement forward evaluation result
+     */
+    const var_t& feval()
+    {
+        policy_.pool->run_graph(fwd_graph_,
+            [&](size_t i, size_t) { stmts_[i].feval(stmts_[i].expr); });
+        return this->get();
+    }
+
+    /**
+     * Backward evaluates the last statement with seed,
+     * then every other statement (with seed 0) in reverse dependency order.
+     * See GlueNode::beval.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        if (stmts_.empty()) return;
+        seed_ = seed;
+        auto& last = stmts_.back();
+        last.beval_seed(last.expr, seed_);
+
+        policy_.pool->run_graph(rev_graph_,
+            [&](size_t i, size_t) { stmts_[i].beval(stmts_[i].expr); });
+        for (auto& buf : adj_bufs_) {
+            buf.flush();
+        }
+    }
+
+    /**
+     * Binds every statement to disjoint regions from left to right,
+     * binds itself to the last statement like GlueNode,
+     * then computes the dependency graphs.
+     * If statements share leaves (see find_shared_leaves),
+     * they are bound again to the same regions, each with its own AdjBuffer.
+     *
+     * @return  the next pointer pack not bound by any statement
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        collect_statements();
+        adj_bufs_.clear();
+        ptr_pack_t next = bind_statements(begin);
+        if (!stmts_.empty()) {
+            value_adj_view_t::bind(stmts_.back().data(stmts_.back().expr));
+        }
+        build_graphs();
+        if (!adj_bufs_.empty()) bind_statements(begin);
+        return next;
+    }
+
+    util::SizePack bind_cache_size() const
+    {
+        util::SizePack out = util::SizePack::Zero();
+        details::for_each_statement(expr_,
+                [&](const auto& e) { out += e.bind_cache_size(); });
+        return out;
+    }
+
+    util::SizePack single_bind_cache_size() const
+    { return {0,0}; }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
+private:
+    void collect_statements()
+    {
+        stmts_.clear();
+        details::for_each_statement(expr_,
+                [&](auto& e) { stmts_.emplace_back(e); });
+    }
+
+    ptr_pack_t bind_statements(ptr_pack_t begin)
+    {
+        for (size_t i = 0; i < stmts_.size(); ++i) {
+            auto& stmt = stmts_[i];
+            if (adj_bufs_.empty()) {
+                begin = stmt.bind_cache(stmt.expr, begin);
+            } else {
+                AdjBufferGuard<value_t> guard(adj_bufs_[i]);
+                begin = stmt.bind_cache(stmt.expr, begin);
+            }
+        }
+        return begin;
+    }
+
+    // Per-statement buffers of the adjoints of shared leaves (see find_shared_leaves).
+    void make_adj_bufs()
+    {
+        adj_bufs_.assign(stmts_.size(), adj_buffer_t(
+            [this](const value_t* adj, size_t size) {
+                return !shared_adj_.overlaps(adj, size);
+            }));
+    }
+
+    // Points the statements and buffers of a copy to itself.
+    // Leaves are redirected to the new buffers when the copy is bound again.
+    void relink(bool bound, bool buffered)
+    {
+        stmts_.clear();
+        adj_bufs_.clear();
+        if (bound) collect_statements();
+        if (buffered) make_adj_bufs();
+    }
+
+    void build_graphs()
+    {
+        const size_t n = stmts_.size();
+        std::vector<collector_t> access(n);
+        for (size_t i = 0; i < n; ++i) {
+            stmts_[i].visit(stmts_[i].expr, access[i]);
+        }
+
+        // Regions that create dependencies: written regions and,
+        // if deterministic, also every region that is read.
+        range_index_t resources;
+        range_index_t written_adj;
+        for (const auto& acc : access) {
+            for (const auto& w : acc.writes) {
+                resources.add(w.val, w.size);
+                written_adj.add(w.adj, w.size);
+            }
+            if (policy_.deterministic) {
+                for (const auto& r : acc.reads) {
+                    resources.add(r.val, r.size);
+                }
+            }
+        }
+        resources.finalize();
+        written_adj.finalize();
+
+        fwd_graph_ = util::TaskGraph(n);
+        rev_graph_ = util::TaskGraph(n ? n-1 : 0);
+
+        // forward edge i -> j implies reverse edge j -> i.
+        // The last statement is backward evaluated before the reverse graph is run.
+        auto add_edge = [&](size_t i, size_t j) {
+            fwd_graph_.add_edge(i, j);
+            if (j+1 < n) rev_graph_.add_edge(j, i);
+        };
+
+        constexpr size_t none = static_cast<size_t>(-1);
+        std::vector<size_t> last_writer(resources.size(), none);
+        std::vector<std::vector<size_t>> readers(resources.size());
+
+        for (size_t j = 0; j < n; ++j) {
+            for (const auto& r : access[j].reads) {
+                resources.overlapping(r.val, r.size, [&](size_t k) {
+                    if (last_writer[k] != none) add_edge(last_writer[k], j);
+                    auto& rk = readers[k];
+                    if (!rk.empty() && rk.back() == j) return;
+                    // readers accumulate into the same adjoint
+                    if (!rk.empty() && j+1 < n) rev_graph_.add_edge(j, rk.back());
+                    rk.push_back(j);
+                });
+            }
+            for (const auto& w : access[j].writes) {
+                resources.overlapping(w.val, w.size, [&](size_t k) {
+                    if (last_writer[k] != none) add_edge(last_writer[k], j);
+                    for (size_t i : readers[k]) add_edge(i, j);
+                    last_writer[k] = j;
+                    readers[k].clear();
+                });
+            }
+        }
+
+        fwd_graph_.finalize();
+        rev_graph_.finalize();
+
+        adj_bufs_.clear();
+        if (!policy_.deterministic && policy_.n_threads() > 1) {
+            find_shared_leaves(access, written_adj);
+            if (shared_adj_.size()) make_adj_bufs();
+        }
+
+        if constexpr (!util::is_scl_v<expr_t>) {
+            seed_.resize(this->rows(), this->cols());
+        }
+    }
+
+    /*
+     * Finds the leaves whose adjoints may be updated concurrently in the backward sweep,
+     * i.e. leaves that are never written and read by more than one statement.
+     * Overlapping ranges (e.g. views of the same vector) are merged.
+     */
+    void find_shared_leaves(const std::vector<collector_t>& access,
+                            const range_index_t& written_adj)
+    {
+        struct Read
+        {
+            const value_t* begin;
+            const value_t* end;
+            size_t stmt;
+        };
+
+        std::vector<Read> reads;
+        for (size_t j = 0; j < access.size(); ++j) {
+            for (const auto& r : access[j].reads) {
+                if (written_adj.overlaps(r.adj, r.size)) continue;
+                reads.push_back({r.adj, r.adj + r.size, j});
+            }
+        }
+        std::sort(reads.begin(), reads.end(),
+                [](const Read& x, const Read& y) { return x.begin < y.begin; });
+
+        shared_adj_ = range_index_t();
+        for (size_t i = 0; i < reads.size();) {
+            const value_t* end = reads[i].end;
+            bool shared = false;
+            size_t k = i + 1;
+            for (; k < reads.size() && reads[k].begin < end; ++k) {
+                shared = shared || (reads[k].stmt != reads[i].stmt);
+                end = std::max(end, reads[k].end);
+            }
+            if (shared) {
+                shared_adj_.add(reads[i].begin,
+                                static_cast<size_t>(end - reads[i].begin));
+            }
+            i = k;
+        }
+        shared_adj_.finalize();
+    }
+
+    expr_t expr_;
+    ParallelPolicy policy_;
+    std::vector<stmt_t> stmts_;
+    util::TaskGraph fwd_graph_;
+    util::TaskGraph rev_graph_;
+    range_index_t shared_adj_;
+    std::vector<adj_buffer_t> adj_bufs_;
+    typename stmt_t::seed_t seed_;
+};
+
+} // namespace core
+
+/**
+ * Helper function to create a ScheduleNode that evaluates the statements
+ * of a program in parallel according to their dependencies.
+ *
+ * @param   policy  parallel policy (see ad::par)
+ * @param   x       program, e.g. (w1 = f(x), w2 = g(x), w1 * w2)
+ */
+template <class Derived
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<Derived> &&
+            util::any_ad_v<Derived> > >
+inline auto schedule(const ParallelPolicy& policy, const Derived& x)
+{
+    using expr_t = util::convert_to_ad_t<Derived>;
+    expr_t expr = x;
+    return core::ScheduleNode<expr_t>(expr, policy);
+}
+
+} // namespace ad
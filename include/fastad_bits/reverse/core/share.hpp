@@ -0,0 +1,245 @@
+#pragma once
+#include <limits>
+#include <memory>
+#include <vector>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/expr_base.hpp>
+#include <fastad_bits/reverse/core/value_adj_view.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+#include <fastad_bits/util/shape_traits.hpp>
+#include <fastad_bits/util/size_pack.hpp>
+#include <fastad_bits/util/value.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * SharedNode represents a subexpression that is used more than once.
+ * Ex.
+ * auto u = ad::share(x[1] * w[0]);
+ * auto expr = ad::sin(u) + u * u;
+ * All copies of a SharedNode refer to one state holding the subexpression,
+ * so the subexpression is stored, bound and evaluated once.
+ * This is the same optimization as a placeholder (see EqNode)
+ * without declaring a Var and gluing the definition with operator,.
+ *
+ * Every copy is a use of the subexpression and the first use to be bound
+ * (left to right, as in forward evaluation) is its definition:
+ * it alone binds the subexpression and forward evaluates it,
+ * while the other uses view its value.
+ * A use that is the root of a placeholder definition (see EqNode)
+ * is viewing the placeholder instead, so it copies the value into it.
+ *
+ * Every use adds its seed to one adjoint.
+ * The first use forward evaluated in a pass that can be backward evaluated,
+ * i.e. that is not bound in a details::ForwardOnlyScope like the operands
+ * of a comparison, is backward evaluated last.
+ * It backward evaluates the subexpression once with the sum of the seeds
+ * and resets the adjoint to 0.
+ * The shared adjoint lives in the state rather than the cache,
+ * since statements that are backward evaluated one after the other
+ * reuse the same adjoint cache (see GlueNode::bind_cache).
+ *
+ * ExprBind clones the state (see details::CloneScope),
+ * so the same shared expression can be bound any number of times.
+ * Uses must be evaluated in the same forward and backward pass,
+ * hence they must not be spread across the terms of a parallel sum,
+ * the statements of a ScheduleNode or the steps of a CheckpointNode.
+ * The definition must be forward evaluated in every pass,
+ * so it must not be in a branch of an if_else unless every use is.
+ *
+ * The value type and shape type are the same as those of the subexpression.
+ *
+ * @tparam  ExprType    type of the shared subexpression
+ */
+
+template <class ExprType>
+struct SharedNode:
+    ValueAdjView<typename util::expr_traits<ExprType>::value_t,
+                 typename util::shape_traits<ExprType>::shape_t>,
+    ExprBase<SharedNode<ExprType>>
+{
+private:
+    using expr_t = ExprType;
+    static_assert(util::is_expr_v<expr_t>);
+
+    static constexpr size_t no_use = std::numeric_limits<size_t>::max();
+
+public:
+    using value_adj_view_t = ValueAdjView<
+        typename util::expr_traits<expr_t>::value_t,
+        typename util::shape_traits<expr_t>::shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    /*
+     * State shared by every use.
+     * n_uses and n_sized are the numbers of uses indexed when bound and sized,
+     * adj is the shared adjoint and cache is what the definition is bound to.
+     * owner is the use that backward evaluates the subexpression in the current pass.
+     */
+    struct State
+    {
+        State(const expr_t& expr)
+            : expr(expr)
+        {}
+
+        expr_t expr;
+        size_t n_uses = 0;
+        size_t n_sized = 0;
+        std::vector<value_t> adj;
+        ptr_pack_t cache{nullptr, nullptr};
+        size_t owner = no_use;
+    };
+
+    SharedNode(const expr_t& expr)
+        : value_adj_view_t(nullptr, nullptr, expr.rows(), expr.cols())
+        , state_(std::make_shared<State>(expr))
+        , shared_(nullptr, nullptr, expr.rows(), expr.cols())
+    {}
+
+    SharedNode(const SharedNode& other)
+        : value_adj_view_t(other)
+        , state_(details::CloneScope::active() ?
+                 details::CloneScope::active()->clone(other.state_) :
+                 other.state_)
+        , shared_(other.shared_)
+        , use_(other.use_)
+        , size_use_(other.size_use_)
+        , backward_(other.backward_)
+    {}
+
+    SharedNode& operator=(const SharedNode& other) =default;
+
+    /**
+     * The definition forward evaluates the subexpression.
+     * Every use then views the value of the subexpression,
+     * or copies it if it is the root of a placeholder definition.
+     * The first use that can be backward evaluated becomes the owner.
+     *
+     * @return  const reference of the subexpression value
+     */
+    const var_t& feval()
+    {
+        if (is_definition()) {
+            state_->expr.feval();
+            state_->owner = no_use;
+        }
+        if (backward_ && state_->owner == no_use) state_->owner = use_;
+        if (this->data() != shared_.data()) this->get() = shared_.get();
+        return this->get();
+    }
+
+    /**
+     * Adds seed to the shared adjoint.
+     * The owner then backward evaluates the subexpression with the total seed
+     * and resets the shared adjoint for the next backward evaluation.
+     * It is assumed that feval is called before beval.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        auto&& a_adj = util::to_array(shared_.get_adj());
+        a_adj += seed;
+        if (use_ == state_->owner) {
+            state_->expr.beval(a_adj);
+            shared_.zero_adj();
+        }
+    }
+
+    /**
+     * The definition binds the subexpression, then views its value
+     * and the shared adjoint.
+     * The other uses, which are bound after the definition,
+     * view the same value and adjoint, and count as active reads
+     * (see details::ActivityScope).
+     *
+     * @return  next pointer pack not bound by the subexpression
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        backward_ = !details::ForwardOnlyScope::active();
+        if (!is_definition()) {
+            details::ActivityScope::read(false);
+            shared_.bind(state_->cache);
+            value_adj_view_t::bind(state_->cache);
+            return begin;
+        }
+        auto& expr = state_->expr;
+        auto& adj = state_->adj;
+        begin = expr.bind_cache(begin);
+        adj.resize(this->size());
+        state_->cache = {const_cast<value_t*>(expr.data()), adj.data()};
+        shared_.bind(state_->cache);
+        value_adj_view_t::bind(state_->cache);
+        shared_.zero_adj();
+        return begin;
+    }
+
+    /**
+     * Only one use needs the cache of the subexpression.
+     * Children may be sized in any order, so this need not be the definition.
+     * @return  size pack
+     */
+    util::SizePack bind_cache_size() const
+    {
+        if (size_use_ == no_use) size_use_ = state_->n_sized++;
+        if (size_use_ != 0) return single_bind_cache_size();
+        return single_bind_cache_size() +
+                state_->expr.bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    { return {0,0}; }
+
+    /**
+     * The definition visits the subexpression.
+     * The other uses report themselves with v.read(use),
+     * since their value and adjoint come from the definition.
+     */
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        if (is_definition()) state_->expr.visit(v);
+        else v.read(*this);
+    }
+
+    // shared subexpression, valid after the definition is forward evaluated
+    const expr_t& expr() const { return state_->expr; }
+
+private:
+    // Indexes the uses in the order they are first bound.
+    bool is_definition()
+    {
+        if (use_ == no_use) use_ = state_->n_uses++;
+        return use_ == 0;
+    }
+
+    std::shared_ptr<State> state_;
+    value_adj_view_t shared_;   // value of the subexpression and shared adjoint
+    size_t use_ = no_use;
+    mutable size_t size_use_ = no_use;
+    bool backward_ = true;      // false if bound in a details::ForwardOnlyScope
+};
+
+} // namespace core
+
+/**
+ * Marks expr as a subexpression shared by all copies of the result.
+ * The subexpression is evaluated once per forward evaluation
+ * and backward evaluated once with the sum of the seeds of every use.
+ */
+template <class Derived
+        , class = std::enable_if_t<
+            util::is_convertible_to_ad_v<Derived> &&
+            util::any_ad_v<Derived> >>
+inline auto share(const Derived& x)
+{
+    using expr_t = util::convert_to_ad_t<Derived>;
+    expr_t expr = x;
+    return core::SharedNode<expr_t>(expr);
+}
+
+} // namespace ad
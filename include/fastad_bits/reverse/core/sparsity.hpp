@@ -0,0 +1,575 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/hessian.hpp>
+#include <fastad_bits/reverse/core/jacobian.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * InteractionRecorder collects the pairs of independent variables
+ * that interact nonlinearly while SparsityTracer values are computed,
+ * i.e. the pairs (i, j) for which the Hessian entry may be nonzero.
+ *
+ * A recorder becomes the active recorder of the calling thread on construction
+ * and the previously active one is restored on destruction.
+ * No pairs are recorded if there is no active recorder.
+ */
+
+class InteractionRecorder
+{
+public:
+    using index_t = size_t;
+    using pair_t = std::pair<index_t, index_t>;
+
+    InteractionRecorder()
+        : prev_(current_)
+    {
+        current_ = this;
+    }
+
+    InteractionRecorder(const InteractionRecorder&) =delete;
+    InteractionRecorder& operator=(const InteractionRecorder&) =delete;
+
+    ~InteractionRecorder() { current_ = prev_; }
+
+    static InteractionRecorder* active() { return current_; }
+
+    // Records every pair (i, j) and (j, i) for i in a and j in b.
+    void add(const std::vector<index_t>& a,
+             const std::vector<index_t>& b)
+    {
+        for (index_t i : a) {
+            for (index_t j : b) {
+                pairs_.emplace_back(i, j);
+                pairs_.emplace_back(j, i);
+            }
+        }
+        if (pairs_.size() > 2 * n_unique_ + 1024) compress();
+    }
+
+    // Returns the sorted unique pairs.
+    const std::vector<pair_t>& pairs()
+    {
+        compress();
+        return pairs_;
+    }
+
+private:
+    void compress()
+    {
+        std::sort(pairs_.begin(), pairs_.end());
+        pairs_.erase(std::unique(pairs_.begin(), pairs_.end()), pairs_.end());
+        n_unique_ = pairs_.size();
+    }
+
+    static inline thread_local InteractionRecorder* current_ = nullptr;
+
+    InteractionRecorder* prev_;
+    std::vector<pair_t> pairs_;
+    size_t n_unique_ = 0;
+};
+
+/**
+ * SparsityTracer is a value type that propagates the set of independent variables
+ * a value depends on instead of the value itself.
+ * Using it as the value type of an expression (e.g. Var<SparsityTracer, vec>)
+ * where the ith element of x depends on {i},
+ * a forward evaluation gives the dependencies of every output,
+ * i.e. the sparsity pattern of the Jacobian.
+ * Nonlinear operations additionally record the interactions of their operands
+ * in the active InteractionRecorder, which gives the sparsity pattern of the Hessian.
+ *
+ * Plain values (constants) depend on nothing.
+ * The patterns do not depend on values, so they are valid for every x,
+ * except that expressions whose structure depends on values (e.g. if_else)
+ * are not supported since a tracer cannot be compared.
+ */
+
+class SparsityTracer
+{
+public:
+    using index_t = InteractionRecorder::index_t;
+    using set_t = std::vector<index_t>;
+
+    SparsityTracer() =default;
+
+    template <class T
+            , class = std::enable_if_t<std::is_arithmetic_v<T>> >
+    SparsityTracer(T)
+    {}
+
+    // Returns the tracer of the ith independent variable.
+    static SparsityTracer independent(index_t i)
+    {
+        SparsityTracer x;
+        x.deps_.push_back(i);
+        return x;
+    }
+
+    // Sorted indices of the independent variables this value depends on.
+    const set_t& deps() const { return deps_; }
+
+    SparsityTracer& operator+=(const SparsityTracer& x) { return *this = *this + x; }
+    SparsityTracer& operator-=(const SparsityTracer& x) { return *this = *this - x; }
+    SparsityTracer& operator*=(const SparsityTracer& x) { return *this = *this * x; }
+    SparsityTracer& operator/=(const SparsityTracer& x) { return *this = *this / x; }
+
+    friend SparsityTracer operator-(const SparsityTracer& x) { return x; }
+
+    friend SparsityTracer operator+(const SparsityTracer& x, const SparsityTracer& y)
+    { return merge(x, y); }
+
+    friend SparsityTracer operator-(const SparsityTracer& x, const SparsityTracer& y)
+    { return merge(x, y); }
+
+    friend SparsityTracer operator*(const SparsityTracer& x, const SparsityTracer& y)
+    {
+        record(x.deps_, y.deps_);
+        return merge(x, y);
+    }
+
+    friend SparsityTracer operator/(const SparsityTracer& x, const SparsityTracer& y)
+    {
+        auto z = merge(x, y);
+        record(z.deps_, y.deps_);
+        return z;
+    }
+
+    // Equality compares dependencies (it is needed by Eigen's matrix products).
+    friend bool operator==(const SparsityTracer& x, const SparsityTracer& y)
+    { return x.deps_ == y.deps_; }
+
+    friend bool operator!=(const SparsityTracer& x, const SparsityTracer& y)
+    { return !(x == y); }
+
+    /*
+     * Nonlinear unary function: the value depends on the same variables
+     * and every pair of them interacts.
+     */
+    friend SparsityTracer nonlinear(const SparsityTracer& x)
+    {
+        record(x.deps_, x.deps_);
+        return x;
+    }
+
+private:
+    static SparsityTracer merge(const SparsityTracer& x, const SparsityTracer& y)
+    {
+        if (y.deps_.empty() || x.deps_ == y.deps_) return x;
+        if (x.deps_.empty()) return y;
+        SparsityTracer z;
+        z.deps_.reserve(x.deps_.size() + y.deps_.size());
+        std::set_union(x.deps_.begin(), x.deps_.end(),
+                       y.deps_.begin(), y.deps_.end(),
+                       std::back_inserter(z.deps_));
+        return z;
+    }
+
+    static void record(const set_t& a, const set_t& b)
+    {
+        auto* recorder = InteractionRecorder::active();
+        if (recorder && !a.empty() && !b.empty()) recorder->add(a, b);
+    }
+
+    set_t deps_;
+};
+
+/*
+ * Mixed operations with plain values are linear in the tracer,
+ * except for division by a tracer.
+ */
+#define SPARSITY_TRACER_MIXED_FUNC(op) \
+template <class T, class = std::enable_if_t<std::is_arithmetic_v<T>> > \
+inline SparsityTracer operator op(const SparsityTracer& x, T) { return x; } \
+template <class T, class = std::enable_if_t<std::is_arithmetic_v<T>> > \
+inline SparsityTracer operator op(T, const SparsityTracer& x) { return x; }
+
+SPARSITY_TRACER_MIXED_FUNC(+)
+SPARSITY_TRACER_MIXED_FUNC(-)
+SPARSITY_TRACER_MIXED_FUNC(*)
+
+#undef SPARSITY_TRACER_MIXED_FUNC
+
+template <class T, class = std::enable_if_t<std::is_arithmetic_v<T>> >
+inline SparsityTracer operator/(const SparsityTracer& x, T) { return x; }
+
+template <class T, class = std::enable_if_t<std::is_arithmetic_v<T>> >
+inline SparsityTracer operator/(T, const SparsityTracer& x) { return nonlinear(x); }
+
+/*
+ * Mathematical functions on SparsityTracer.
+ * These are found by argument-dependent lookup from the unary functors (see UNARY_STRUCT)
+ * and from Eigen's array functions.
+ */
+#define SPARSITY_TRACER_UNARY_FUNC(f) \
+inline SparsityTracer f(const SparsityTracer& x) { return nonlinear(x); }
+
+SPARSITY_TRACER_UNARY_FUNC(sin)
+SPARSITY_TRACER_UNARY_FUNC(cos)
+SPARSITY_TRACER_UNARY_FUNC(tan)
+SPARSITY_TRACER_UNARY_FUNC(asin)
+SPARSITY_TRACER_UNARY_FUNC(acos)
+SPARSITY_TRACER_UNARY_FUNC(atan)
+SPARSITY_TRACER_UNARY_FUNC(exp)
+SPARSITY_TRACER_UNARY_FUNC(log)
+SPARSITY_TRACER_UNARY_FUNC(sqrt)
+SPARSITY_TRACER_UNARY_FUNC(erf)
+SPARSITY_TRACER_UNARY_FUNC(sinh)
+SPARSITY_TRACER_UNARY_FUNC(cosh)
+SPARSITY_TRACER_UNARY_FUNC(tanh)
+
+#undef SPARSITY_TRACER_UNARY_FUNC
+
+// abs is piecewise linear, so its second derivative is 0 almost everywhere.
+inline SparsityTracer abs(const SparsityTracer& x) { return x; }
+
+inline SparsityTracer pow(const SparsityTracer& x, const SparsityTracer& y)
+{ return nonlinear(x + y); }
+
+} // namespace core
+} // namespace ad
+
+namespace std {
+
+// SparsityTracer is the common type of SparsityTracer and plain values (see BinaryNode).
+template <>
+struct common_type<ad::core::SparsityTracer, double> { using type = ad::core::SparsityTracer; };
+
+template <>
+struct common_type<double, ad::core::SparsityTracer> { using type = ad::core::SparsityTracer; };
+
+} // namespace std
+
+namespace Eigen {
+
+// Allows SparsityTracer as the scalar type of Eigen containers.
+template <>
+struct NumTraits<ad::core::SparsityTracer> : GenericNumTraits<ad::core::SparsityTracer>
+{
+    using Real = ad::core::SparsityTracer;
+    using NonInteger = ad::core::SparsityTracer;
+    using Nested = ad::core::SparsityTracer;
+    using Literal = double;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = 1,
+        AddCost = 8,
+        MulCost = 8
+    };
+};
+
+} // namespace Eigen
+
+namespace ad {
+namespace core {
+
+/**
+ * SparsityPattern is the sparsity pattern of an n_rows x n_cols matrix
+ * stored as the sorted row indices of the nonzeros of every column.
+ */
+
+struct SparsityPattern
+{
+    using index_t = SparsityTracer::index_t;
+
+    SparsityPattern(size_t m = 0, size_t n = 0)
+        : n_rows(m)
+        , cols(n)
+    {}
+
+    size_t rows() const { return n_rows; }
+    size_t n_nonzeros() const
+    {
+        size_t nnz = 0;
+        for (const auto& c : cols) nnz += c.size();
+        return nnz;
+    }
+
+    // Returns the pattern of the transpose.
+    SparsityPattern transpose() const
+    {
+        SparsityPattern t(cols.size(), n_rows);
+        for (size_t j = 0; j < cols.size(); ++j) {
+            for (index_t i : cols[j]) t.cols[i].push_back(j);
+        }
+        return t;
+    }
+
+    size_t n_rows;
+    std::vector<std::vector<index_t>> cols;
+};
+
+/**
+ * Coloring of the columns of a SparsityPattern such that
+ * no two columns of the same color have a nonzero in the same row
+ * (distance-2 coloring of the bipartite row-column graph).
+ * Then the sum of the columns of one color is a compressed column
+ * from which every nonzero of these columns is directly recovered.
+ */
+
+struct ColumnColoring
+{
+    std::vector<size_t> color;
+    size_t n_colors = 0;
+};
+
+/**
+ * Colors the columns of p greedily, visiting columns in decreasing number of nonzeros
+ * (largest-first ordering), each getting the smallest color not used by a column
+ * it shares a row with.
+ */
+inline ColumnColoring color_columns(const SparsityPattern& p)
+{
+    const size_t n = p.cols.size();
+    const SparsityPattern pt = p.transpose();
+
+    std::vector<size_t> order(n);
+    for (size_t j = 0; j < n; ++j) order[j] = j;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return p.cols[a].size() > p.cols[b].size();
+            });
+
+    constexpr size_t none = static_cast<size_t>(-1);
+    ColumnColoring c;
+    c.color.assign(n, none);
+    std::vector<size_t> forbidden;   // forbidden[color] == j if forbidden for column j
+    for (size_t j : order) {
+        for (auto i : p.cols[j]) {
+            for (auto k : pt.cols[i]) {
+                if (c.color[k] != none) forbidden[c.color[k]] = j;
+            }
+        }
+        size_t color = 0;
+        while (color < forbidden.size() && forbidden[color] == j) ++color;
+        if (color == forbidden.size()) forbidden.push_back(none);
+        c.color[j] = color;
+    }
+    c.n_colors = forbidden.size();
+    return c;
+}
+
+namespace details {
+
+// Builds f(x) with tracers of x and returns the root of the bound expression with the tracers.
+template <class F>
+inline auto trace(F& f, size_t n)
+{
+    using var_t = Var<SparsityTracer, ad::vec>;
+    auto x = std::make_unique<var_t>(n);
+    for (size_t i = 0; i < n; ++i) {
+        x->get()(i) = SparsityTracer::independent(i);
+    }
+    auto expr = ad::bind(f(*x));
+    ad::evaluate(expr);
+    return std::make_pair(std::move(x), std::move(expr));
+}
+
+} // namespace details
+} // namespace core
+
+/**
+ * Computes the sparsity pattern of the Jacobian of f at x
+ * (see jacobian(f, x) for the requirements on f)
+ * by one forward evaluation with SparsityTracer values.
+ *
+ * @param   f   functor creating the expression
+ * @param   x   point at which the Jacobian is computed (only its size is used)
+ * @return  sparsity pattern (outputs x inputs)
+ */
+template <class F, class Derived>
+inline auto jacobian_sparsity(F&& f, const Eigen::MatrixBase<Derived>& x)
+{
+    size_t n = x.size();
+    auto traced = core::details::trace(f, n);
+    auto& root = traced.second.get();
+    const auto* y = root.data();
+    core::SparsityPattern p(root.size(), n);
+    for (size_t i = 0; i < root.size(); ++i) {
+        for (auto j : y[i].deps()) p.cols[j].push_back(i);
+    }
+    return p;
+}
+
+/**
+ * Computes the sparsity pattern of the Hessian of the scalar expression f at x
+ * (see hessian(f, x) for the requirements on f)
+ * by one forward evaluation with SparsityTracer values.
+ *
+ * @param   f   functor creating the scalar expression
+ * @param   x   point at which the Hessian is computed (only its size is used)
+ * @return  symmetric sparsity pattern
+ */
+template <class F, class Derived>
+inline auto hessian_sparsity(F&& f, const Eigen::MatrixBase<Derived>& x)
+{
+    size_t n = x.size();
+    core::InteractionRecorder recorder;
+    core::details::trace(f, n);
+    core::SparsityPattern p(n, n);
+    for (const auto& ij : recorder.pairs()) {
+        p.cols[ij.second].push_back(ij.first);
+    }
+    return p;
+}
+
+/**
+ * Computes the Jacobian of f at x given its sparsity pattern.
+ * The columns (or rows) are colored so that the columns (rows) of one color
+ * are computed together by a single seed direction.
+ * The mode with fewer colors is used: forward mode computes J S (K colors per evaluation)
+ * and reverse mode computes W^T J (K colors per sweep),
+ * so the cost scales with the number of colors instead of the number of inputs.
+ *
+ * Computing the pattern once with jacobian_sparsity and reusing it
+ * saves the detection for every further point.
+ *
+ * @tparam  K       number of colors per evaluation
+ * @param   f       functor creating the expression (see jacobian(f, x))
+ * @param   x       point at which the Jacobian is computed
+ * @param   pattern sparsity pattern of the Jacobian
+ * @return  Jacobian as a (column-major) Eigen::SparseMatrix
+ */
+template <int K = 4, class F, class Derived>
+inline auto sparse_jacobian(F&& f,
+                            const Eigen::MatrixBase<Derived>& x,
+                            const core::SparsityPattern& pattern)
+{
+    using value_t = typename Derived::Scalar;
+    using f_t = std::remove_reference_t<F>;
+    using matrix_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
+    const size_t m = pattern.rows();
+    const size_t n = x.size();
+    assert(pattern.cols.size() == n);
+
+    std::vector<Eigen::Triplet<value_t>> triplets;
+    triplets.reserve(pattern.n_nonzeros());
+
+    auto col_coloring = core::color_columns(pattern);
+    auto pattern_t = pattern.transpose();
+    auto row_coloring = core::color_columns(pattern_t);
+
+    if (col_coloring.n_colors <= row_coloring.n_colors) {
+        core::JacobianWorker<value_t, K, f_t, true> worker(f, x);
+        for (size_t c0 = 0; c0 < col_coloring.n_colors; c0 += K) {
+            size_t k = std::min<size_t>(K, col_coloring.n_colors - c0);
+            matrix_t S = matrix_t::Zero(n, k);
+            for (size_t j = 0; j < n; ++j) {
+                size_t c = col_coloring.color[j];
+                if (c0 <= c && c < c0 + k) S(j, c - c0) = 1;
+            }
+            matrix_t JS(m, k);
+            worker.jvp(S, JS);
+            for (size_t j = 0; j < n; ++j) {
+                size_t c = col_coloring.color[j];
+                if (c < c0 || c >= c0 + k) continue;
+                for (auto i : pattern.cols[j]) {
+                    triplets.emplace_back(i, j, JS(i, c - c0));
+                }
+            }
+        }
+    } else {
+        core::JacobianWorker<value_t, K, f_t, false> worker(f, x);
+        for (size_t c0 = 0; c0 < row_coloring.n_colors; c0 += K) {
+            size_t k = std::min<size_t>(K, row_coloring.n_colors - c0);
+            matrix_t W = matrix_t::Zero(m, k);
+            for (size_t i = 0; i < m; ++i) {
+                size_t c = row_coloring.color[i];
+                if (c0 <= c && c < c0 + k) W(i, c - c0) = 1;
+            }
+            matrix_t WJ(k, n);
+            worker.vjp(W, WJ);
+            for (size_t i = 0; i < m; ++i) {
+                size_t c = row_coloring.color[i];
+                if (c < c0 || c >= c0 + k) continue;
+                for (auto j : pattern_t.cols[i]) {
+                    triplets.emplace_back(i, j, WJ(c - c0, j));
+                }
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<value_t> J(m, n);
+    J.setFromTriplets(triplets.begin(), triplets.end());
+    return J;
+}
+
+/**
+ * Same as sparse_jacobian(f, x, pattern) but detects the pattern first.
+ */
+template <int K = 4, class F, class Derived>
+inline auto sparse_jacobian(F&& f, const Eigen::MatrixBase<Derived>& x)
+{
+    return sparse_jacobian<K>(f, x, jacobian_sparsity(f, x));
+}
+
+/**
+ * Computes the Hessian of the scalar expression f at x given its sparsity pattern.
+ * The columns are colored so that the columns of one color are computed together
+ * by a single Hessian-vector product (see hessian_vector),
+ * so the cost scales with the number of colors instead of the number of inputs.
+ *
+ * @param   f       functor creating the scalar expression (see hessian(f, x))
+ * @param   x       point at which the Hessian is computed
+ * @param   pattern sparsity pattern of the Hessian
+ * @return  Hessian as a (column-major) Eigen::SparseMatrix
+ */
+template <class F, class Derived>
+inline auto sparse_hessian(F&& f,
+                           const Eigen::MatrixBase<Derived>& x,
+                           const core::SparsityPattern& pattern)
+{
+    using value_t = typename Derived::Scalar;
+    using vector_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+    const size_t n = x.size();
+    assert(pattern.cols.size() == n);
+
+    std::vector<Eigen::Triplet<value_t>> triplets;
+    triplets.reserve(pattern.n_nonzeros());
+
+    auto coloring = core::color_columns(pattern);
+    core::HessianWorker<value_t, std::remove_reference_t<F>> worker(f, x);
+    vector_t v(n), hv(n);
+    for (size_t c = 0; c < coloring.n_colors; ++c) {
+        for (size_t j = 0; j < n; ++j) v(j) = (coloring.color[j] == c);
+        worker.run(v);
+        worker.hessian_vector(hv);
+        for (size_t j = 0; j < n; ++j) {
+            if (coloring.color[j] != c) continue;
+            for (auto i : pattern.cols[j]) {
+                triplets.emplace_back(i, j, hv(i));
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<value_t> H(n, n);
+    H.setFromTriplets(triplets.begin(), triplets.end());
+    return H;
+}
+
+/**
+ * Same as sparse_hessian(f, x, pattern) but detects the pattern first.
+ */
+template <class F, class Derived>
+inline auto sparse_hessian(F&& f, const Eigen::MatrixBase<Derived>& x)
+{
+    return sparse_hessian(f, x, hessian_sparsity(f, x));
+}
+
+} // namespace ad
@@ -1,8 +1,13 @@
 #pragma once
+#include <algorithm>
 #include <iterator>
+#include <vector>
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/adj_buffer.hpp>
+#include <fastad_bits/reverse/core/parallel.hpp>
 #include <fastad_bits/util/size_pack.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
@@ -42,10 +47,14 @@ public:
     using typename value_adj_view_t::ptr_pack_t;
 
     SumIterNode(const VecType& exprs)
+        : SumIterNode(VecType(exprs))
+    {}
+
+    SumIterNode(VecType&& exprs)
         : value_adj_view_t(nullptr, nullptr,
                        (exprs.size() == 0) ? 0 : exprs[0].rows(),
                        (exprs.size() == 0) ? 0 : exprs[0].cols())
-        , exprs_{exprs}
+        , exprs_{std::move(exprs)}
     {}
 
     /** 
@@ -78,22 +87,203 @@ public:
         if (exprs_.empty()) return;
         auto&& a_adj = util::to_array(this->get_adj());
         a_adj = seed;
-        std::for_each(exprs_.rbegin(), exprs_.rend(),
-            [&](auto& expr) {
-                expr.beval(a_adj);
-            });
+        if (active_.empty()) {
+            std::for_each(exprs_.rbegin(), exprs_.rend(),
+                [&](auto& expr) {
+                    expr.beval(a_adj);
+                });
+            return;
+        }
+        for (size_t i = exprs_.size(); i-- > 0;) {
+            if (active_[i]) exprs_[i].beval(a_adj);
+        }
     }
 
     /**
      * Bind every expression from left to right then bind itself.
+     * Expressions that only read frozen leaves are not backward evaluated
+     * (see details::bind_active).
      *
      * @return  the next pointer not bound by any of the expressions and itself.
      */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        for (auto& expr : exprs_) {
+        active_ = details::bind_activity(exprs_, [&](auto& expr) {
             begin = expr.bind_cache(begin);
+        });
+        return value_adj_view_t::bind(begin);
+    }
+
+    util::SizePack bind_cache_size() const 
+    { 
+        util::SizePack out = util::SizePack::Zero();
+        for (const auto& expr : exprs_) {
+            out += expr.bind_cache_size();
+        }
+        return out + single_bind_cache_size();
+    }
+
+    util::SizePack single_bind_cache_size() const
+    { 
+        return {this->size(), this->size()}; 
+    }
+
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        for (auto& expr : exprs_) {
+            expr.visit(v);
         }
+    }
+
+private:
+    std::vector<vec_elem_t> exprs_;
+    std::vector<bool> active_;  // empty if every expression is active
+};
+
+/** 
+ * ParSumIterNode is the multi-threaded counterpart of SumIterNode.
+ * The expressions are split into contiguous chunks that are evaluated
+ * on the threads of the pool given by the ParallelPolicy.
+ *
+ * Forward evaluation accumulates each chunk into a partial sum,
+ * then reduces the partial sums on the calling thread.
+ *
+ * Every chunk is bound with its own AdjBuffer
+ * so that leaves shared across expressions (e.g. model parameters)
+ * are never updated concurrently during backward evaluation.
+ * Once all chunks are done, the buffers are flushed into the leaf adjoints
+ * in chunk order, so adjoints do not depend on how chunks were scheduled.
+ * If the policy is deterministic, there is exactly one chunk per partial sum
+ * and values do not depend on it either.
+ *
+ * Every expression must be independent of the others except through
+ * shared leaves, i.e. expressions must not define placeholders.
+ * Expressions that themselves use the pool of the policy (e.g. a nested parallel sum)
+ * do not deadlock but their evaluation runs serially on the thread evaluating them,
+ * since the pool runs one job at a time (see util::ThreadPool).
+ *
+ * @tparam  VecType     type of vector of expressions to sum over 
+ */
+
+template <class VecType>
+struct ParSumIterNode:
+    ValueAdjView<typename util::expr_traits< 
+                    typename VecType::value_type >::value_t,
+                 typename util::shape_traits< 
+                    typename VecType::value_type >::shape_t >,
+    ExprBase<ParSumIterNode<VecType>>
+{
+private:
+    using vec_elem_t = typename VecType::value_type;
+    using elem_value_t = typename util::expr_traits<vec_elem_t>::value_t;
+    using elem_shape_t = typename util::shape_traits<vec_elem_t>::shape_t;
+    using adj_buffer_t = AdjBuffer<elem_value_t>;
+    using value_view_t = ValueView<elem_value_t, elem_shape_t>;
+
+    // number of chunks per thread when scheduling dynamically
+    static constexpr size_t chunks_per_thread_ = 8;
+    
+public:
+    using value_adj_view_t = ValueAdjView<elem_value_t, elem_shape_t>;
+    using typename value_adj_view_t::value_t;
+    using typename value_adj_view_t::shape_t;
+    using typename value_adj_view_t::var_t;
+    using typename value_adj_view_t::ptr_pack_t;
+
+    ParSumIterNode(const VecType& exprs,
+                   const ParallelPolicy& policy)
+        : ParSumIterNode(VecType(exprs), policy)
+    {}
+
+    ParSumIterNode(VecType&& exprs,
+                   const ParallelPolicy& policy)
+        : value_adj_view_t(nullptr, nullptr,
+                       (exprs.size() == 0) ? 0 : exprs[0].rows(),
+                       (exprs.size() == 0) ? 0 : exprs[0].cols())
+        , exprs_{std::move(exprs)}
+        , policy_{policy}
+        , n_chunks_(std::min(exprs_.size(), 
+                    policy.n_threads() * (policy.deterministic ? 1 : chunks_per_thread_)))
+        , n_partials_(policy.deterministic ? n_chunks_ : policy.n_threads())
+        , partials_(n_partials_ * this->size(), 0)
+        , adj_bufs_(n_chunks_)
+    {}
+
+    /** 
+     * Forward evaluate every chunk in parallel into its partial sum
+     * and accumulate the partial sums in order.
+     *
+     * @return forward evaluation of sum of functor on every expr.
+     */
+    const var_t& feval()
+    {
+        std::fill(partials_.begin(), partials_.end(), 0);
+        policy_.pool->parallel_for(n_chunks_,
+            [&](size_t chunk, size_t worker) {
+                value_view_t partial = get_partial(partial_id(chunk, worker));
+                for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk+1); ++i) {
+                    partial.get() += exprs_[i].feval();
+                }
+            });
+        this->zero();
+        for (size_t k = 0; k < n_partials_; ++k) {
+            this->get() += get_partial(k).get();
+        }
+        return this->get();
+    }
+
+    /** 
+     * Backward evaluate every chunk in parallel from right to left
+     * into the chunk's AdjBuffer, then flush the buffers in order.
+     */
+    template <class T>
+    void beval(const T& seed)
+    {
+        if (exprs_.empty()) return;
+        auto&& a_adj = util::to_array(this->get_adj());
+        a_adj = seed;
+        policy_.pool->parallel_for(n_chunks_,
+            [&](size_t chunk, size_t) {
+                const size_t begin = chunk_begin(chunk);
+                if (active_.empty()) {
+                    for (size_t i = chunk_begin(chunk+1); i-- > begin;) {
+                        exprs_[i].beval(a_adj);
+                    }
+                    return;
+                }
+                for (size_t i = chunk_begin(chunk+1); i-- > begin;) {
+                    if (active_[i]) exprs_[i].beval(a_adj);
+                }
+            });
+        for (auto& buf : adj_bufs_) {
+            buf.flush();
+        }
+    }
+
+    /**
+     * Bind every expression from left to right then bind itself.
+     * Every expression gets its own disjoint cache so that they can be
+     * evaluated concurrently,
+     * and the leaves of every chunk view their adjoints in the chunk's AdjBuffer.
+     * Expressions that only read frozen leaves are not backward evaluated
+     * (see details::bind_active).
+     *
+     * @return  the next pointer not bound by any of the expressions and itself.
+     */
+    ptr_pack_t bind_cache(ptr_pack_t begin)
+    {
+        for (auto& buf : adj_bufs_) {
+            buf.clear();
+        }
+        size_t i = 0;
+        size_t chunk = 0;
+        active_ = details::bind_activity(exprs_, [&](auto& expr) {
+            while (chunk_begin(chunk+1) <= i) ++chunk;
+            AdjBufferGuard<value_t> guard(adj_bufs_[chunk]);
+            begin = expr.bind_cache(begin);
+            ++i;
+        });
         return value_adj_view_t::bind(begin);
     }
 
@@ -111,8 +301,38 @@ public:
         return {this->size(), this->size()}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        for (auto& expr : exprs_) {
+            expr.visit(v);
+        }
+    }
+
 private:
+    size_t chunk_begin(size_t chunk) const
+    {
+        return (chunk * exprs_.size()) / n_chunks_;
+    }
+
+    size_t partial_id(size_t chunk, size_t worker) const
+    {
+        return policy_.deterministic ? chunk : worker;
+    }
+
+    value_view_t get_partial(size_t k)
+    {
+        return value_view_t(partials_.data() + k * this->size(),
+                            this->rows(), this->cols());
+    }
+
     std::vector<vec_elem_t> exprs_;
+    ParallelPolicy policy_;
+    size_t n_chunks_;
+    size_t n_partials_;
+    std::vector<value_t> partials_;
+    std::vector<adj_buffer_t> adj_bufs_;
+    std::vector<bool> active_;  // empty if every expression is active
 };
 
 /** 
@@ -198,6 +418,12 @@ public:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
 private:
     expr_t expr_;
 };
@@ -236,7 +462,32 @@ inline auto sum(Iter begin, Iter end, Lmda&& f)
                 [&](const auto& x) {
                     exprs.emplace_back(f(x));
                 });
-        return core::SumIterNode<std::vector<expr_t>>(exprs);
+        return core::SumIterNode<std::vector<expr_t>>(std::move(exprs));
+    }
+}
+
+/**
+ * Helper function to create a ParSumIterNode, 
+ * which evaluates the summands in parallel according to policy.
+ * If each expression type is constant, the result is the same
+ * eagerly evaluated constant as the sequential version.
+ */
+template <class Iter, class Lmda>
+inline auto sum(const ParallelPolicy& policy, Iter begin, Iter end, Lmda&& f)
+{
+    using expr_t = std::decay_t<decltype(f(*begin))>;
+
+    if constexpr (util::is_constant_v<expr_t>) {
+        static_cast<void>(policy);
+        return ad::sum(begin, end, std::forward<Lmda>(f));
+    } else {
+        std::vector<expr_t> exprs;
+        exprs.reserve(std::distance(begin, end));
+        std::for_each(begin, end, 
+                [&](const auto& x) {
+                    exprs.emplace_back(f(x));
+                });
+        return core::ParSumIterNode<std::vector<expr_t>>(std::move(exprs), policy);
     }
 }
 
@@ -55,6 +55,12 @@ struct TransposeNode : ValueAdjView<typename util::expr_traits<ExprType>::value_
 
     util::SizePack single_bind_cache_size() const { return {this->size(), this->size()}; }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
   private:
     expr_t expr_;
 };
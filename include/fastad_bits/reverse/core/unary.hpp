@@ -115,6 +115,16 @@ public:
         return {this->size(), this->size()};
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        expr_.visit(v);
+    }
+
+    // Underlying expression (see FusedNode).
+    expr_t& expr() { return expr_; }
+    const expr_t& expr() const { return expr_; }
+
 private:
     expr_t expr_;
 };
@@ -223,7 +233,8 @@ UNARY_STRUCT(Arcsin,
              return asin(x);, 
              static_cast<void>(f); 
              USING_STD_AD_EIGEN(sqrt);
-             return seed / sqrt(1. - x * x););
+             using c_t = util::literal_t<T>;
+             return seed / sqrt(c_t(1) - x * x););
 
 // Arccos struct (degrees)
 UNARY_STRUCT(Arccos, 
@@ -237,7 +248,8 @@ UNARY_STRUCT(Arctan,
              USING_STD_AD_EIGEN(atan);
              return atan(x);, 
              static_cast<void>(f); 
-             return seed / (1. + x * x););
+             using c_t = util::literal_t<T>;
+             return seed / (c_t(1) + x * x););
 
 // Exp struct
 UNARY_STRUCT(Exp, 
@@ -258,41 +270,48 @@ UNARY_STRUCT(Sqrt,
              USING_STD_AD_EIGEN(sqrt);
              return sqrt(x);,
              static_cast<void>(x);
-             return 0.5 * seed / f;);
+             using c_t = util::literal_t<U>;
+             return c_t(0.5) * seed / f;);
 
 // Erf struct
 UNARY_STRUCT(Erf,
              USING_STD_AD_EIGEN(erf);
              return erf(x);,
              static_cast<void>(f); 
-             static constexpr double two_over_sqrt_pi =
-                1.1283791670955126;
+             using c_t = util::literal_t<T>;
+             static constexpr c_t two_over_sqrt_pi =
+                c_t(1.1283791670955126);
              return two_over_sqrt_pi * seed * Exp::fmap(-x * x););
 
 // sigmoid
 UNARY_STRUCT(Sigmoid, 
              USING_STD_AD_EIGEN(exp);
              return 1/(1+exp(-x));, 
-             static_cast<void>(x); 
-             return seed * exp(-x)/((exp(-x)+1)*(exp(-x)+1)););
+             static_cast<void>(x);
+             return seed * f * (1 - f););
 
 // sinh
 UNARY_STRUCT(Sinh, 
-             //USING_STD_AD_EIGEN(tanh);
-             return Eigen::sinh(x);, 
+             using std::sinh;
+             using Eigen::sinh;
+             return sinh(x);, 
              static_cast<void>(f); 
-             return seed *(Eigen::cosh(x)););
+             using std::cosh;
+             using Eigen::cosh;
+             return seed * cosh(x););
 // cosh
 UNARY_STRUCT(Cosh, 
-             //USING_STD_AD_EIGEN(tanh);
-             return Eigen::cosh(x);, 
+             using std::cosh;
+             using Eigen::cosh;
+             return cosh(x);, 
              static_cast<void>(f); 
-             return seed *(Eigen::sinh(x)););			 
+             return seed * Sinh::fmap(x););
 // tanh
 UNARY_STRUCT(Tanh, 
-             //USING_STD_AD_EIGEN(tanh);
-             return Eigen::tanh(x);, 
-             static_cast<void>(f); 
+             using std::tanh;
+             using Eigen::tanh;
+             return tanh(x);, 
+             static_cast<void>(x); 
              return seed *(1-f*f););
 			 
 // operator- (IMPORTANT TO DECLARE IN core)
@@ -11,6 +11,14 @@ namespace ad {
  * ShapeType must be one of scl, vec, or mat.
  * All other specializations are disabled (see VarView).
  *
+ * A variable can be frozen to hold it fixed while other variables are updated
+ * (e.g. block-wise or Gibbs-style updates).
+ * Subexpressions that only read frozen variables are not backward evaluated,
+ * so the adjoints of frozen variables are not updated.
+ * Expressions find out which variables are frozen when they are bound,
+ * so bound expressions must be rebound (see ExprBind::rebind)
+ * after variables are frozen or unfrozen.
+ *
  * @tparam ValueType    underlying data type
  * @tparam ShapeType    shape of variable (one of scl, vec, mat, selfadjmat).
  *                      Default is scl.
@@ -37,24 +45,26 @@ public:
         : base_t(&val_, &adj_) 
         , val_(0)
         , adj_(0)
-    {}
+    { rebind(); }
 
     explicit Var(value_t v)
         : base_t(&val_, &adj_)
         , val_(v)
         , adj_(0)
-    {}
+    { rebind(); }
 
     Var(const Var& v)
         : base_t(v)
         , val_(v.val_)
         , adj_(v.adj_)
+        , frozen_(v.frozen_)
     { rebind(); }
 
     Var(Var&& v)
         : base_t(std::move(v))
         , val_(std::move(v.val_))
         , adj_(std::move(v.adj_))
+        , frozen_(v.frozen_)
     { rebind(); }
 
     Var& operator=(const Var& v)
@@ -64,6 +74,7 @@ public:
         assert(v.cols() == this->cols());
         val_ = v.val_;
         adj_ = v.adj_;
+        frozen_ = v.frozen_;
         rebind();
         return *this;
     }
@@ -75,18 +86,24 @@ public:
         assert(v.cols() == this->cols());
         val_ = std::move(v.val_);
         adj_ = std::move(v.adj_);
+        frozen_ = v.frozen_;
         rebind();
         return *this;
     }
 
+    void freeze() { frozen_ = true; }
+    void unfreeze() { frozen_ = false; }
+
 private:
     void rebind() 
     {
         this->bind({&val_, &adj_});
+        this->bind_frozen(&frozen_);
     }
 
     value_t val_;
     value_t adj_;
+    bool frozen_ = false;
 };
 
 template <class ValueType>
@@ -114,12 +131,14 @@ public:
         : base_t(v)
         , val_(v.val_)
         , adj_(v.adj_)
+        , frozen_(v.frozen_)
     { rebind(); }
 
     Var(Var&& v)
         : base_t(std::move(v))
         , val_(std::move(v.val_))
         , adj_(std::move(v.adj_))
+        , frozen_(v.frozen_)
     { rebind(); }
 
     Var& operator=(const Var& v)
@@ -129,6 +148,7 @@ public:
         assert(v.cols() == this->cols());
         val_ = v.val_;
         adj_ = v.adj_;
+        frozen_ = v.frozen_;
         rebind();
         return *this;
     }
@@ -140,18 +160,24 @@ public:
         assert(v.cols() == this->cols());
         val_ = std::move(v.val_);
         adj_ = std::move(v.adj_);
+        frozen_ = v.frozen_;
         rebind();
         return *this;
     }
 
+    void freeze() { frozen_ = true; }
+    void unfreeze() { frozen_ = false; }
+
 private:
     void rebind() 
     {
         this->bind({val_.data(), adj_.data()});
+        this->bind_frozen(&frozen_);
     }
 
     vec_t val_;
     vec_t adj_;
+    bool frozen_ = false;
 };
 
 template <class ValueType>
@@ -179,12 +205,14 @@ public:
         : base_t(v)
         , val_(v.val_)
         , adj_(v.adj_)
+        , frozen_(v.frozen_)
     { rebind(); }
 
     Var(Var&& v)
         : base_t(std::move(v))
         , val_(std::move(v.val_))
         , adj_(std::move(v.adj_))
+        , frozen_(v.frozen_)
     { rebind(); }
 
     Var& operator=(const Var& v)
@@ -194,6 +222,7 @@ public:
         assert(v.cols() == this->cols());
         val_ = v.val_;
         adj_ = v.adj_;
+        frozen_ = v.frozen_;
         rebind();
         return *this;
     }
@@ -205,22 +234,31 @@ public:
         assert(v.cols() == this->cols());
         val_ = std::move(v.val_);
         adj_ = std::move(v.adj_);
+        frozen_ = v.frozen_;
         rebind();
         return *this;
     }
 
+    void freeze() { frozen_ = true; }
+    void unfreeze() { frozen_ = false; }
+
 private:
     void rebind() 
     {
         this->bind({val_.data(), adj_.data()});
+        this->bind_frozen(&frozen_);
     }
 
     mat_t val_;
     mat_t adj_;
+    bool frozen_ = false;
 };
 
 template struct Var<double, scl>;
 template struct Var<double, vec>;
 template struct Var<double, mat>;
+template struct Var<float, scl>;
+template struct Var<float, vec>;
+template struct Var<float, mat>;
 
 } // namespace ad
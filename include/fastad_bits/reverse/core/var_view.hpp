@@ -1,10 +1,12 @@
 #pragma once
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/util/shape_traits.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/value.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/adj_buffer.hpp>
 #include <Eigen/Core>
 
 namespace ad {
@@ -56,7 +58,7 @@ struct VarViewBase<VarView<ValueType, ShapeType>>:
                 util::is_convertible_to_ad_v<Derived>> >
     inline auto operator=(const Derived& x) const
     {
-        using expr_t = util::convert_to_ad_t<Derived>;
+        using expr_t = util::convert_to_ad_like_t<Derived, var_view_t>;
         expr_t expr = x;
         return EqNode<var_view_t, expr_t>(
                 static_cast<const var_view_t&>(*this), expr);
@@ -89,17 +91,71 @@ struct VarViewBase<VarView<ValueType, ShapeType>>:
      * Helper to_array function converts them properly to make the operation make sense in all cases.
      */
     template <class T>
-    void beval(const T& seed) { 
-        util::to_array(this->get_adj()) += seed; 
-    }
+    void beval(const T& seed) { util::to_array(this->get_adj()) += seed; }
 
     /**
      * Cache bind size is 0 since it will never get rebound once an expression is constructed.
+     * Binding reports whether the view is frozen (see details::ActivityScope)
+     * and, if an AdjBuffer is installed on the current thread (see ParSumIterNode),
+     * redirects the viewed adjoint to the buffer.
+     * Binding again without a buffer views the adjoint of the variable again.
      */
     template <class T>
-    constexpr T bind_cache(T begin) { return begin; }
+    T bind_cache(T begin)
+    {
+        details::ActivityScope::read(is_frozen());
+        value_t* leaf = leaf_adj();
+        value_t* adj = leaf;
+        if (auto* buf = AdjBuffer<value_t>::current()) {
+            adj = buf->get(leaf, this->size());
+        }
+        origin_adj_ = (adj == leaf) ? nullptr : leaf;
+        value_adj_view_t::bind({this->data(), adj});
+        return begin;
+    }
     util::SizePack bind_cache_size() const { return {0,0}; }
     util::SizePack single_bind_cache_size() const { return {0,0}; }
+
+    /**
+     * Every expression node implements visit(v), which recursively visits
+     * its subexpressions in forward-evaluation order.
+     * Leaves report themselves with v.read(view),
+     * and nodes that assign to a placeholder (EqNode, OpEqNode) additionally
+     * report the placeholder with v.write(view).
+     * This is how dependencies between statements are computed at bind time.
+     */
+    template <class Visitor>
+    void visit(Visitor& v) 
+    { 
+        if (!origin_adj_) {
+            v.read(static_cast<var_view_t&>(*this)); 
+            return;
+        }
+        // report the variable, not the buffer its adjoint is redirected to
+        var_view_t leaf = static_cast<var_view_t&>(*this);
+        static_cast<VarViewBase&>(leaf).unbind_adj_buffer();
+        v.read(leaf);
+    }
+
+    /**
+     * A view is frozen if the variable it views is frozen (see Var::freeze).
+     * Views made from raw pointers view no flag and are never frozen.
+     */
+    bool is_frozen() const { return frozen_ && *frozen_; }
+    const bool* frozen_flag() const { return frozen_; }
+    void bind_frozen(const bool* frozen) { frozen_ = frozen; }
+
+private:
+    value_t* leaf_adj() { return origin_adj_ ? origin_adj_ : this->data_adj(); }
+
+    void unbind_adj_buffer()
+    {
+        value_adj_view_t::bind({this->data(), leaf_adj()});
+        origin_adj_ = nullptr;
+    }
+
+    const bool* frozen_ = nullptr;
+    value_t* origin_adj_ = nullptr;  // adjoint of the variable if redirected
 };
 
 } // namespace core
@@ -143,6 +199,9 @@ struct VarView<ValueType, vec>:
     using typename base_t::value_t;
     using base_t::operator=;
 
+    // unbound view (see Workspace)
+    explicit VarView(size_t rows) : VarView(nullptr, nullptr, rows) {}
+
     VarView(value_t* val,
             value_t* adj,
             size_t rows,
@@ -150,25 +209,31 @@ struct VarView<ValueType, vec>:
         : base_t(val, adj, rows, 1)
     {}
 
-    // subviews
+    // subviews (frozen if this view is frozen)
     auto operator()(size_t i) {
         assert(i < base_t::size());
-        return VarView<value_t, scl>(base_t::data() + i, 
-                                     base_t::data_adj() + i);
+        VarView<value_t, scl> out(base_t::data() + i, 
+                                  base_t::data_adj() + i);
+        out.bind_frozen(base_t::frozen_flag());
+        return out;
     }
     auto operator[](size_t i) {
         return operator()(i);
     }
     auto head(size_t n) {
         assert(n <= base_t::size());
-        return VarView(base_t::data(), base_t::data_adj(), n);
+        VarView out(base_t::data(), base_t::data_adj(), n);
+        out.bind_frozen(base_t::frozen_flag());
+        return out;
     }
     auto tail(size_t n) {
         assert(n <= base_t::size());
         size_t offset = base_t::size() - n;
-        return VarView(base_t::data() + offset, 
-                       base_t::data_adj() + offset,
-                       n);
+        VarView out(base_t::data() + offset, 
+                    base_t::data_adj() + offset,
+                    n);
+        out.bind_frozen(base_t::frozen_flag());
+        return out;
     }
 };
 
@@ -180,6 +245,9 @@ struct VarView<ValueType, mat>:
     using typename base_t::value_t;
     using base_t::operator=;
 
+    // unbound view (see Workspace)
+    VarView(size_t rows, size_t cols) : VarView(nullptr, nullptr, rows, cols) {}
+
     VarView(value_t* val,
             value_t* adj,
             size_t rows,
@@ -192,6 +260,9 @@ struct VarView<ValueType, mat>:
 template struct VarView<double, scl>;
 template struct VarView<double, vec>;
 template struct VarView<double, mat>;
+template struct VarView<float, scl>;
+template struct VarView<float, vec>;
+template struct VarView<float, mat>;
 
 /*
  * Useful operator overloads
@@ -206,7 +277,7 @@ template struct VarView<double, mat>;
                      const Derived& x)  \
     { \
         using var_view_t = VarView<ValueType, ShapeType>; \
-        using expr_t = util::convert_to_ad_t<Derived>; \
+        using expr_t = util::convert_to_ad_like_t<Derived, var_view_t>; \
         expr_t expr = x; \
         return core::OpEqNode<core::strct, var_view_t, expr_t>(var, expr); \
     } 
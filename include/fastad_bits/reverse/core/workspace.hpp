@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <Eigen/Core>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/var_view.hpp>
+#include <fastad_bits/util/cache_pool.hpp>
+#include <fastad_bits/util/type_traits.hpp>
+
+namespace ad {
+namespace core {
+
+/**
+ * Workspace owns the values and adjoints of a set of leaves
+ * in one contiguous aligned block and binds the leaves to it, e.g.
+ *
+ *      VarView<double> x;
+ *      VarView<double, vec> v(3);
+ *      std::vector<VarView<double>> w(2);
+ *      Workspace<double> ws(x, v, w);
+ *
+ * binds x, v(0), ..., v(2), w[0], w[1] to the values ws.values()(0), ..., ws.values()(5)
+ * and the adjoints ws.adjoints()(0), ..., ws.adjoints()(5).
+ * Parameters are thus copied in and gradients out through one flat Eigen::Map,
+ * and all adjoints are reset with a single memset.
+ *
+ * Only the leaves and placeholders accumulate into their adjoints.
+ * Every other node overwrites its adjoint cache during backward evaluation,
+ * so resetting the workspace is all that is needed between two evaluations
+ * of expressions built from its leaves.
+ *
+ * Leaves must be VarView objects (or ranges of them) and not Var,
+ * since a Var rebinds to its own storage when copied.
+ * The workspace must outlive the leaves' use; moving it keeps them bound.
+ *
+ * @tparam  ValueType   type of values
+ */
+
+template <class ValueType>
+struct Workspace
+{
+    using value_t = ValueType;
+    using vector_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
+    using map_t = Eigen::Map<vector_t>;
+    using const_map_t = Eigen::Map<const vector_t>;
+
+    template <class... Leaves>
+    explicit Workspace(Leaves&... leaves)
+        : size_((0 + ... + n_values(leaves)))
+        , adj_offset_(padded(size_))
+        , buf_(adj_offset_ + size_)
+    {
+        reset_values();
+        reset_adj();
+        value_t* val = buf_.data();
+        value_t* adj = val + adj_offset_;
+        (for_each_leaf(leaves, [&](auto& leaf) {
+            leaf.bind({val, adj});
+            val += leaf.size();
+            adj += leaf.size();
+        }), ...);
+    }
+
+    Workspace(const Workspace&) =delete;
+    Workspace& operator=(const Workspace&) =delete;
+    Workspace(Workspace&&) =default;
+    Workspace& operator=(Workspace&&) =default;
+
+    size_t size() const { return size_; }
+
+    map_t values() { return map_t(buf_.data(), size_); }
+    const_map_t values() const { return const_map_t(buf_.data(), size_); }
+    map_t adjoints() { return map_t(buf_.data() + adj_offset_, size_); }
+    const_map_t adjoints() const { return const_map_t(buf_.data() + adj_offset_, size_); }
+
+    /**
+     * Sets every adjoint to 0.
+     */
+    void reset_adj() { zero(buf_.data() + adj_offset_, size_); }
+
+private:
+    static void zero(value_t* begin, size_t n)
+    {
+        if constexpr (std::is_trivially_copyable_v<value_t>) {
+            std::memset(static_cast<void*>(begin), 0, n * sizeof(value_t));
+        } else {
+            std::fill_n(begin, n, value_t(0));
+        }
+    }
+
+    void reset_values() { zero(buf_.data(), size_); }
+
+    // Applies f on leaf if it is a VarView and on every element otherwise.
+    template <class Leaf, class F>
+    static void for_each_leaf(Leaf& leaf, F&& f)
+    {
+        if constexpr (util::is_var_view_v<Leaf>) {
+            static_assert(std::is_same_v<typename Leaf::value_t, value_t>);
+            f(leaf);
+        } else {
+            for (auto& l : leaf) for_each_leaf(l, f);
+        }
+    }
+
+    template <class Leaf>
+    static size_t n_values(Leaf& leaf)
+    {
+        size_t n = 0;
+        for_each_leaf(leaf, [&](const auto& l) { n += l.size(); });
+        return n;
+    }
+
+    // Rounds n up so that the adjoints start on an aligned address.
+    static size_t padded(size_t n)
+    {
+        constexpr size_t align = std::max<size_t>(
+                util::CachePool::alignment / sizeof(value_t), 1);
+        return (n + align - 1) / align * align;
+    }
+
+    size_t size_;
+    size_t adj_offset_;
+    CacheBuffer<value_t> buf_;
+};
+
+} // namespace core
+
+template <class ValueType>
+using Workspace = core::Workspace<ValueType>;
+
+} // namespace ad
@@ -56,6 +56,13 @@ struct BernoulliBase:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        x_.visit(v);
+        p_.visit(v);
+    }
+
 protected:
     x_t x_;
     p_t p_;
@@ -357,7 +364,7 @@ public:
         auto adj = vec_t::NullaryExpr(x.size(),
                 [&](size_t i) {
                     return (0. < p(i) && p(i) < 1.) ?
-                               ( (x(i) == 1) ? seed / p(i) : (-seed) / (1. - p(i)) ) :
+                               ( (x(i) == 1) ? seed / p(i) : (-seed) / (1 - p(i)) ) :
                                0.;
                 });
         p_.beval(adj);
@@ -390,7 +397,7 @@ inline auto bernoulli_adj_log_pdf(const XType& x,
                                   const PType& p)
 {
     using x_expr_t = util::convert_to_ad_t<XType>;
-    using p_expr_t = util::convert_to_ad_t<PType>;
+    using p_expr_t = util::convert_to_ad_like_t<PType, XType>;
     x_expr_t x_expr = x;
     p_expr_t p_expr = p;
     return stat::BernoulliAdjLogPDFNode<
@@ -65,6 +65,14 @@ struct CauchyBase:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        x_.visit(v);
+        loc_.visit(v);
+        scale_.visit(v);
+    }
+
 protected:
     x_t x_;
     loc_t loc_;
@@ -155,9 +163,9 @@ public:
         auto&& gamma = scale_.get();
 
         auto diff = x-x0;
-        auto x0_adj = 2. * diff / (gamma * inner_term_);
+        auto x0_adj = 2 * diff / (gamma * inner_term_);
         auto x_adj = -x0_adj;
-        auto gamma_adj = 1./gamma * (x0_adj * diff - 1);
+        auto gamma_adj = 1/gamma * (x0_adj * diff - 1);
 
         scale_.beval(seed * gamma_adj);
         loc_.beval(seed * x0_adj);
@@ -214,7 +222,7 @@ public:
         }
 
         auto diff_sq = (x.array() - x0).square();
-        return this->get() = -(gamma + (1./gamma) * diff_sq).log().sum();
+        return this->get() = -(gamma + (1/gamma) * diff_sq).log().sum();
     }
 
     void beval(value_t seed)
@@ -227,7 +235,7 @@ public:
         auto gamma_sq = gamma * gamma;
 
         auto diff = (x - x0);
-        auto dx = (-2. * seed) * diff / (gamma_sq + diff.square());
+        auto dx = (-2 * seed) * diff / (gamma_sq + diff.square());
         value_t dx0 = (-seed) * dx.sum();
         value_t dgamma = (-seed/gamma) * ((dx * diff).sum() + x.size());
         
@@ -296,7 +304,7 @@ public:
         auto&& gamma = scale_.get().array();
 
         auto diff = x - x0;
-        auto dx = (-2. * seed) * diff / (gamma.square() + diff.square());
+        auto dx = (-2 * seed) * diff / (gamma.square() + diff.square());
         value_t dx0 = (-seed) * dx.sum();
         auto dgamma = (-seed) * (dx * diff + 1) / gamma;
 
@@ -353,7 +361,7 @@ public:
         }
 
         auto diff = x - x0;
-        return this->get() = -(gamma + (1./gamma) * diff.square()).log().sum();
+        return this->get() = -(gamma + (1/gamma) * diff.square()).log().sum();
     }
 
     void beval(value_t seed)
@@ -366,7 +374,7 @@ public:
         auto gamma_sq = gamma * gamma;
 
         auto diff = (x - x0);
-        auto dx = (-2. * seed) * diff / (gamma_sq + diff.square());
+        auto dx = (-2 * seed) * diff / (gamma_sq + diff.square());
         auto dx0 = (-seed) * dx;
         value_t dgamma = (-seed/gamma) * ((dx * diff).sum() + x.size());
 
@@ -435,7 +443,7 @@ public:
         auto&& gamma = scale_.get().array();
 
         auto diff = (x - x0);
-        auto dx = (-2. * seed) * diff / (gamma.square() + diff.square());
+        auto dx = (-2 * seed) * diff / (gamma.square() + diff.square());
         auto dx0 = (-seed) * dx;
         auto dgamma = (-seed/gamma) * ((dx * diff) + 1);
 
@@ -464,9 +472,9 @@ inline auto cauchy_adj_log_pdf(const XType& x,
                                const LocType& loc,
                                const ScaleType& scale)
 {
-    using x_expr_t = util::convert_to_ad_t<XType>;
-    using loc_expr_t = util::convert_to_ad_t<LocType>;
-    using scale_expr_t = util::convert_to_ad_t<ScaleType>;
+    using x_expr_t = util::convert_to_ad_like_t<XType, LocType, ScaleType>;
+    using loc_expr_t = util::convert_to_ad_like_t<LocType, XType, ScaleType>;
+    using scale_expr_t = util::convert_to_ad_like_t<ScaleType, XType, LocType>;
     x_expr_t x_expr = x;
     loc_expr_t loc_expr = loc;
     scale_expr_t scale_expr = scale;
@@ -1,8 +1,10 @@
 #pragma once
 #include <tuple>
+#include <fastad_bits/reverse/core/access.hpp>
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/numeric.hpp>
 #include <Eigen/Dense>
@@ -40,11 +42,16 @@ struct NormalBase:
         , sigma_{sigma}
     {}
 
+    /**
+     * Binds x, mean and sigma, then itself.
+     * Nodes with a matrix sigma skip backward evaluating the expressions
+     * that only read frozen leaves (see core::details::bind_active).
+     */
     ptr_pack_t bind_cache(ptr_pack_t begin)
     {
-        begin = x_.bind_cache(begin);
-        begin = mean_.bind_cache(begin);
-        begin = sigma_.bind_cache(begin);
+        x_active_ = core::details::bind_active([&]() { begin = x_.bind_cache(begin); });
+        mean_active_ = core::details::bind_active([&]() { begin = mean_.bind_cache(begin); });
+        sigma_active_ = core::details::bind_active([&]() { begin = sigma_.bind_cache(begin); });
         auto adj = begin.adj;
         begin.adj = nullptr;
         begin = value_adj_view_t::bind(begin);
@@ -65,10 +72,21 @@ struct NormalBase:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        x_.visit(v);
+        mean_.visit(v);
+        sigma_.visit(v);
+    }
+
 protected:
     x_t x_;
     mean_t mean_;
     sigma_t sigma_;
+    bool x_active_ = true;
+    bool mean_active_ = true;
+    bool sigma_active_ = true;
 };
 
 } // namespace details
@@ -91,6 +109,12 @@ protected:
  * then size of x must be the same as that of mean rows and sigma rows.
  * Additionally, we check that sigma is square if it is a matrix.
  *
+ * A matrix sigma is Cholesky factored in every forward evaluation
+ * (once at construction if it is constant), unless it is an ad::llt expression,
+ * whose factor is reused.
+ * The inverse of sigma is only formed in the backward evaluation,
+ * if sigma is not constant.
+ *
  * @tparam  XExprType           type of x expression at which to evaluate log-pdf
  * @tparam  MeanExprType        type of mean expression
  * @tparam  SigmaExprType       type of sigma expression
@@ -152,14 +176,14 @@ public:
 
         auto z = (x - m) / s;
         
-        return this->get() = -0.5 * z * z - log_sigma_; 
+        return this->get() = value_t(-0.5) * z * z - log_sigma_; 
     }
 
     void beval(value_t seed)
     {
         if (seed == 0 || sigma_.get() <= 0) return;
 
-        value_t inv_s = 1./sigma_.get();
+        value_t inv_s = 1/sigma_.get();
         value_t z = (x_.get() - mean_.get()) * inv_s;
 
         if constexpr (!util::is_constant_v<sigma_t>) {
@@ -236,14 +260,14 @@ public:
 
         if constexpr (util::is_constant_v<x_t>) {
             value_t centered = (m - x_mean_);
-            value_t inv_s_sq = 1./(s * s);
+            value_t inv_s_sq = 1/(s * s);
             return this->get() = 
-                -0.5 * inv_s_sq * (x_var_ + x_.rows() * centered * centered) 
+                value_t(-0.5) * inv_s_sq * (x_var_ + x_.rows() * centered * centered) 
                         - x_.rows() * log_sigma_;
         } else {
             auto z = (x - m).matrix();
             z_sq = z.squaredNorm() / (s * s);
-            return this->get() = -0.5 * z_sq - x_.rows() * log_sigma_; 
+            return this->get() = value_t(-0.5) * z_sq - x_.rows() * log_sigma_; 
         }
     }
 
@@ -251,7 +275,7 @@ public:
     {
         if (seed == 0 || sigma_.get() <= 0) return;
 
-        value_t inv_s = 1./sigma_.get();
+        value_t inv_s = 1/sigma_.get();
         value_t inv_s_sq = inv_s * inv_s;
 
         auto&& x = x_.get().array();
@@ -350,14 +374,14 @@ public:
         auto z = (x - m).matrix();
         z_sq = z.squaredNorm() / (s * s);
         
-        return this->get() = -0.5 * z_sq - x_.rows() * log_sigma_; 
+        return this->get() = value_t(-0.5) * z_sq - x_.rows() * log_sigma_; 
     }
 
     void beval(value_t seed)
     {
         if (seed == 0 || sigma_.get() <= 0) return;
 
-        value_t inv_s = 1./sigma_.get();
+        value_t inv_s = 1/sigma_.get();
         value_t inv_s_sq = inv_s * inv_s;
 
         auto&& x = x_.get().array();
@@ -422,7 +446,7 @@ public:
                 auto&& s = sigma_.get().array();
                 sq_term_ = (x/s).matrix().squaredNorm(); 
                 lin_term_ = (x/(s * s)).sum();
-                const_term_ = (1./s).matrix().squaredNorm();
+                const_term_ = (1/s).matrix().squaredNorm();
             }
         }
     }
@@ -444,11 +468,11 @@ public:
         if constexpr (util::is_constant_v<x_t> &&
                       util::is_constant_v<sigma_t>) {
             return this->get() = 
-                -0.5 * (sq_term_ - 2 * m * lin_term_ + m * m * const_term_)
+                value_t(-0.5) * (sq_term_ - 2 * m * lin_term_ + m * m * const_term_)
                     - log_sigma_;
         } else {
             auto z = ((x - m) / s).matrix();
-            return this->get() = -0.5 * z.squaredNorm() - log_sigma_; 
+            return this->get() = value_t(-0.5) * z.squaredNorm() - log_sigma_; 
         }
     }
 
@@ -467,7 +491,7 @@ public:
         } else {
 
             if constexpr (!util::is_constant_v<sigma_t>) {
-                sigma_.beval((seed / s) * ( ((x - m)/s).square() - 1. ));
+                sigma_.beval((seed / s) * ( ((x - m)/s).square() - 1 ));
             }
 
             value_t mean_adj = ((x - m) / s.square()).sum();
@@ -545,7 +569,7 @@ public:
 
         auto z = ((x - m) / s).matrix();
         
-        return this->get() = -0.5 * z.squaredNorm() - log_sigma_; 
+        return this->get() = value_t(-0.5) * z.squaredNorm() - log_sigma_; 
     }
 
     void beval(value_t seed)
@@ -557,7 +581,7 @@ public:
         auto&& s = sigma_.get().array();
 
         if constexpr (!util::is_constant_v<sigma_t>) {
-            sigma_.beval((seed / s) * ( ((x - m)/s).square() - 1. ));
+            sigma_.beval((seed / s) * ( ((x - m)/s).square() - 1 ));
         }
 
         mean_.beval(seed * (x - m) / s.square());
@@ -635,39 +659,44 @@ public:
             return this->get() = util::neg_inf<value_t>;
         }
         
-        z_ = inv_ * (x - m).matrix();
-        value_t sq_term = (x - m).matrix().transpose() * z_;
+        z_ = llt_.get().solve((x - m).matrix());
+        value_t sq_term = (x - m).matrix().dot(z_);
         
-        return this->get() = -0.5 * sq_term - log_det_; 
+        return this->get() = value_t(-0.5) * sq_term - log_det_; 
     }
 
     void beval(value_t seed)
     {
         if (seed == 0 || !is_pos_def_) return;
 
+        // the inverse of sigma is only formed if sigma reads a leaf that is not frozen
         if constexpr (!util::is_constant_v<sigma_t>) {
-            auto adj = (-0.5 * seed) * (inv_ - z_ * z_.transpose());
-            sigma_.beval(adj.array());
+            if (this->sigma_active_) {
+                size_t n = sigma_.rows();
+                inv_ = llt_.get().solve(mat_t::Identity(n, n));
+                auto adj = (value_t(-0.5) * seed) * (inv_ - z_ * z_.transpose());
+                sigma_.beval(adj.array());
+            }
         }
 
-        mean_.beval(seed * z_.sum());
-        x_.beval((-seed) * z_.array());
+        if (this->mean_active_) mean_.beval(seed * z_.sum());
+        if (this->x_active_) x_.beval((-seed) * z_.array());
     }
 
 private:
+    // Factors sigma or reuses its factor if it is an ad::llt expression.
     void update_cache() {
-        llt_.compute(sigma_.get());
-        is_pos_def_ = (llt_.info() == Eigen::Success);
+        llt_.update(sigma_);
+        is_pos_def_ = llt_.valid();
         if (is_pos_def_) {
-            log_det_ = std::log(llt_.matrixL().determinant());
-            inv_ = llt_.solve(mat_t::Identity(sigma_.rows(), sigma_.cols()));
+            log_det_ = llt_.log_det_factor();
         }
     }
 
     using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
     using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
 
-    Eigen::LLT<mat_t, Eigen::Lower> llt_;
+    core::details::LLTCache<value_t> llt_;
     value_t log_det_;
     bool is_pos_def_;
     mat_t inv_;
@@ -733,39 +762,44 @@ public:
             return this->get() = util::neg_inf<value_t>;
         }
         
-        z_ = inv_ * (x - m);
-        value_t sq_term = (x - m).transpose() * z_;
+        z_ = llt_.get().solve(x - m);
+        value_t sq_term = (x - m).dot(z_);
         
-        return this->get() = -0.5 * sq_term - log_det_; 
+        return this->get() = value_t(-0.5) * sq_term - log_det_; 
     }
 
     void beval(value_t seed)
     {
         if (seed == 0 || !is_pos_def_) return;
 
+        // the inverse of sigma is only formed if sigma reads a leaf that is not frozen
         if constexpr (!util::is_constant_v<sigma_t>) {
-            auto adj = (-0.5 * seed) * (inv_ - z_ * z_.transpose());
-            sigma_.beval(adj.array());
+            if (this->sigma_active_) {
+                size_t n = sigma_.rows();
+                inv_ = llt_.get().solve(mat_t::Identity(n, n));
+                auto adj = (value_t(-0.5) * seed) * (inv_ - z_ * z_.transpose());
+                sigma_.beval(adj.array());
+            }
         }
 
-        mean_.beval(seed * z_.array());
-        x_.beval((-seed) * z_.array());
+        if (this->mean_active_) mean_.beval(seed * z_.array());
+        if (this->x_active_) x_.beval((-seed) * z_.array());
     }
 
 private:
+    // Factors sigma or reuses its factor if it is an ad::llt expression.
     void update_cache() {
-        llt_.compute(sigma_.get());
-        is_pos_def_ = (llt_.info() == Eigen::Success);
+        llt_.update(sigma_);
+        is_pos_def_ = llt_.valid();
         if (is_pos_def_) {
-            log_det_ = std::log(llt_.matrixL().determinant());
-            inv_ = llt_.solve(mat_t::Identity(sigma_.rows(), sigma_.cols()));
+            log_det_ = llt_.log_det_factor();
         }
     }
 
     using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
     using vec_t = Eigen::Matrix<value_t, Eigen::Dynamic, 1>;
 
-    Eigen::LLT<mat_t, Eigen::Lower> llt_;
+    core::details::LLTCache<value_t> llt_;
     value_t log_det_;
     bool is_pos_def_;
     mat_t inv_;
@@ -786,9 +820,9 @@ inline auto normal_adj_log_pdf(const XType& x,
                                const MeanType& mean,
                                const SigmaType& sigma)
 {
-    using x_expr_t = util::convert_to_ad_t<XType>;
-    using mean_expr_t = util::convert_to_ad_t<MeanType>;
-    using sigma_expr_t = util::convert_to_ad_t<SigmaType>;
+    using x_expr_t = util::convert_to_ad_like_t<XType, MeanType, SigmaType>;
+    using mean_expr_t = util::convert_to_ad_like_t<MeanType, XType, SigmaType>;
+    using sigma_expr_t = util::convert_to_ad_like_t<SigmaType, XType, MeanType>;
     x_expr_t x_expr = x;
     mean_expr_t mean_expr = mean;
     sigma_expr_t sigma_expr = sigma;
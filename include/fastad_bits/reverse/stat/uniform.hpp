@@ -64,6 +64,14 @@ struct UniformBase:
         return {this->size(), 0};
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        x_.visit(v);
+        min_.visit(v);
+        max_.visit(v);
+    }
+
 protected:
     x_t x_;
     min_t min_;
@@ -340,7 +348,7 @@ public:
         auto&& min = min_.get();
         auto&& max = max_.get().array();
         max_.beval((-seed) / (max - min));
-        min_.beval(seed * (1. / (max - min)).sum());
+        min_.beval(seed * (1 / (max - min)).sum());
     }
 
 private:
@@ -432,7 +440,7 @@ public:
 
         auto&& min = min_.get().array();
         auto&& max = max_.get();
-        max_.beval((-seed) * (1. / (max - min)).sum());
+        max_.beval((-seed) * (1 / (max - min)).sum());
         min_.beval(seed / (max - min));
     }
 
@@ -552,9 +560,9 @@ inline auto uniform_adj_log_pdf(const XType& x,
                                 const MinType& min,
                                 const MaxType& max)
 {
-    using x_expr_t = util::convert_to_ad_t<XType>;
-    using min_expr_t = util::convert_to_ad_t<MinType>;
-    using max_expr_t = util::convert_to_ad_t<MaxType>;
+    using x_expr_t = util::convert_to_ad_like_t<XType, MinType, MaxType>;
+    using min_expr_t = util::convert_to_ad_like_t<MinType, XType, MaxType>;
+    using max_expr_t = util::convert_to_ad_like_t<MaxType, XType, MinType>;
     x_expr_t x_expr = x;
     min_expr_t min_expr = min;
     max_expr_t max_expr = max;
@@ -3,6 +3,7 @@
 #include <fastad_bits/reverse/core/expr_base.hpp>
 #include <fastad_bits/reverse/core/value_adj_view.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
 #include <fastad_bits/util/type_traits.hpp>
 #include <fastad_bits/util/numeric.hpp>
 #include <Eigen/Dense>
@@ -68,6 +69,14 @@ struct WishartBase:
         return {this->size(), 0}; 
     }
 
+    template <class Visitor>
+    void visit(Visitor& v)
+    {
+        x_.visit(v);
+        v_.visit(v);
+        n_.visit(v);
+    }
+
 protected:
     x_t x_;
     v_t v_;
@@ -85,6 +94,10 @@ protected:
  *
  * Note: n MUST be a constant.
  *
+ * x and v are Cholesky factored (or the factors of ad::llt expressions reused)
+ * and the trace term is computed by triangular solves.
+ * Their inverses are only formed in the backward evaluation.
+ *
  * The only possible shape combinations are as follows:
  * x -> matrix (or self-adj), 
  * v -> matrix (or self-adj)
@@ -147,7 +160,7 @@ public:
         , is_v_pos_def_(false)
         , x_inv_(x.rows(), x.cols())
         , v_inv_(v.rows(), v.cols())
-        , xv_inv_(x.rows(), v.rows())
+        , v_inv_x_(v.rows(), x.cols())
     {
         if constexpr (util::is_constant_v<v_t>) {
             update_v_cache();
@@ -174,44 +187,53 @@ public:
             return this->get() = util::neg_inf<value_t>;
         }
 
+        v_inv_x_ = v_llt_.get().solve(x_.get());
+
         value_t p = v_.rows();
-        return this->get() = (n-p-1.) * log_x_det_ 
-                              - 0.5 * xv_inv_.trace()
+        return this->get() = (n-p-1) * log_x_det_ 
+                              - value_t(0.5) * v_inv_x_.trace()
                               - n * log_v_det_;
     }
 
     void beval(value_t seed)
     {
         if (seed == 0 || !valid()) return;
+        if constexpr (util::is_constant_v<x_t> &&
+                      util::is_constant_v<v_t>) return;
 
         value_t n = n_.get();
         value_t p = v_.rows();
 
-        auto x_adj = (0.5 * seed) * ((n-p-1) * x_inv_ - v_inv_);
-        auto v_adj = (0.5 * seed) * (v_inv_ * xv_inv_ - n * v_inv_);
-        v_.beval(v_adj.array());
-        x_.beval(x_adj.array());
+        size_t k = v_.rows();
+        v_inv_ = v_llt_.get().solve(mat_t::Identity(k, k));
+
+        if constexpr (!util::is_constant_v<v_t>) {
+            auto v_adj = (value_t(0.5) * seed) * (v_inv_x_ * v_inv_ - n * v_inv_);
+            v_.beval(v_adj.array());
+        }
+        if constexpr (!util::is_constant_v<x_t>) {
+            x_inv_ = x_llt_.get().solve(mat_t::Identity(k, k));
+            auto x_adj = (value_t(0.5) * seed) * ((n-p-1) * x_inv_ - v_inv_);
+            x_.beval(x_adj.array());
+        }
     }
 
 private:
+    // Factors v or reuses its factor if it is an ad::llt expression.
     void update_v_cache() {
-        v_llt_.compute(v_.get());
-        is_v_pos_def_ = (v_llt_.info() == Eigen::Success);
+        v_llt_.update(v_);
+        is_v_pos_def_ = v_llt_.valid();
         if (is_v_pos_def_) {
-            log_v_det_ = std::log(v_llt_.matrixL().determinant());
-            v_inv_ = v_llt_.solve(mat_t::Identity(v_.rows(), v_.cols()));
+            log_v_det_ = v_llt_.log_det_factor();
         }
     }
 
+    // Factors x or reuses its factor if it is an ad::llt expression.
     void update_x_cache() {
-        if (is_v_pos_def_) {
-            x_llt_.compute(x_.get());
-            is_x_pos_def_ = (x_llt_.info() == Eigen::Success);
-            if (is_x_pos_def_) {
-                log_x_det_ = std::log(x_llt_.matrixL().determinant());
-                x_inv_ = x_llt_.solve(mat_t::Identity(x_.rows(), x_.cols()));
-                xv_inv_ = x_.get() * v_inv_;
-            }
+        x_llt_.update(x_);
+        is_x_pos_def_ = x_llt_.valid();
+        if (is_x_pos_def_) {
+            log_x_det_ = x_llt_.log_det_factor();
         }
     }
 
@@ -223,15 +245,15 @@ private:
 
     using mat_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic>;
 
-    Eigen::LLT<mat_t, Eigen::Lower> x_llt_;
-    Eigen::LLT<mat_t, Eigen::Lower> v_llt_;
+    core::details::LLTCache<value_t> x_llt_;
+    core::details::LLTCache<value_t> v_llt_;
     value_t log_x_det_;
     value_t log_v_det_;
     bool is_x_pos_def_;
     bool is_v_pos_def_;
     mat_t x_inv_;
     mat_t v_inv_;
-    mat_t xv_inv_;
+    mat_t v_inv_x_;    // v^{-1} x
 };
 
 } // namespace stat
@@ -248,9 +270,9 @@ inline auto wishart_adj_log_pdf(const XType& x,
                                 const VType& v,
                                 const NType& n)
 {
-    using x_expr_t = util::convert_to_ad_t<XType>;
-    using v_expr_t = util::convert_to_ad_t<VType>;
-    using n_expr_t = util::convert_to_ad_t<NType>;
+    using x_expr_t = util::convert_to_ad_like_t<XType, VType, NType>;
+    using v_expr_t = util::convert_to_ad_like_t<VType, XType, NType>;
+    using n_expr_t = util::convert_to_ad_like_t<NType, XType, VType>;
     x_expr_t x_expr = x;
     v_expr_t v_expr = v;
     n_expr_t n_expr = n;
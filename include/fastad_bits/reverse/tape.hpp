@@ -0,0 +1,4 @@
+#pragma once
+
+#include "tape/real.hpp"
+#include "tape/stack.hpp"
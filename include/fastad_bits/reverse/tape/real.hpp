@@ -0,0 +1,188 @@
+#pragma once
+#include <Eigen/Core>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/tape/stack.hpp>
+
+namespace ad {
+namespace tape {
+
+/**
+ * Real is a scalar recorded on the active Stack of the calling thread.
+ * Constructing a Real from a value records a leaf.
+ * Every arithmetic operation and mathematical function on Reals records
+ * a statement holding the partial derivatives with respect to its Real operands.
+ * Derivatives are computed with the same functors as the expression templates
+ * in reverse/core (e.g. core::Sin, core::Mul), so that both modes agree exactly.
+ * Operations with plain values only record the Real operand.
+ *
+ * Comparisons compare values and are not recorded,
+ * so that control flow may depend on them.
+ * Reals are also Eigen scalars, e.g. Vector<T> is a vector of Reals.
+ *
+ * @tparam  ValueType   underlying value type
+ */
+
+template <class ValueType>
+class Real
+{
+public:
+    using value_t = ValueType;
+    using stack_t = Stack<value_t>;
+
+    Real(const value_t& x = 0)
+        : val_(x)
+        , index_(stack_t::active().push_leaf())
+    {}
+
+    const value_t& get() const { return val_; }
+    size_t index() const { return index_; }
+
+    value_t get_adj() const { return stack_t::active().get_adj(index_); }
+    void set_adj(const value_t& seed) { stack_t::active().set_adj(index_, seed); }
+
+    Real& operator+=(const Real& x) { return *this = *this + x; }
+    Real& operator-=(const Real& x) { return *this = *this - x; }
+    Real& operator*=(const Real& x) { return *this = *this * x; }
+    Real& operator/=(const Real& x) { return *this = *this / x; }
+    Real& operator+=(const value_t& x) { return *this = *this + x; }
+    Real& operator-=(const value_t& x) { return *this = *this - x; }
+    Real& operator*=(const value_t& x) { return *this = *this * x; }
+    Real& operator/=(const value_t& x) { return *this = *this / x; }
+
+    /**
+     * Records Unary on x.
+     * Partial derivative is Unary::bmap with unit seed.
+     */
+    template <class Unary>
+    static Real unary(const Real& x)
+    {
+        value_t f = Unary::fmap(x.val_);
+        value_t d = Unary::bmap(value_t(1), x.val_, f);
+        return Real(f, stack_t::active().push(x.index_, d));
+    }
+
+    /**
+     * Records Binary on x, y where either may be a plain value.
+     * Partial derivatives are Binary::blmap and Binary::brmap with unit seed.
+     */
+    template <class Binary, class T, class U>
+    static Real binary(const T& x, const U& y)
+    {
+        const value_t& xv = value(x);
+        const value_t& yv = value(y);
+        value_t f = Binary::fmap(xv, yv);
+        auto& stack = stack_t::active();
+        if constexpr (std::is_same_v<T, Real> && std::is_same_v<U, Real>) {
+            return Real(f, stack.push(
+                        x.index_, Binary::blmap(value_t(1), xv, yv, f),
+                        y.index_, Binary::brmap(value_t(1), xv, yv, f)));
+        } else if constexpr (std::is_same_v<T, Real>) {
+            return Real(f, stack.push(
+                        x.index_, Binary::blmap(value_t(1), xv, yv, f)));
+        } else {
+            return Real(f, stack.push(
+                        y.index_, Binary::brmap(value_t(1), xv, yv, f)));
+        }
+    }
+
+    friend Real operator-(const Real& x) { return unary<core::UnaryMinus>(x); }
+
+#define TAPE_BINARY_OP(op, struct_name) \
+    friend Real op(const Real& x, const Real& y) \
+    { return binary<core::struct_name>(x, y); } \
+    friend Real op(const Real& x, const value_t& y) \
+    { return binary<core::struct_name>(x, y); } \
+    friend Real op(const value_t& x, const Real& y) \
+    { return binary<core::struct_name>(x, y); }
+
+    TAPE_BINARY_OP(operator+, Add)
+    TAPE_BINARY_OP(operator-, Sub)
+    TAPE_BINARY_OP(operator*, Mul)
+    TAPE_BINARY_OP(operator/, Div)
+
+#undef TAPE_BINARY_OP
+
+#define TAPE_COMPARISON_OP(op) \
+    friend bool operator op(const Real& x, const Real& y) { return x.val_ op y.val_; } \
+    friend bool operator op(const Real& x, const value_t& y) { return x.val_ op y; } \
+    friend bool operator op(const value_t& x, const Real& y) { return x op y.val_; }
+
+    TAPE_COMPARISON_OP(<)
+    TAPE_COMPARISON_OP(<=)
+    TAPE_COMPARISON_OP(>)
+    TAPE_COMPARISON_OP(>=)
+    TAPE_COMPARISON_OP(==)
+    TAPE_COMPARISON_OP(!=)
+
+#undef TAPE_COMPARISON_OP
+
+private:
+    Real(const value_t& x, size_t index)
+        : val_(x)
+        , index_(index)
+    {}
+
+    static const value_t& value(const Real& x) { return x.val_; }
+    static const value_t& value(const value_t& x) { return x; }
+
+    value_t val_;
+    size_t index_;
+};
+
+/*
+ * Defines mathematical function f on Real recorded with the unary functor struct_name.
+ * These are found by argument-dependent lookup.
+ */
+#define TAPE_UNARY_FUNC(f, struct_name) \
+template <class T> \
+inline Real<T> f(const Real<T>& x) \
+{ \
+    return Real<T>::template unary<core::struct_name>(x); \
+}
+
+TAPE_UNARY_FUNC(sin, Sin)
+TAPE_UNARY_FUNC(cos, Cos)
+TAPE_UNARY_FUNC(tan, Tan)
+TAPE_UNARY_FUNC(asin, Arcsin)
+TAPE_UNARY_FUNC(acos, Arccos)
+TAPE_UNARY_FUNC(atan, Arctan)
+TAPE_UNARY_FUNC(exp, Exp)
+TAPE_UNARY_FUNC(log, Log)
+TAPE_UNARY_FUNC(sqrt, Sqrt)
+TAPE_UNARY_FUNC(erf, Erf)
+
+#undef TAPE_UNARY_FUNC
+
+template <class T>
+using Vector = Eigen::Matrix<Real<T>, Eigen::Dynamic, 1>;
+
+template <class T>
+using Matrix = Eigen::Matrix<Real<T>, Eigen::Dynamic, Eigen::Dynamic>;
+
+} // namespace tape
+} // namespace ad
+
+namespace Eigen {
+
+// Allows Real as the scalar type of Eigen containers.
+template <class T>
+struct NumTraits<ad::tape::Real<T>> : GenericNumTraits<ad::tape::Real<T>>
+{
+    using Real = ad::tape::Real<T>;
+    using NonInteger = ad::tape::Real<T>;
+    using Nested = ad::tape::Real<T>;
+    using Literal = T;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = 1,
+        AddCost = 3,
+        MulCost = 3
+    };
+};
+
+} // namespace Eigen
@@ -0,0 +1,168 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace ad {
+namespace tape {
+
+/**
+ * Stack records the operations of a dynamic computation as a flat tape
+ * and replays them in reverse to compute adjoints.
+ * Unlike the expression templates in reverse/core,
+ * the structure of the computation need not be known at compile time,
+ * so it may depend on runtime configuration (e.g. number of layers, data-dependent loops).
+ *
+ * Every Real created or computed while the stack is active is a statement.
+ * Statement i owns the operations [ends[i], ends[i+1]) that each store
+ * the index of an operand and the partial derivative of statement i with respect to it.
+ * Leaves (independent variables) are statements without operations.
+ * Since the result of statement i is identified by i,
+ * the reverse sweep only streams through the two arrays.
+ *
+ * A stack becomes the active stack of the calling thread on construction
+ * and the previously active one is restored on destruction.
+ * A stack is not thread-safe; use one per thread.
+ *
+ * @tparam  ValueType   underlying value type
+ */
+
+template <class ValueType>
+class Stack
+{
+public:
+    using value_t = ValueType;
+
+    Stack()
+        : prev_(current_)
+        , ends_(1, 0)
+    {
+        current_ = this;
+    }
+
+    Stack(const Stack&) =delete;
+    Stack& operator=(const Stack&) =delete;
+
+    ~Stack() { current_ = prev_; }
+
+    /**
+     * Returns the active stack of the calling thread.
+     * It is undefined behavior if there is none.
+     */
+    static Stack& active()
+    {
+        assert(current_);
+        return *current_;
+    }
+
+    // Records a leaf and returns its index.
+    size_t push_leaf()
+    {
+        return push_statement(n_ops_);
+    }
+
+    // Records a statement with one operand i and partial derivative d.
+    size_t push(size_t i, const value_t& d)
+    {
+        size_t k = n_ops_;
+        reserve_ops(k + 1);
+        ops_[k] = {d, i};
+        n_ops_ = k + 1;
+        return push_statement(k + 1);
+    }
+
+    // Records a statement with two operands i, j and partial derivatives di, dj.
+    size_t push(size_t i, const value_t& di,
+                size_t j, const value_t& dj)
+    {
+        size_t k = n_ops_;
+        reserve_ops(k + 2);
+        ops_[k] = {di, i};
+        ops_[k+1] = {dj, j};
+        n_ops_ = k + 2;
+        return push_statement(k + 2);
+    }
+
+    /**
+     * Clears the tape and the adjoints but keeps the memory.
+     * Reals recorded before are invalidated.
+     */
+    void new_recording()
+    {
+        n_ops_ = 0;
+        n_statements_ = 0;
+        adj_.clear();
+    }
+
+    /**
+     * Propagates the adjoints of every statement to their operands
+     * from the last statement to the first.
+     * Seed the outputs with Real::set_adj beforehand.
+     */
+    void reverse()
+    {
+        size_t n = n_statements();
+        adj_.resize(n, 0);
+        for (size_t i = n; i-- > 0;) {
+            value_t a = adj_[i];
+            if (a == 0) continue;
+            for (size_t k = ends_[i]; k < ends_[i+1]; ++k) {
+                adj_[ops_[k].index] += ops_[k].partial * a;
+            }
+        }
+    }
+
+    // Sets every adjoint to 0 so that the tape can be replayed with a new seed.
+    void reset_adj() { std::fill(adj_.begin(), adj_.end(), 0); }
+
+    value_t get_adj(size_t i) const
+    { return (i < adj_.size()) ? adj_[i] : value_t(0); }
+
+    void set_adj(size_t i, const value_t& seed)
+    {
+        if (adj_.size() <= i) adj_.resize(n_statements(), 0);
+        adj_[i] = seed;
+    }
+
+    size_t n_statements() const { return n_statements_; }
+    size_t n_operations() const { return n_ops_; }
+
+private:
+    struct Operation
+    {
+        value_t partial;
+        size_t index;
+    };
+
+    /*
+     * The tape grows geometrically and is never shrunk.
+     * Sizes are tracked apart from the vectors so that
+     * recording does not go through push_back.
+     */
+    void reserve_ops(size_t n)
+    {
+        if (n > ops_.size()) ops_.resize(std::max(n, 2 * ops_.size()));
+    }
+
+    size_t push_statement(size_t end)
+    {
+        size_t i = n_statements_;
+        if (i + 2 > ends_.size()) ends_.resize(std::max(i + 2, 2 * ends_.size()));
+        ends_[i+1] = end;
+        n_statements_ = i + 1;
+        return i;
+    }
+
+    static inline thread_local Stack* current_ = nullptr;
+
+    Stack* prev_;
+    std::vector<Operation> ops_;
+    std::vector<size_t> ends_;      // ends_[0] = 0
+    std::vector<value_t> adj_;
+    size_t n_ops_ = 0;
+    size_t n_statements_ = 0;
+};
+
+} // namespace tape
+} // namespace ad
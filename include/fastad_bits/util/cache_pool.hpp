@@ -0,0 +1,201 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace ad {
+namespace util {
+
+/**
+ * CachePool is an arena from which expression caches (see ExprBind) draw their memory.
+ * Memory is carved out of large slabs and recycled through free lists,
+ * one per power-of-two size class, so that after warm-up
+ * both allocate and deallocate are O(1) and never call the system allocator.
+ * Slabs are only returned to the system when the pool is destroyed.
+ *
+ * If huge_pages is true, slabs are rounded up to a multiple of 2MB and,
+ * on Linux, mapped anonymously and advised to be backed by transparent huge pages.
+ * On other platforms the flag is ignored.
+ *
+ * A pool is not thread-safe.
+ * Use one pool per thread, e.g. CachePool::local(),
+ * and return memory to the pool it was allocated from.
+ */
+
+class CachePool
+{
+public:
+    static constexpr size_t alignment = 64;
+    static constexpr size_t huge_page_size = size_t(1) << 21;
+
+    explicit CachePool(size_t slab_size = huge_page_size,
+                       bool huge_pages = false)
+        : slab_size_(std::max(slab_size, alignment))
+        , huge_pages_(huge_pages)
+    {}
+
+    CachePool(const CachePool&) =delete;
+    CachePool& operator=(const CachePool&) =delete;
+
+    ~CachePool()
+    {
+        for (const auto& slab : slabs_) free_slab(slab);
+    }
+
+    /**
+     * Returns a pointer to at least n_bytes bytes aligned to alignment.
+     * The block must be given back with deallocate(p, n_bytes).
+     */
+    void* allocate(size_t n_bytes)
+    {
+        size_t cls = size_class(n_bytes);
+        size_t block = class_size(cls);
+        in_use_ += block;
+        high_water_mark_ = std::max(high_water_mark_, in_use_);
+
+        if (cls < free_.size() && free_[cls]) {
+            FreeBlock* head = free_[cls];
+            free_[cls] = head->next;
+            return head;
+        }
+
+        if (static_cast<size_t>(end_ - top_) < block) {
+            // remainder of the current slab is abandoned
+            size_t size = std::max(slab_size_, block);
+            if (huge_pages_) size = round_up(size, huge_page_size);
+            Slab slab{allocate_slab(size), size};
+            slabs_.push_back(slab);
+            reserved_ += size;
+            top_ = slab.data;
+            end_ = slab.data + size;
+        }
+        void* p = top_;
+        top_ += block;
+        return p;
+    }
+
+    /**
+     * Gives back a block obtained from allocate(n_bytes) in O(1).
+     */
+    void deallocate(void* p, size_t n_bytes)
+    {
+        if (!p) return;
+        size_t cls = size_class(n_bytes);
+        if (cls >= free_.size()) free_.resize(cls + 1, nullptr);
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = free_[cls];
+        free_[cls] = block;
+        in_use_ -= class_size(cls);
+    }
+
+    /**
+     * Makes sure at least n_bytes can be allocated without requesting a new slab,
+     * e.g. with the high-water mark of a previous run.
+     */
+    void reserve(size_t n_bytes)
+    {
+        if (static_cast<size_t>(end_ - top_) >= n_bytes) return;
+        size_t size = round_up(n_bytes, alignment);
+        if (huge_pages_) size = round_up(size, huge_page_size);
+        Slab slab{allocate_slab(size), size};
+        slabs_.push_back(slab);
+        reserved_ += size;
+        top_ = slab.data;
+        end_ = slab.data + size;
+    }
+
+    // number of bytes currently handed out (rounded up to size classes)
+    size_t in_use() const { return in_use_; }
+
+    // maximum of in_use() over the lifetime of the pool
+    size_t high_water_mark() const { return high_water_mark_; }
+
+    // number of bytes obtained from the system
+    size_t reserved() const { return reserved_; }
+
+    bool huge_pages() const { return huge_pages_; }
+
+    /**
+     * Returns the pool owned by the calling thread.
+     * It is destroyed when the thread exits,
+     * so caches drawn from it must not outlive the thread.
+     */
+    static CachePool& local()
+    {
+        static thread_local CachePool pool;
+        return pool;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Slab
+    {
+        unsigned char* data;
+        size_t size;
+    };
+
+    static size_t round_up(size_t n, size_t m)
+    { return (n + m - 1) / m * m; }
+
+    // smallest cls such that class_size(cls) >= n_bytes
+    static size_t size_class(size_t n_bytes)
+    {
+        size_t cls = 0;
+        while (class_size(cls) < n_bytes) ++cls;
+        return cls;
+    }
+
+    static size_t class_size(size_t cls)
+    { return alignment << cls; }
+
+    unsigned char* allocate_slab(size_t size) const
+    {
+#if defined(__linux__)
+        if (huge_pages_) {
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+            madvise(p, size, MADV_HUGEPAGE);
+#endif
+            return static_cast<unsigned char*>(p);
+        }
+#endif
+        return static_cast<unsigned char*>(
+                ::operator new(size, std::align_val_t(alignment)));
+    }
+
+    void free_slab(const Slab& slab) const
+    {
+#if defined(__linux__)
+        if (huge_pages_) {
+            munmap(slab.data, slab.size);
+            return;
+        }
+#endif
+        ::operator delete(slab.data, std::align_val_t(alignment));
+    }
+
+    size_t slab_size_;
+    bool huge_pages_;
+    std::vector<Slab> slabs_;
+    std::vector<FreeBlock*> free_;
+    unsigned char* top_ = nullptr;
+    unsigned char* end_ = nullptr;
+    size_t in_use_ = 0;
+    size_t high_water_mark_ = 0;
+    size_t reserved_ = 0;
+};
+
+} // namespace util
+} // namespace ad
@@ -0,0 +1,315 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ad {
+namespace util {
+
+/**
+ * TaskGraph is a directed acyclic graph of tasks labeled 0,...,n-1.
+ * An edge (i, j) means task i must finish before task j starts.
+ * Duplicate edges and self-loops are ignored.
+ */
+
+class TaskGraph
+{
+public:
+    explicit TaskGraph(size_t n = 0)
+        : succ_(n)
+        , n_pred_(n, 0)
+    {}
+
+    size_t size() const { return succ_.size(); }
+
+    void add_edge(size_t from, size_t to)
+    {
+        if (from == to) return;
+        auto& succ = succ_[from];
+        if (!succ.empty() && succ.back() == to) return;
+        succ.push_back(to);
+        finalized_ = false;
+    }
+
+    /**
+     * Removes duplicate edges and counts predecessors.
+     * Must be called after the last add_edge and before the graph is run.
+     */
+    void finalize()
+    {
+        std::fill(n_pred_.begin(), n_pred_.end(), 0);
+        for (auto& succ : succ_) {
+            std::sort(succ.begin(), succ.end());
+            succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+            for (size_t j : succ) ++n_pred_[j];
+        }
+        finalized_ = true;
+    }
+
+    const std::vector<size_t>& successors(size_t i) const { return succ_[i]; }
+    size_t n_predecessors(size_t i) const { return n_pred_[i]; }
+    bool is_finalized() const { return finalized_; }
+
+private:
+    std::vector<std::vector<size_t>> succ_;
+    std::vector<size_t> n_pred_;
+    bool finalized_ = true;
+};
+
+/**
+ * ThreadPool is a minimal fixed-size pool of worker threads.
+ * The calling thread always participates as worker 0,
+ * so a pool of size 1 spawns no threads and runs everything inline.
+ *
+ * A job is a callable invoked once on every worker with its worker id.
+ * Jobs are run one at a time and run() blocks until every worker is done.
+ * A job submitted while the pool is busy, e.g. from inside a job of the same pool
+ * or from another thread, is run inline on the calling thread instead:
+ * the job is invoked with every worker id in turn.
+ * Nested parallel evaluations with the same pool are therefore serial, not deadlocked.
+ * This is the only primitive; parallel_for and run_graph are built on top of it.
+ */
+
+class ThreadPool
+{
+public:
+    /**
+     * Constructs a pool with n_threads workers (including the caller).
+     * If n_threads is 0, uses the hardware concurrency.
+     */
+    explicit ThreadPool(size_t n_threads = 0)
+    {
+        if (n_threads == 0) {
+            n_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        workers_.reserve(n_threads - 1);
+        for (size_t i = 1; i < n_threads; ++i) {
+            workers_.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) =delete;
+    ThreadPool& operator=(const ThreadPool&) =delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    /**
+     * Returns the number of workers including the calling thread.
+     */
+    size_t size() const { return workers_.size() + 1; }
+
+    /**
+     * Invokes f(worker_id) on every worker and blocks until all return.
+     * The calling thread runs f(0).
+     * If the pool is busy, the calling thread runs f(0),...,f(size()-1) in turn.
+     */
+    template <class F>
+    void run(F&& f)
+    {
+        if (workers_.empty()) { f(0); return; }
+        std::unique_lock<std::mutex> run_lock(run_mtx_, std::defer_lock);
+        if (current() == this || !run_lock.try_lock()) {
+            for (size_t i = 0; i < size(); ++i) f(i);
+            return;
+        }
+        CurrentGuard guard(this);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            job_ = std::ref(f);
+            n_pending_ = workers_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+        f(0);
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_cv_.wait(lock, [this]() { return n_pending_ == 0; });
+        job_ = nullptr;
+    }
+
+    /**
+     * Invokes f(task_id, worker_id) for every task_id in [0, n_tasks).
+     * Tasks are claimed dynamically so the mapping from tasks to workers
+     * is not deterministic.
+     * Callers that need reproducible results should key any per-task state
+     * on task_id rather than worker_id.
+     */
+    template <class F>
+    void parallel_for(size_t n_tasks, F&& f)
+    {
+        std::atomic<size_t> next(0);
+        run([&](size_t worker_id) {
+            for (size_t i = next++; i < n_tasks; i = next++) {
+                f(i, worker_id);
+            }
+        });
+    }
+
+    /**
+     * Invokes f(task_id, worker_id) for every task of graph 
+     * such that every task starts only after all of its predecessors finish.
+     * Every worker owns a deque of ready tasks.
+     * It pops the most recently readied task from its own deque 
+     * and when empty, steals the oldest task of another worker.
+     * Tasks readied by finishing a task are pushed to the finishing worker's deque.
+     */
+    template <class F>
+    void run_graph(const TaskGraph& graph, F&& f)
+    {
+        assert(graph.is_finalized());
+        const size_t n = graph.size();
+        if (n == 0) return;
+
+        // single worker: plain topological traversal without synchronization
+        if (workers_.empty()) {
+            std::vector<size_t> pending(n);
+            std::vector<size_t> ready;
+            for (size_t i = n; i-- > 0;) {
+                pending[i] = graph.n_predecessors(i);
+                if (pending[i] == 0) ready.push_back(i);
+            }
+            while (!ready.empty()) {
+                size_t task = ready.back();
+                ready.pop_back();
+                f(task, 0);
+                const auto& succ = graph.successors(task);
+                for (auto it = succ.rbegin(); it != succ.rend(); ++it) {
+                    if (--pending[*it] == 0) ready.push_back(*it);
+                }
+            }
+            return;
+        }
+
+        std::vector<std::atomic<size_t>> pending(n);
+        std::vector<TaskDeque> deques(size());
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            pending[i] = graph.n_predecessors(i);
+            if (pending[i] == 0) deques[k++ % deques.size()].push(i);
+        }
+
+        std::atomic<size_t> remaining(n);
+        run([&](size_t worker_id) {
+            size_t task = 0;
+            while (remaining.load() > 0) {
+                if (!deques[worker_id].pop(task) &&
+                    !steal(deques, worker_id, task)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                f(task, worker_id);
+                for (size_t j : graph.successors(task)) {
+                    if (--pending[j] == 0) deques[worker_id].push(j);
+                }
+                --remaining;
+            }
+        });
+    }
+
+private:
+    struct TaskDeque
+    {
+        void push(size_t task)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push_back(task);
+        }
+
+        bool pop(size_t& task)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (tasks.empty()) return false;
+            task = tasks.back();
+            tasks.pop_back();
+            return true;
+        }
+
+        bool steal(size_t& task)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (tasks.empty()) return false;
+            task = tasks.front();
+            tasks.pop_front();
+            return true;
+        }
+
+        std::mutex mtx;
+        std::deque<size_t> tasks;
+    };
+
+    // pool whose job is running on the calling thread, if any
+    static const ThreadPool*& current()
+    {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    struct CurrentGuard
+    {
+        CurrentGuard(const ThreadPool* pool) : prev_(current()) { current() = pool; }
+        ~CurrentGuard() { current() = prev_; }
+        CurrentGuard(const CurrentGuard&) =delete;
+        CurrentGuard& operator=(const CurrentGuard&) =delete;
+    private:
+        const ThreadPool* prev_;
+    };
+
+    static bool steal(std::vector<TaskDeque>& deques, 
+                      size_t thief, 
+                      size_t& task)
+    {
+        for (size_t k = 1; k < deques.size(); ++k) {
+            if (deques[(thief + k) % deques.size()].steal(task)) return true;
+        }
+        return false;
+    }
+
+    void work(size_t id)
+    {
+        current() = this;
+        size_t seen = 0;
+        while (true) {
+            std::function<void(size_t)> job;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                start_cv_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                job = job_;
+            }
+            job(id);
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                --n_pending_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mtx_;    // held while a job is run on the workers
+    std::mutex mtx_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    std::function<void(size_t)> job_;
+    size_t generation_ = 0;
+    size_t n_pending_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace util
+} // namespace ad
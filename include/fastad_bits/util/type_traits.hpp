@@ -24,6 +24,9 @@ struct ConstantBase;
 template <class V, class S>
 struct Constant;
 
+template <class V, class S>
+struct DataSlot;
+
 } // namespace core
 
 namespace util {
@@ -125,6 +128,27 @@ template <class T>
 inline constexpr bool is_constant_v =
     std::is_base_of_v<core::ConstantBase<T>, T>;
 
+/*
+ * Check if T is data, i.e. a constant or a DataSlot.
+ * Data has no adjoint, but unlike a constant,
+ * the value of a DataSlot may change between evaluations.
+ */
+namespace details {
+
+template <class T>
+struct is_data_slot : std::false_type
+{};
+
+template <class V, class S>
+struct is_data_slot<core::DataSlot<V, S>> : std::true_type
+{};
+
+} // namespace details
+
+template <class T>
+inline constexpr bool is_data_v =
+    is_constant_v<T> || details::is_data_slot<T>::value;
+
 /**
  * Constant represents constants in a mathematical formula.
  * It owns the constant values rather than viewing them elsewhere.
@@ -292,5 +316,88 @@ template <class... Ts>
 inline constexpr bool any_ad_v = 
     details::any_ad<Ts...>::value;
 
+/*
+ * Type of numeric constants combined with values of type T,
+ * where T is a value type or an Eigen object of values.
+ * It is the value type itself for floating-point values,
+ * so that constants do not promote float values to double,
+ * and double otherwise (ForwardVar and Lanes define mixed operators with double).
+ */
+namespace details {
+
+template <class T, class = void>
+struct scalar
+{
+    using type = T;
+};
+
+template <class T>
+struct scalar<T, std::enable_if_t<is_eigen_v<T>>>
+{
+    using type = typename T::Scalar;
+};
+
+template <class T>
+using scalar_t = typename scalar<std::decay_t<T>>::type;
+
+} // namespace details
+
+template <class T>
+using literal_t = std::conditional_t<
+    std::is_floating_point_v<details::scalar_t<T>>,
+    details::scalar_t<T>,
+    double>;
+
+/*
+ * Convert T to an AD expression to be combined with the operands Ts.
+ * Same as convert_to_ad_t, except that an arithmetic value becomes
+ * a constant of the value type of the first AD-like operand in Ts
+ * if that is a floating-point type.
+ * This way, literals do not change the value type of an expression,
+ * e.g. 2. * x is a float expression if x is.
+ */
+namespace details {
+
+template <class T>
+struct value_of
+{
+    using type = typename T::value_t;
+};
+
+template <class... Ts>
+struct ad_value
+{
+    using type = void;
+};
+
+template <class T, class... Ts>
+struct ad_value<T, Ts...>
+{
+    using type = typename std::conditional_t<
+        util::is_expr_v<T> || util::is_var_v<T>,
+        value_of<T>,
+        ad_value<Ts...> >::type;
+};
+
+template <class T, class ValueType, class = void>
+struct convert_to_ad_as
+{
+    using type = convert_to_ad_t<T>;
+};
+
+template <class T, class ValueType>
+struct convert_to_ad_as<T, ValueType, std::enable_if_t<
+    std::is_arithmetic_v<T> &&
+    std::is_floating_point_v<ValueType> > >
+{
+    using type = core::Constant<ValueType, ad::scl>;
+};
+
+} // namespace details
+
+template <class T, class... Ts>
+using convert_to_ad_like_t = typename
+    details::convert_to_ad_as<T, typename details::ad_value<Ts...>::type>::type;
+
 } // namespace util
 } // namespace ad
@@ -40,5 +40,28 @@ TEST_F(dualnum_fixture, get_set_adjoint)
     EXPECT_DOUBLE_EQ(dual.get_adjoint(), 3.4);  // adjoint changed
 }
 
+TEST_F(dualnum_fixture, vector_tangent)
+{
+    using dual_t = DualNum<double, 3>;
+    bool same_tangent_type = std::is_same<dual_t::tangent_type, Eigen::Array3d>::value;
+    EXPECT_TRUE(same_tangent_type);
+
+    dual_t vdual(2.1, Eigen::Array3d(1., 2., 3.));
+    vdual.get_adjoint() *= 2.;
+    EXPECT_DOUBLE_EQ(vdual.get_value(), 2.1);
+    EXPECT_DOUBLE_EQ(vdual.get_adjoint()(0), 2.);
+    EXPECT_DOUBLE_EQ(vdual.get_adjoint()(1), 4.);
+    EXPECT_DOUBLE_EQ(vdual.get_adjoint()(2), 6.);
+}
+
+TEST_F(dualnum_fixture, dynamic_tangent)
+{
+    DualNum<double, Eigen::Dynamic> vdual(2.1, details::tangent<double, Eigen::Dynamic>::zero());
+    EXPECT_EQ(vdual.get_adjoint().size(), 0);
+    vdual.set_adjoint(Eigen::ArrayXd::Constant(5, 1.));
+    EXPECT_EQ(vdual.get_adjoint().size(), 5);
+    EXPECT_DOUBLE_EQ(vdual.get_adjoint().sum(), 5.);
+}
+
 } // namespace core
 } // namespace ad
@@ -148,4 +148,50 @@ TEST_F(adforward_fixture, div)
     EXPECT_DOUBLE_EQ(res.get_adjoint(), 1./3 + 4./9);    // directional derivative in direction (1,1)
 }
 
+////////////////////////////////////////////////////////////
+// Mixed with plain values
+////////////////////////////////////////////////////////////
+
+TEST_F(adforward_fixture, mixed)
+{
+    ForwardVar<double> x(4, 1);
+    ForwardVar<double> res = 2. / x - 3. * x + (x - 1.) / 2.;
+    EXPECT_DOUBLE_EQ(res.get_value(), 0.5 - 12 + 1.5);
+    EXPECT_DOUBLE_EQ(res.get_adjoint(), -2./16 - 3 + 0.5);
+}
+
+////////////////////////////////////////////////////////////
+// Vector mode
+////////////////////////////////////////////////////////////
+
+TEST_F(adforward_fixture, vector_mode)
+{
+    // directions (1,0), (0,1), (1,1), (2,-1) for (x, y)
+    using fvar_t = ForwardVar<double, 4>;
+    fvar_t x(0.5, Eigen::Array4d(1, 0, 1, 2));
+    fvar_t y(3, Eigen::Array4d(0, 1, 1, -1));
+    fvar_t res = ad::sin(x) * y + ad::exp(x / y) - 2. * y;
+
+    double dx = std::cos(0.5) * 3 + std::exp(0.5/3) / 3;
+    double dy = std::sin(0.5) - std::exp(0.5/3) * 0.5 / 9 - 2;
+    EXPECT_DOUBLE_EQ(res.get_value(), std::sin(0.5) * 3 + std::exp(0.5/3) - 6);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(0), dx);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(1), dy);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(2), dx + dy);
+    EXPECT_DOUBLE_EQ(res.get_adjoint()(3), 2*dx - dy);
+}
+
+TEST_F(adforward_fixture, vector_mode_dynamic)
+{
+    using fvar_t = ForwardVar<double, Eigen::Dynamic>;
+    fvar_t x(2, Eigen::ArrayXd::LinSpaced(6, 0, 5));
+    fvar_t res = x * x + 1.;
+    res += x;
+    EXPECT_DOUBLE_EQ(res.get_value(), 7);
+    ASSERT_EQ(res.get_adjoint().size(), 6);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_DOUBLE_EQ(res.get_adjoint()(i), 5. * i);
+    }
+}
+
 } // namespace ad
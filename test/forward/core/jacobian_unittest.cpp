@@ -0,0 +1,119 @@
+#include <fastad_bits/forward/core/jacobian.hpp>
+#include "gtest/gtest.h"
+
+namespace ad {
+namespace core {
+
+struct jacobian_fixture : ::testing::Test
+{
+protected:
+    using matrix_t = Eigen::MatrixXd;
+
+    static constexpr size_t n = 5;
+    Eigen::VectorXd x;
+
+    jacobian_fixture()
+        : x(n)
+    {
+        x << 0.3, -1.2, 2., 0.7, 1.5;
+    }
+
+    // f(x)_i = x_i * x_{i+1} + sin(x_i), f(x)_{n-1} = exp(x_0 - x_{n-1})
+    static auto f()
+    {
+        return [](const auto& x) {
+            using fvalue_t = std::decay_t<decltype(x(0))>;
+            Eigen::Matrix<fvalue_t, Eigen::Dynamic, 1> y(n);
+            for (size_t i = 0; i + 1 < n; ++i) {
+                y(i) = x(i) * x(i+1) + ad::sin(x(i));
+            }
+            y(n-1) = ad::exp(x(0) - x(n-1));
+            return y;
+        };
+    }
+
+    matrix_t f_jacobian() const
+    {
+        matrix_t J = matrix_t::Zero(n, n);
+        for (size_t i = 0; i + 1 < n; ++i) {
+            J(i,i) = x(i+1) + std::cos(x(i));
+            J(i,i+1) = x(i);
+        }
+        double e = std::exp(x(0) - x(n-1));
+        J(n-1,0) = e;
+        J(n-1,n-1) = -e;
+        return J;
+    }
+
+    void check_eq(const matrix_t& actual, const matrix_t& expected)
+    {
+        ASSERT_EQ(actual.rows(), expected.rows());
+        ASSERT_EQ(actual.cols(), expected.cols());
+        for (int i = 0; i < actual.rows(); ++i) {
+            for (int j = 0; j < actual.cols(); ++j) {
+                EXPECT_DOUBLE_EQ(actual(i,j), expected(i,j));
+            }
+        }
+    }
+};
+
+TEST_F(jacobian_fixture, scalar_mode)
+{
+    check_eq(ad::forward_jacobian(f(), x), f_jacobian());
+}
+
+TEST_F(jacobian_fixture, chunk_divides)
+{
+    Eigen::VectorXd x4 = x.head(4);
+    auto g = [](const auto& x) {
+        using fvalue_t = std::decay_t<decltype(x(0))>;
+        Eigen::Matrix<fvalue_t, Eigen::Dynamic, 1> y(2);
+        y << x(0) * x(1) * x(2), x(3) / x(1);
+        return y;
+    };
+    matrix_t expected = matrix_t::Zero(2, 4);
+    expected(0,0) = x4(1) * x4(2);
+    expected(0,1) = x4(0) * x4(2);
+    expected(0,2) = x4(0) * x4(1);
+    expected(1,1) = -x4(3) / (x4(1) * x4(1));
+    expected(1,3) = 1. / x4(1);
+    check_eq(ad::forward_jacobian<2>(g, x4), expected);
+    check_eq(ad::forward_jacobian<4>(g, x4), expected);
+}
+
+TEST_F(jacobian_fixture, chunk_remainder)
+{
+    // last chunk only has some of the directions
+    check_eq(ad::forward_jacobian<2>(f(), x), f_jacobian());
+    check_eq(ad::forward_jacobian<3>(f(), x), f_jacobian());
+    check_eq(ad::forward_jacobian<8>(f(), x), f_jacobian());
+}
+
+TEST_F(jacobian_fixture, dynamic)
+{
+    check_eq(ad::forward_jacobian<Eigen::Dynamic>(f(), x), f_jacobian());
+    for (size_t chunk_size : {1ul, 2ul, 4ul, 7ul}) {
+        check_eq(ad::forward_jacobian<Eigen::Dynamic>(f(), x, chunk_size), f_jacobian());
+    }
+}
+
+TEST_F(jacobian_fixture, non_square)
+{
+    auto g = [](const auto& x) {
+        using fvalue_t = std::decay_t<decltype(x(0))>;
+        Eigen::Matrix<fvalue_t, Eigen::Dynamic, 1> y(1);
+        y(0) = x(0);
+        for (int i = 1; i < x.size(); ++i) y(0) *= x(i);
+        return y;
+    };
+    auto J = ad::forward_jacobian<4>(g, x);
+    ASSERT_EQ(J.rows(), 1);
+    ASSERT_EQ(J.cols(), static_cast<int>(n));
+    double prod = x.prod();
+    for (size_t j = 0; j < n; ++j) {
+        EXPECT_NEAR(J(0,j), prod / x(j), 1e-12);
+    }
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/jacobian.hpp>
+#include <fastad_bits/reverse/core/share.hpp>
+#include <fastad_bits/reverse/core/any_expr.hpp>
+
+namespace ad {
+namespace core {
+
+struct any_expr_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> x{1.3}, w{-0.7};
+    Var<value_t, vec> v{3};
+
+    any_expr_fixture()
+    {
+        v.get() << 0.2, -1.1, 0.5;
+    }
+
+    void reset_adj()
+    {
+        x.reset_adj();
+        w.reset_adj();
+        v.reset_adj();
+    }
+};
+
+TEST_F(any_expr_fixture, scl_value_adj)
+{
+    AnyExpr<value_t> e = ad::sin(x) * w;
+    auto expr = ad::bind(e * e + x);
+    value_t res = ad::autodiff(expr);
+
+    value_t ev = std::sin(x.get()) * w.get();
+    EXPECT_DOUBLE_EQ(res, ev * ev + x.get());
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * ev * std::cos(x.get()) * w.get() + 1.);
+    EXPECT_DOUBLE_EQ(w.get_adj(), 2. * ev * std::sin(x.get()));
+}
+
+TEST_F(any_expr_fixture, vec_value_adj)
+{
+    AnyExpr<value_t, vec> u = ad::exp(v) * x;
+    auto expr = ad::bind(ad::sum(u * u));
+    value_t res = ad::autodiff(expr);
+
+    Eigen::ArrayXd uv = v.get().array().exp() * x.get();
+    EXPECT_DOUBLE_EQ(res, (uv * uv).sum());
+    EXPECT_DOUBLE_EQ(x.get_adj(), (2. * uv * uv).sum() / x.get());
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_DOUBLE_EQ(v.get_adj()(i), 2. * uv(i) * uv(i));
+    }
+}
+
+TEST_F(any_expr_fixture, runtime_composition)
+{
+    // terms chosen at runtime share one type
+    std::vector<AnyExpr<value_t>> terms;
+    terms.emplace_back(x * w);
+    terms.emplace_back(ad::exp(x));
+    terms.emplace_back(ad::sum(v) * w);
+    auto expr = ad::bind(ad::sum(terms.begin(), terms.end(),
+                                 [](const auto& t) { return t; }));
+    value_t res = ad::autodiff(expr);
+
+    EXPECT_DOUBLE_EQ(res, x.get() * w.get() + std::exp(x.get()) +
+                          v.get().sum() * w.get());
+    EXPECT_DOUBLE_EQ(x.get_adj(), w.get() + std::exp(x.get()));
+    EXPECT_DOUBLE_EQ(w.get_adj(), x.get() + v.get().sum());
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_DOUBLE_EQ(v.get_adj()(i), w.get());
+    }
+}
+
+TEST_F(any_expr_fixture, placeholder)
+{
+    Var<value_t> p;
+    AnyExpr<value_t> e = x * w;
+    auto expr = ad::bind((p = e, p * p));
+    value_t res = ad::autodiff(expr);
+
+    value_t ev = x.get() * w.get();
+    EXPECT_DOUBLE_EQ(p.get(), ev);
+    EXPECT_DOUBLE_EQ(res, ev * ev);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * ev * w.get());
+    EXPECT_DOUBLE_EQ(w.get_adj(), 2. * ev * x.get());
+}
+
+TEST_F(any_expr_fixture, copies)
+{
+    AnyExpr<value_t> e = x * w;
+    AnyExpr<value_t> f = e;
+    e = ad::sin(x);
+    auto expr1 = ad::bind(f);
+    auto expr2 = expr1;
+    for (auto* expr : {&expr1, &expr2}) {
+        reset_adj();
+        EXPECT_DOUBLE_EQ(ad::autodiff(*expr), x.get() * w.get());
+        EXPECT_DOUBLE_EQ(x.get_adj(), w.get());
+        EXPECT_DOUBLE_EQ(w.get_adj(), x.get());
+    }
+}
+
+TEST_F(any_expr_fixture, bind_rvalues_shared)
+{
+    // each ExprBind gets its own state of the shared subexpression
+    auto u = ad::share(x * w);
+    AnyExpr<value_t> e = u * u;
+    auto expr1 = ad::bind(e + x);
+    auto expr2 = ad::bind(e * x);
+
+    value_t uv = x.get() * w.get();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr1), uv * uv + x.get());
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * uv * w.get() + 1.);
+    EXPECT_DOUBLE_EQ(w.get_adj(), 2. * uv * x.get());
+
+    reset_adj();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr2), uv * uv * x.get());
+    EXPECT_DOUBLE_EQ(x.get_adj(), 3. * uv * uv);
+    EXPECT_DOUBLE_EQ(w.get_adj(), 2. * uv * x.get() * x.get());
+}
+
+TEST_F(any_expr_fixture, visit)
+{
+    // leaves are visited through the erased expression
+    AnyExpr<value_t, vec> u = v * x;
+    auto expr = ad::bind(u);
+    Eigen::MatrixXd J = ad::jacobian(expr, x, v);
+    ASSERT_EQ(J.rows(), 3);
+    ASSERT_EQ(J.cols(), 4);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(J(i, 0), v.get()(i));
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_DOUBLE_EQ(J(i, 1+j), (i == j) ? x.get() : 0.);
+        }
+    }
+}
+
+} // namespace core
+} // namespace ad
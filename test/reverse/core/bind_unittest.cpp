@@ -4,6 +4,15 @@
 #include <fastad_bits/reverse/core/binary.hpp>
 #include <fastad_bits/reverse/core/glue.hpp>
 #include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/share.hpp>
+#include <fastad_bits/reverse/core/checkpoint.hpp>
+#include <fastad_bits/reverse/core/schedule.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/any_expr.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
 
 namespace ad {
 
@@ -58,4 +67,179 @@ TEST_F(bind_fixture, bind_test_rref)
     test(make_expr_bind());
 }
 
+TEST_F(bind_fixture, bind_test_pool) 
+{
+    util::CachePool pool;
+    {
+        auto expr_bind = ad::bind(w1 * w2 + w1, pool);
+        EXPECT_GT(pool.in_use(), 0ul);
+        EXPECT_DOUBLE_EQ(ad::autodiff(expr_bind), 3.);
+        EXPECT_DOUBLE_EQ(w1.get_adj(), 3.);
+    }
+    EXPECT_EQ(pool.in_use(), 0ul);
+    size_t hwm = pool.high_water_mark();
+    size_t reserved = pool.reserved();
+
+    // rebuilding recycles the same memory
+    for (int i = 0; i < 10; ++i) {
+        auto expr_bind = ad::bind(w1 * w2 + w1, pool);
+        EXPECT_DOUBLE_EQ(ad::evaluate(expr_bind), 3.);
+    }
+    EXPECT_EQ(pool.high_water_mark(), hwm);
+    EXPECT_EQ(pool.reserved(), reserved);
+}
+
+TEST_F(bind_fixture, bind_test_copy) 
+{
+    auto expr = w1 * w2 + w1;
+    auto expr_bind = ad::bind(expr);
+    auto copy = expr_bind;
+    // copy must be bound to its own cache
+    EXPECT_NE(copy.get().data(), expr_bind.get().data());
+    EXPECT_DOUBLE_EQ(ad::autodiff(copy), 3.);
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr_bind), 3.);
+    EXPECT_DOUBLE_EQ(w1.get_adj(), 3.);
+}
+
+TEST_F(bind_fixture, value_bind)
+{
+    util::CachePool pool, value_pool;
+    auto expr = (w3 = w1 * w2, ad::sin(w3) * w3 + w4);
+    auto expr_bind = ad::bind(expr, pool);
+    auto value_bind = ad::bind_value(expr, value_pool);
+
+    // no adjoint cache
+    EXPECT_LT(value_pool.in_use(), pool.in_use());
+    EXPECT_DOUBLE_EQ(ad::evaluate(value_bind), ad::evaluate(expr_bind));
+
+    // copies are bound to their own cache
+    auto copy = value_bind;
+    EXPECT_NE(copy.get().data(), value_bind.get().data());
+    w1.get() = -1.5;
+    EXPECT_DOUBLE_EQ(ad::evaluate(copy), ad::evaluate(expr_bind));
+    EXPECT_DOUBLE_EQ(w3.get(), -3.);
+}
+
+TEST_F(bind_fixture, value_bind_nodes)
+{
+    // every kind of node can be forward evaluated without adjoint cache
+    Var<value_t, vec> v(4), u(4);
+    Var<value_t, mat> m(4, 4);
+    v.get() << 0.5, -1., 2., 0.3;
+    m.get().setIdentity();
+    m.get()(0, 3) = 0.5;
+    std::vector<size_t> idx = {0, 1, 2, 3};
+
+    auto s = ad::share(ad::sum(ad::dot(m, v)));
+    auto expr = (
+        ad::checkpoint_for_each(idx.begin(), idx.end(),
+            [&](size_t) { return u = ad::exp(v) * w1 + u * 0.5; }, 2),
+        ad::schedule(ad::par(2, true), (w3 = s * w1, w4 = ad::sum(u) * w2)),
+        ad::sum(ad::par(2, true), idx.begin(), idx.end(),
+            [&](size_t i) { return ad::normal_adj_log_pdf(v[i], w3, w2) * u[i]; }) +
+        s * s + w4);
+
+    u.get().setZero();
+    value_t expected = ad::evaluate(ad::bind(expr));
+    u.get().setZero();
+    auto value_bind = ad::bind_value(expr);
+    EXPECT_DOUBLE_EQ(ad::evaluate(value_bind), expected);
+}
+
+TEST_F(bind_fixture, frozen_leaves)
+{
+    Var<value_t, vec> a(3), b(3), u(3);
+    Var<value_t, mat> M(3, 3), S(3, 3);
+    a.get() << 0.5, -1., 2.;
+    b.get() << 0.3, 0.1, -0.4;
+    M.get().setRandom();
+    S.get() << 2., 0.5, 0., 0.5, 1., 0.2, 0., 0.2, 3.;
+    std::vector<size_t> idx = {0, 1, 2};
+
+    AnyExpr<value_t> erased = ad::sum(b * b);
+    auto make_expr = [&]() {
+        return (ad::for_each(idx.begin(), idx.end(),
+                    [&](size_t i) { return u[i] = ad::exp(b[i]); }),
+                ad::sum(ad::dot(M, a)) * ad::sin(b[0]) +
+                ad::sum(idx.begin(), idx.end(),
+                    [&](size_t i) { return a[i] * a[i] + b[i] * w1; }) +
+                ad::normal_adj_log_pdf(a, b, S) + erased);
+    };
+    auto reset_adj = [&]() {
+        a.reset_adj(); b.reset_adj(); u.reset_adj();
+        M.reset_adj(); S.reset_adj(); w1.reset_adj();
+    };
+
+    auto expr = ad::bind(make_expr());
+    value_t res = ad::autodiff(expr);
+    Eigen::VectorXd a_adj = a.get_adj();
+    Eigen::VectorXd b_adj = b.get_adj();
+    value_t w1_adj = w1.get_adj();
+
+    // only a and w1 are updated
+    b.freeze();
+    M.freeze();
+    S.freeze();
+    reset_adj();
+    auto frozen_expr = ad::bind(make_expr());
+    EXPECT_DOUBLE_EQ(ad::autodiff(frozen_expr), res);
+    EXPECT_DOUBLE_EQ(w1.get_adj(), w1_adj);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(a.get_adj()(i), a_adj(i));
+        EXPECT_DOUBLE_EQ(b.get_adj()(i), 0.);
+        EXPECT_DOUBLE_EQ(u.get_adj()(i), 0.);
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_DOUBLE_EQ(M.get_adj()(i, j), 0.);
+            EXPECT_DOUBLE_EQ(S.get_adj()(i, j), 0.);
+        }
+    }
+
+    // b is updated again once the expression is rebound
+    b.unfreeze();
+    reset_adj();
+    ad::autodiff(frozen_expr);
+    EXPECT_DOUBLE_EQ(b.get_adj()(1), 0.);
+    frozen_expr.rebind();
+    reset_adj();
+    EXPECT_DOUBLE_EQ(ad::autodiff(frozen_expr), res);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(a.get_adj()(i), a_adj(i));
+        EXPECT_DOUBLE_EQ(b.get_adj()(i), b_adj(i));
+    }
+}
+
+TEST_F(bind_fixture, frozen_shared_use)
+{
+    // a use of a shared expression reads a leaf that is not frozen
+    auto s = ad::share(ad::sin(w1) * w2);
+    w3.freeze();
+    auto expr = ad::bind(s + s * w3);
+    ad::autodiff(expr);
+    value_t ds = 1. + w3.get();
+    EXPECT_DOUBLE_EQ(w1.get_adj(), ds * std::cos(w1.get()) * w2.get());
+    EXPECT_DOUBLE_EQ(w3.get_adj(), 0.);
+}
+
+TEST_F(bind_fixture, frozen_nested)
+{
+    // activity differs along the chain: only w3 * w3 and sin(w3) are inactive
+    auto make_expr = [&]() {
+        return w3 * (w1 * (w3 * w3) + w2) + ad::sin(w3) * w4;
+    };
+    auto expr = ad::bind(make_expr());
+    value_t res = ad::autodiff(expr);
+    value_t w1_adj = w1.get_adj();
+    value_t w2_adj = w2.get_adj();
+    value_t w4_adj = w4.get_adj();
+
+    w1.reset_adj(); w2.reset_adj(); w3.reset_adj(); w4.reset_adj();
+    w3.freeze();
+    auto frozen_expr = ad::bind(make_expr());
+    EXPECT_DOUBLE_EQ(ad::autodiff(frozen_expr), res);
+    EXPECT_DOUBLE_EQ(w1.get_adj(), w1_adj);
+    EXPECT_DOUBLE_EQ(w2.get_adj(), w2_adj);
+    EXPECT_DOUBLE_EQ(w4.get_adj(), w4_adj);
+    EXPECT_DOUBLE_EQ(w3.get_adj(), 0.);
+}
+
 } // namespace ad
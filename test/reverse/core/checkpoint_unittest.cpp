@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/checkpoint.hpp>
+#include <testutil/base_fixture.hpp>
+
+namespace ad {
+namespace core {
+
+struct checkpoint_fixture : base_fixture
+{
+protected:
+    static constexpr size_t n_steps = 50;
+    value_t dt = 0.05;
+    value_t seed = 1.7;
+
+    Var<value_t> a{0.8};
+    Var<value_t> x;
+    Var<value_t, ad::vec> xv{3};
+    std::vector<Var<value_t>> ws = std::vector<Var<value_t>>(n_steps + 1);
+    std::vector<size_t> idx;
+
+    checkpoint_fixture()
+        : base_fixture()
+        , idx(n_steps)
+    {
+        for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+    }
+
+    void reset()
+    {
+        x.get() = 0.3;
+        xv.get() << 0.3, -1.1, 2.;
+        ws[0].get() = 0.3;
+        for (auto* v : {&a, &x}) v->reset_adj();
+        xv.reset_adj();
+        for (auto& w : ws) w.reset_adj();
+    }
+
+    // x <- x + dt * sin(a * x)
+    auto step_x()
+    { return [&](size_t) { return x += dt * ad::sin(a * x); }; }
+
+    // w_{i+1} = a * w_i + sin(w_i)
+    auto step_ws()
+    {
+        return [&](size_t i) {
+            return ws[i+1] = a * ws[i] + ad::sin(ws[i]);
+        };
+    }
+};
+
+TEST_F(checkpoint_fixture, bind_cache_size)
+{
+    auto expected = ad::for_each(idx.begin(), idx.end(), step_x());
+    auto expr = ad::checkpoint_for_each(idx.begin(), idx.end(), step_x(), 3);
+    auto step_size = step_x()(0).bind_cache_size();
+    EXPECT_EQ(expected.bind_cache_size()(0), n_steps * step_size(0));
+    EXPECT_EQ(expr.bind_cache_size()(0), step_size(0) + 1);
+    EXPECT_EQ(expr.bind_cache_size()(1), step_size(1) + 1);
+    EXPECT_EQ(expr.n_checkpoints(), 3ul);
+}
+
+TEST_F(checkpoint_fixture, default_n_checkpoints)
+{
+    auto expr = ad::checkpoint_for_each(idx.begin(), idx.end(), step_x());
+    EXPECT_EQ(expr.n_checkpoints(), 6ul);
+}
+
+TEST_F(checkpoint_fixture, state)
+{
+    auto expr_x = ad::checkpoint_for_each(idx.begin(), idx.end(), step_x());
+    bind(expr_x);
+    EXPECT_EQ(expr_x.state_size(), 1ul);
+
+    // every placeholder is written once and only read afterwards
+    auto expr_ws = ad::checkpoint_for_each(idx.begin(), idx.end(), step_ws());
+    bind(expr_ws);
+    EXPECT_EQ(expr_ws.state_size(), 0ul);
+}
+
+TEST_F(checkpoint_fixture, opeq_matches_for_each)
+{
+    reset();
+    auto expected = ad::for_each(idx.begin(), idx.end(), step_x());
+    bind(expected);
+    value_t val = expected.feval();
+    expected.beval(seed);
+    value_t a_adj = a.get_adj();
+    value_t x_adj = x.get_adj();
+
+    for (size_t c : {0ul, 1ul, 2ul, 3ul, 7ul, n_steps}) {
+        reset();
+        auto expr = ad::checkpoint_for_each(idx.begin(), idx.end(), step_x(), c);
+        bind(expr);
+        EXPECT_DOUBLE_EQ(expr.feval(), val);
+        expr.beval(seed);
+        EXPECT_NEAR(a.get_adj(), a_adj, 1e-13);
+        EXPECT_NEAR(x.get_adj(), x_adj, 1e-13);
+        EXPECT_DOUBLE_EQ(x.get(), 0.3);
+    }
+}
+
+TEST_F(checkpoint_fixture, eq_matches_for_each)
+{
+    reset();
+    auto expected = ad::for_each(idx.begin(), idx.end(), step_ws());
+    bind(expected);
+    value_t val = expected.feval();
+    expected.beval(seed);
+    value_t a_adj = a.get_adj();
+    value_t w_adj = ws[0].get_adj();
+
+    for (size_t c : {1ul, 2ul, 5ul}) {
+        reset();
+        auto expr = ad::checkpoint_for_each(idx.begin(), idx.end(), step_ws(), c);
+        bind(expr);
+        EXPECT_DOUBLE_EQ(expr.feval(), val);
+        expr.beval(seed);
+        EXPECT_NEAR(a.get_adj(), a_adj, 1e-13);
+        EXPECT_NEAR(ws[0].get_adj(), w_adj, 1e-13);
+    }
+}
+
+TEST_F(checkpoint_fixture, vec_glue_matches_for_each)
+{
+    auto step = [&](size_t) { return xv += dt * a * ad::sin(xv); };
+
+    reset();
+    auto expected = (ad::for_each(idx.begin(), idx.end(), step),
+                     ad::sum(xv * xv));
+    bind(expected);
+    value_t val = expected.feval();
+    expected.beval(seed);
+    value_t a_adj = a.get_adj();
+    aVectorXd x_adj = xv.get_adj();
+
+    reset();
+    auto expr = (ad::checkpoint_for_each(idx.begin(), idx.end(), step, 4),
+                 ad::sum(xv * xv));
+    bind(expr);
+    EXPECT_DOUBLE_EQ(expr.feval(), val);
+    expr.beval(seed);
+    EXPECT_NEAR(a.get_adj(), a_adj, 1e-13);
+    for (size_t i = 0; i < xv.size(); ++i) {
+        EXPECT_NEAR(xv.get_adj(i,0), x_adj(i), 1e-13);
+    }
+}
+
+TEST_F(checkpoint_fixture, single_step)
+{
+    reset();
+    auto expr = ad::checkpoint_for_each(idx.begin(), idx.begin() + 1, step_x());
+    bind(expr);
+    value_t x0 = 0.3;
+    EXPECT_DOUBLE_EQ(expr.feval(), x0 + dt * std::sin(0.8 * x0));
+    expr.beval(1.);
+    EXPECT_DOUBLE_EQ(a.get_adj(), dt * std::cos(0.8 * x0) * x0);
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+
+namespace ad {
+namespace core {
+
+struct constant_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Eigen::MatrixXd X{3, 2};
+    Var<value_t, vec> w{2};
+
+    constant_fixture()
+    {
+        X << 1., 2.,
+             -1., 0.5,
+             0.3, -0.2;
+        w.get() << 0.5, -0.3;
+    }
+};
+
+TEST_F(constant_fixture, scl)
+{
+    auto c = ad::constant(3.);
+    auto d = c;
+    EXPECT_DOUBLE_EQ(c.get(), 3.);
+    EXPECT_DOUBLE_EQ(d.get(), 3.);
+    EXPECT_NE(c.data(), d.data());
+}
+
+TEST_F(constant_fixture, copies_share_values)
+{
+    auto c = ad::constant(X);
+    auto d = c;
+    EXPECT_EQ(c.data(), d.data());
+    EXPECT_NE(c.data(), X.data());
+    EXPECT_EQ(c.rows(), 3ul);
+    EXPECT_EQ(c.cols(), 2ul);
+    for (int i = 0; i < X.rows(); ++i) {
+        for (int j = 0; j < X.cols(); ++j) {
+            EXPECT_DOUBLE_EQ(d.get(i, j), X(i, j));
+        }
+    }
+}
+
+TEST_F(constant_fixture, rvalue_moves_values)
+{
+    Eigen::MatrixXd Y = X;
+    const value_t* y_data = Y.data();
+    auto c = ad::constant(std::move(Y));
+    static_assert(std::is_same_v<decltype(c), Constant<value_t, mat>>);
+    EXPECT_EQ(c.data(), y_data);
+
+    Eigen::VectorXd v = X.col(0);
+    const value_t* v_data = v.data();
+    auto d = ad::constant(std::move(v));
+    static_assert(std::is_same_v<decltype(d), Constant<value_t, vec>>);
+    EXPECT_EQ(d.data(), v_data);
+
+    // lvalues are still copied
+    auto e = ad::constant(X);
+    EXPECT_NE(e.data(), X.data());
+    for (int i = 0; i < X.rows(); ++i) {
+        for (int j = 0; j < X.cols(); ++j) {
+            EXPECT_DOUBLE_EQ(c.get(i, j), X(i, j));
+        }
+        EXPECT_DOUBLE_EQ(d.get(i, 0), X(i, 0));
+    }
+}
+
+TEST_F(constant_fixture, bound_expression_shares_values)
+{
+    auto c = ad::constant(X);
+    auto expr = ad::bind(ad::sum(ad::dot(c, w)));
+
+    // copies of the bound expression evaluate with the same values
+    std::vector<decltype(expr)> copies(10, expr);
+    for (auto& e : copies) {
+        w.reset_adj();
+        EXPECT_DOUBLE_EQ(ad::autodiff(e), (X * w.get()).sum());
+    }
+    Eigen::VectorXd grad = X.colwise().sum();
+    for (int j = 0; j < 2; ++j) {
+        EXPECT_DOUBLE_EQ(w.get_adj()(j), grad(j));
+    }
+}
+
+} // namespace core
+} // namespace ad
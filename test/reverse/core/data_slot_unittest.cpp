@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/transpose.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/data_slot.hpp>
+
+namespace ad {
+namespace core {
+
+struct data_slot_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using mat_t = Eigen::MatrixXd;
+
+    // one data point per column
+    mat_t X{3, 4};
+    Eigen::VectorXd y{4};
+    Var<value_t, vec> w{3};
+
+    data_slot_fixture()
+    {
+        X << 1., 2., 3., 4.,
+             -1., 0.5, 2., 0.,
+             0.3, -0.2, 1., 2.;
+        y << 1., -1., 0.5, 2.;
+        w.get() << 0.5, -0.3, 0.8;
+    }
+};
+
+TEST_F(data_slot_fixture, scl)
+{
+    value_t a = 2., b = -3.;
+    auto s = ad::data_slot(&a);
+    static_assert(util::is_data_v<decltype(s)>);
+    static_assert(!util::is_constant_v<decltype(s)>);
+    Var<value_t> x(1.5);
+    auto expr = ad::bind(s * x * x);
+
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 2. * 1.5 * 1.5);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * 2. * 1.5);
+
+    // new value through the same pointer
+    a = 4.;
+    x.reset_adj();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 4. * 1.5 * 1.5);
+
+    // new pointer
+    s.set_data(&b);
+    x.reset_adj();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), -3. * 1.5 * 1.5);
+    EXPECT_DOUBLE_EQ(x.get_adj(), -3. * 2. * 1.5);
+}
+
+TEST_F(data_slot_fixture, vec_stream_rows)
+{
+    auto xi = ad::data_slot(X.col(0).data(), X.rows());
+    auto yi = ad::data_slot(y.data());
+    auto expr = ad::bind(ad::pow<2>(yi - ad::sum(xi * w)));
+
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(3);
+    value_t loss = 0;
+    value_t actual = 0;
+    for (int i = 0; i < X.cols(); ++i) {
+        xi.set_data(X.col(i).data());
+        yi.set_data(y.data() + i);
+        actual += ad::autodiff(expr);
+
+        value_t r = y(i) - X.col(i).dot(w.get());
+        loss += r * r;
+        grad -= 2. * r * X.col(i);
+    }
+    EXPECT_DOUBLE_EQ(actual, loss);
+    for (int j = 0; j < 3; ++j) {
+        EXPECT_DOUBLE_EQ(w.get_adj()(j), grad(j));
+    }
+}
+
+TEST_F(data_slot_fixture, vec_segment)
+{
+    // one data point (x, y) per row, sliced from one slot
+    Eigen::Matrix<value_t, 4, 4, Eigen::RowMajor> D;
+    D.leftCols(3) = X.transpose();
+    D.col(3) = y;
+    auto row = ad::data_slot(D.data(), 4);
+    auto xi = row.segment(0, 3);
+    auto yi = row.segment(3, 1);
+    auto expr = ad::bind(ad::sum(ad::pow<2>(yi - ad::dot(ad::transpose(w), xi))));
+
+    for (int i = 0; i < X.cols(); ++i) {
+        row.set_data(D.row(i).data());
+        EXPECT_EQ(xi.data(), D.row(i).data());
+        EXPECT_EQ(yi.data(), D.row(i).data() + 3);
+        w.reset_adj();
+        value_t actual = ad::autodiff(expr);
+
+        value_t r = y(i) - X.col(i).dot(w.get());
+        EXPECT_DOUBLE_EQ(actual, r * r);
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_DOUBLE_EQ(w.get_adj()(j), -2. * r * X(j,i));
+        }
+    }
+}
+
+TEST_F(data_slot_fixture, mat_minibatch)
+{
+    // two data points per batch, with the slot copied into a placeholder definition
+    auto Xb = ad::data_slot(X.data(), 3, 2);
+    Var<value_t, vec> z(2);
+    auto expr = ad::bind((z = ad::dot(ad::transpose(Xb), w), ad::sum(z * z)));
+
+    for (int b = 0; b < 2; ++b) {
+        Xb.set_data(X.data() + 3 * 2 * b);
+        w.reset_adj();
+        z.reset_adj();
+        value_t actual = ad::autodiff(expr);
+
+        Eigen::VectorXd zb = X.middleCols(2 * b, 2).transpose() * w.get();
+        EXPECT_DOUBLE_EQ(actual, zb.squaredNorm());
+        Eigen::VectorXd grad = 2. * X.middleCols(2 * b, 2) * zb;
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_DOUBLE_EQ(w.get_adj()(j), grad(j));
+        }
+    }
+}
+
+} // namespace core
+} // namespace ad
@@ -1,6 +1,8 @@
 #include <testutil/base_fixture.hpp>
 #include <fastad_bits/reverse/core/dot.hpp>
 #include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
 
 namespace ad {
 namespace core {
@@ -178,6 +180,36 @@ TEST_F(dot_fixture, dot_constant_var_beval)
     check_eq(radj, vec_expr.get_adj());
 }
 
+TEST_F(dot_fixture, dot_vars_bind_cache_size)
+{
+    // value and adjoint of the product, then the seeds of both expressions
+    auto size = dot_vars.bind_cache_size();
+    EXPECT_EQ(size(0), 2UL);
+    EXPECT_EQ(size(1), 2UL + mat_expr.size() + vec_expr.size());
+}
+
+TEST_F(dot_fixture, dot_constant_var_bind_cache_size)
+{
+    // no seed is reserved for the constant
+    auto dot_constant_var = ad::dot(ad::constant(mat_expr.get()), vec_expr);
+    auto size = dot_constant_var.bind_cache_size();
+    EXPECT_EQ(size(0), 2UL);
+    EXPECT_EQ(size(1), 2UL + vec_expr.size());
+}
+
+TEST_F(dot_fixture, dot_placeholder_aliased)
+{
+    // the cache of the product is the placeholder's own values
+    Var<value_t, mat> m(2, 2);
+    Var<value_t, vec> w(2);
+    m.get() << 1., 2., -3., 0.5;
+    w.get() << 0.7, -1.2;
+    Eigen::VectorXd expected = m.get() * w.get();
+    auto expr = ad::bind(w = ad::dot(m, w));
+    ad::evaluate(expr);
+    check_eq(w.get(), expected);
+}
+
 TEST_F(dot_fixture, dot_constant)
 {
     auto vec_const = ad::constant(vec_expr.get());
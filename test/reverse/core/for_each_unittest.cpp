@@ -42,5 +42,13 @@ TEST_F(for_each_fixture, scl_beval)
     EXPECT_DOUBLE_EQ(scl_expr.get_adj(), seed);
 }
 
+TEST_F(for_each_fixture, bind_cache_size)
+{
+    // values are disjoint but adjoints overlap
+    auto size_pack = scl_for_each.bind_cache_size();
+    EXPECT_EQ(size_pack(0), 2UL);
+    EXPECT_EQ(size_pack(1), 1UL);
+}
+
 } // namespace core
 } // namespace ad
@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/fuse.hpp>
+
+namespace ad {
+namespace core {
+
+struct fuse_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> s{0.7};
+    Var<value_t, vec> x{4}, b{4}, y{3};
+    Var<value_t, mat> m{2, 3};
+    Eigen::MatrixXd A;
+
+    fuse_fixture()
+        : A(4, 3)
+    {
+        x.get() << 1., 2., 3., 4.;
+        b.get() << 0.1, 0.2, -0.3, 0.4;
+        y.get() << 0.5, -0.2, 0.3;
+        m.get() << 0.3, -1.2, 0.8,
+                   1.1, 0.4, -0.6;
+        A << 0.2, -0.4, 1.3,
+             -0.7, 0.9, 0.1,
+             0.5, 0.3, -1.1,
+             1.2, -0.8, 0.6;
+    }
+
+    void reset_adj()
+    {
+        s.reset_adj();
+        x.reset_adj();
+        b.reset_adj();
+        y.reset_adj();
+        m.reset_adj();
+    }
+
+    // Checks that the fused expression has the same value and gradient as expr.
+    template <class F>
+    void check_fused(F make)
+    {
+        auto expr = ad::bind(make([](const auto& e) { return e; }));
+        value_t res = ad::autodiff(expr);
+        value_t s_adj = s.get_adj();
+        Eigen::VectorXd x_adj = x.get_adj();
+        Eigen::VectorXd b_adj = b.get_adj();
+        Eigen::VectorXd y_adj = y.get_adj();
+        Eigen::MatrixXd m_adj = m.get_adj();
+
+        reset_adj();
+        auto fused = ad::bind(make([](const auto& e) { return ad::fuse(e); }));
+        EXPECT_DOUBLE_EQ(ad::autodiff(fused), res);
+        EXPECT_DOUBLE_EQ(s.get_adj(), s_adj);
+        for (size_t i = 0; i < x.size(); ++i) {
+            EXPECT_DOUBLE_EQ(x.get_adj()(i), x_adj(i));
+            EXPECT_DOUBLE_EQ(b.get_adj()(i), b_adj(i));
+        }
+        for (size_t i = 0; i < y.size(); ++i) {
+            EXPECT_DOUBLE_EQ(y.get_adj()(i), y_adj(i));
+        }
+        for (size_t i = 0; i < m.size(); ++i) {
+            EXPECT_DOUBLE_EQ(m.get_adj().data()[i], m_adj.data()[i]);
+        }
+    }
+};
+
+TEST_F(fuse_fixture, scl)
+{
+    check_fused([&](auto fuse) {
+        return fuse(ad::sin(s * s) / (s + 2.) - ad::exp(-s));
+    });
+}
+
+TEST_F(fuse_fixture, vec)
+{
+    check_fused([&](auto fuse) {
+        return ad::sum(fuse(ad::sigmoid(ad::dot(A, y) + b) * s +
+                            x * ad::exp(x / s)));
+    });
+}
+
+TEST_F(fuse_fixture, mat)
+{
+    check_fused([&](auto fuse) {
+        return ad::sum(fuse(ad::tanh(m) * m - ad::cos(m * s)));
+    });
+}
+
+TEST_F(fuse_fixture, same_input)
+{
+    check_fused([&](auto fuse) {
+        return ad::sum(fuse(x * x + ad::log(x) * x));
+    });
+}
+
+TEST_F(fuse_fixture, deep_chain)
+{
+    // spans several blocks, the last one partial,
+    // with a scalar subchain and a constant inside the chain
+    size_t n = 3 * FusedNode<decltype(x + x)>::block_size + 7;
+    Var<value_t, vec> z(n);
+    Eigen::VectorXd c(n);
+    z.get().setLinSpaced(-1., 1.);
+    c.setLinSpaced(0.5, 2.);
+    auto make = [&](auto fuse) {
+        auto e = ad::sin(z) * (s * s) + c;
+        auto e2 = ad::sin(e) * z + z;
+        auto e3 = ad::sin(e2) * z + z;
+        return ad::sum(fuse(ad::sin(e3) * z + z));
+    };
+
+    auto expr = ad::bind(make([](const auto& e) { return e; }));
+    value_t res = ad::autodiff(expr);
+    value_t s_adj = s.get_adj();
+    Eigen::VectorXd z_adj = z.get_adj();
+
+    s.reset_adj();
+    z.reset_adj();
+    auto fused = ad::bind(make([](const auto& e) { return ad::fuse(e); }));
+    EXPECT_NEAR(ad::autodiff(fused), res, 1e-12 * n);
+    EXPECT_NEAR(s.get_adj(), s_adj, 1e-12 * n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(z.get_adj()(i), z_adj(i));
+    }
+
+    // a second backward evaluation sums up the same seeds again
+    ad::autodiff(fused);
+    EXPECT_NEAR(s.get_adj(), 2 * s_adj, 2e-12 * n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(z.get_adj()(i), 2 * z_adj(i));
+    }
+}
+
+TEST_F(fuse_fixture, bind_cache_size)
+{
+    auto d = ad::dot(A, y);
+    auto expr = ad::sigmoid(d + b) * s + x;
+    auto fused = ad::fuse(expr);
+
+    // only the inputs and the root are bound to values;
+    // the adjoint cache also holds the seeds of the non-constant inputs
+    // and a block of values and seeds for the 3 nodes below the root
+    size_t n = x.size();
+    util::SizePack expected = d.bind_cache_size() +
+                              util::SizePack(n, n + 3*n + 1 + 3*2*n);
+    util::SizePack actual = fused.bind_cache_size();
+    EXPECT_EQ(actual(0), expected(0));
+    EXPECT_EQ(actual(1), expected(1));
+    EXPECT_LT(actual(0), expr.bind_cache_size()(0));
+}
+
+TEST_F(fuse_fixture, not_fusable)
+{
+    auto expr = ad::dot(A, y);
+    static_assert(std::is_same_v<decltype(ad::fuse(expr)),
+                                 decltype(expr)>);
+}
+
+} // namespace core
+} // namespace ad
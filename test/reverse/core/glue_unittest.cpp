@@ -107,5 +107,14 @@ TEST_F(glue_fixture, mat_beval)
     check_eq(mat_expr.get_adj(), 4 * mseed);
 }
 
+TEST_F(glue_fixture, bind_cache_size)
+{
+    // values are disjoint but adjoints overlap
+    GlueNode<scl_unary_t, vec_unary_t> glue(scl_expr, vec_expr);
+    auto size_pack = glue.bind_cache_size();
+    EXPECT_EQ(size_pack(0), 1 + vec_size);
+    EXPECT_EQ(size_pack(1), vec_size);
+}
+
 } // namespace core
 } // namespace ad
@@ -1,101 +1,127 @@
-#define _USE_MATH_DEFINES
-#include <fastad_bits/reverse/core/math.hpp>
-#include <fastad_bits/reverse/core/hessian.hpp>
 #include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/hessian.hpp>
 
 namespace ad {
+namespace core {
 
-auto F_lmda = [](const auto& x, const auto&) {
-    return ad::sin(x[0]) * ad::exp(x[0]) - x[0] + ad::tan(x[0]);
-};
-
-auto G_lmda = [](const auto& x, const auto&) {
-    return ad::sin(x[0]) * ad::cos(x[1]);
-};
-
-auto H_lmda = [](const auto& x, const auto&) {
-    return ad::sin(x[0]) + x[0] * x[0] + x[1] * x[1] + ad::cos(x[2] * x[3]);
-};
-
-struct hessian_fixture: ::testing::Test
+struct hessian_fixture : ::testing::Test
 {
 protected:
+    using value_t = double;
+    using vector_t = Eigen::VectorXd;
+    using matrix_t = Eigen::MatrixXd;
+
+    static constexpr size_t n = 4;
+    std::vector<size_t> idx;
+    vector_t x;
+
+    hessian_fixture()
+        : idx(n-1)
+        , x(n)
+    {
+        for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+        x << -1.2, 1., 0.3, 2.;
+    }
 
-    // Test functions
-    // WOLFRAM-ALPHA HARD-CODED NUMBERS
-    // Test Hessian of a H_lmda
-    template <class Mat>
-    void h_hess_test(Mat const& mat)
+    // f(x) = sum_i 100 (x_{i+1} - x_i^2)^2 + (1 - x_i)^2
+    auto rosenbrock()
     {
-        EXPECT_NEAR(mat(0, 0), 1.15853, 1e-5);
-        for (int i = 0; i < 2; ++i)
-            for (int j = i + 1; j < 4; ++j)
-                EXPECT_NEAR(mat(i, j), 0., 1e-5);
-        EXPECT_NEAR(mat(1, 1), 2., 1e-5);
-        EXPECT_NEAR(mat(2, 2), -13.5017, 1e-4);
-        EXPECT_NEAR(mat(2, 3), -9.58967, 1e-5);
-        EXPECT_NEAR(mat(3, 3), -7.59469, 1e-5);
+        return [&](auto& x) {
+            return ad::sum(idx.begin(), idx.end(), [&](size_t i) {
+                auto d = x[i+1] - x[i] * x[i];
+                auto e = 1. - x[i];
+                return 100. * d * d + e * e;
+            });
+        };
     }
 
-    // Test gradient of a H_lmda computed while computing hessian
-    template <class Mat>
-    void h_grad_test(Mat const& mat)
+    matrix_t rosenbrock_hessian() const
     {
-        EXPECT_NEAR(mat(0, 0), 2.5403, 1e-4);
-        EXPECT_NEAR(mat(0, 1), 4, 1e-1);
-        EXPECT_NEAR(mat(0, 2), 2.14629, 1e-5);
-        EXPECT_NEAR(mat(0, 3), 1.60972, 1e-5);
+        matrix_t H = matrix_t::Zero(n, n);
+        for (size_t i = 0; i + 1 < n; ++i) {
+            H(i,i) += 1200. * x(i) * x(i) - 400. * x(i+1) + 2.;
+            H(i,i+1) += -400. * x(i);
+            H(i+1,i) += -400. * x(i);
+            H(i+1,i+1) += 200.;
+        }
+        return H;
     }
 
+    void check_eq(const matrix_t& actual, const matrix_t& expected)
+    {
+        ASSERT_EQ(actual.rows(), expected.rows());
+        ASSERT_EQ(actual.cols(), expected.cols());
+        for (int i = 0; i < actual.rows(); ++i) {
+            for (int j = 0; j < actual.cols(); ++j) {
+                EXPECT_NEAR(actual(i,j), expected(i,j), 1e-10);
+            }
+        }
+    }
 };
 
-// Hessian (second derivative) of a univariate function
-// Verify that algorithm approach is correct
-TEST_F(hessian_fixture, one_dimensional) {
-    using T = double;
-    Vec<ForwardVar<T>> x = {{2.1}};
-    x[0].get_value().set_adjoint(1);
-    auto gen = make_exgen<ForwardVar<T>>(F_lmda);
-    auto expr = std::get<0>(gen.generate(x));
-    autodiff(expr);
+TEST_F(hessian_fixture, rosenbrock)
+{
+    check_eq(ad::hessian(rosenbrock(), x), rosenbrock_hessian());
+}
 
-    T value = x[0].get_value().get_value(); // get forward variable value
-    double deriv = 
-        (std::cos(value) + std::sin(value)) *
-        std::exp(value) - 
-        1 + 1 / (std::cos(value) * std::cos(value));
-    double hessian = 
-        2 * (std::cos(value)*std::exp(value) + 
-        std::sin(value) / 
-        (std::cos(value) * std::cos(value) * std::cos(value)));
-    double deriv_test = expr.get_value().get_adjoint();
-    double hessian_test = x[0].get_adjoint().get_adjoint();
-    EXPECT_DOUBLE_EQ(deriv_test, deriv);
-    EXPECT_DOUBLE_EQ(hessian_test, hessian);
+TEST_F(hessian_fixture, vectorized_unary)
+{
+    // f(x) = sum(exp(x) * sin(x)) + log(x_0 + 3)
+    auto H = ad::hessian([](auto& x) {
+                return ad::sum(ad::exp(x) * ad::sin(x)) + ad::log(x[0] + 3.);
+            }, x);
+    matrix_t expected = matrix_t::Zero(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        expected(i,i) = 2. * std::exp(x(i)) * std::cos(x(i));
+    }
+    expected(0,0) -= 1. / ((x(0) + 3.) * (x(0) + 3.));
+    check_eq(H, expected);
 }
 
-// Hessian of a bivariate function
-TEST_F(hessian_fixture, two_dimensional) {
-    using T = double;
-    T x[] = { M_PI / 3 , M_PI / 6 };
-    Mat<T> hess;
-    hessian(hess, x, x + 2, G_lmda);
-    EXPECT_DOUBLE_EQ(hess(0, 0), -0.75);
-    EXPECT_DOUBLE_EQ(hess(1, 1), -0.75);
-    EXPECT_DOUBLE_EQ(hess(0, 1), -0.25);
-    EXPECT_DOUBLE_EQ(hess(1, 0), -0.25);
+TEST_F(hessian_fixture, parallel)
+{
+    matrix_t expected = ad::hessian(rosenbrock(), x);
+    for (size_t n_threads : {1ul, 2ul, 3ul, 8ul}) {
+        auto H = ad::hessian(ad::par(n_threads), rosenbrock(), x);
+        for (int i = 0; i < H.rows(); ++i) {
+            for (int j = 0; j < H.cols(); ++j) {
+                EXPECT_DOUBLE_EQ(H(i,j), expected(i,j));
+            }
+        }
+    }
 }
 
-// Hessian multivariate
-TEST_F(hessian_fixture, multi_dimensional) {
-    using T = double;
-    // DON'T CHANGE THESE NUMBERS
-    T x[] = { 1.,2.,3.,4. };
-    Mat<T> hess;
-    Mat<T> grad;
-    hessian(hess, grad, x, x + 4, H_lmda);
-    h_hess_test(hess);
-    h_grad_test(grad);
+TEST_F(hessian_fixture, hessian_vector)
+{
+    vector_t v(n);
+    v << 0.5, -1., 2., 0.25;
+    vector_t hv = ad::hessian_vector(rosenbrock(), x, v);
+    check_eq(hv, rosenbrock_hessian() * v);
+}
+
+TEST_F(hessian_fixture, gradient)
+{
+    auto f = rosenbrock();
+    HessianWorker<value_t, decltype(f)> worker(f, x);
+    value_t val = worker.run_unit(0);
+    vector_t g(n);
+    worker.gradient(g);
+
+    value_t expected = 0;
+    vector_t expected_g = vector_t::Zero(n);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        value_t d = x(i+1) - x(i) * x(i);
+        expected += 100. * d * d + (1. - x(i)) * (1. - x(i));
+        expected_g(i) += -400. * d * x(i) - 2. * (1. - x(i));
+        expected_g(i+1) += 200. * d;
+    }
+    EXPECT_NEAR(val, expected, 1e-12);
+    check_eq(g, expected_g);
 }
 
+} // namespace core
 } // namespace ad
@@ -99,6 +99,29 @@ TEST_F(if_else_fixture, if_else_complicated)
     EXPECT_DOUBLE_EQ(z.get_adj(0,0), 1.);
 }
 
+TEST_F(if_else_fixture, if_else_shared_cache)
+{
+    auto expr = if_else(x < y, x * y + z, x * z);
+
+    // branches overlap: condition needs 1 value, if-branch {2,2}, else-branch {1,1}
+    auto size_pack = expr.bind_cache_size();
+    EXPECT_EQ(size_pack(0), 3UL);
+    EXPECT_EQ(size_pack(1), 2UL);
+    bind(expr);
+
+    EXPECT_DOUBLE_EQ(expr.feval(), 5.);
+    expr.beval(1.);
+    EXPECT_DOUBLE_EQ(x.get_adj(0,0), 2.);
+
+    // else-branch reuses the cache of the if-branch
+    x.get() = 3.;
+    x.reset_adj();
+    EXPECT_DOUBLE_EQ(expr.feval(), 9.);
+    expr.beval(1.);
+    EXPECT_DOUBLE_EQ(x.get_adj(0,0), 3.);
+    EXPECT_DOUBLE_EQ(z.get_adj(0,0), 4.);
+}
+
 TEST_F(if_else_fixture, if_else_complicated_vec)
 {
     auto expr = if_else(
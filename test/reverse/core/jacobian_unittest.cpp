@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/jacobian.hpp>
+
+namespace ad {
+namespace core {
+
+struct jacobian_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using vector_t = Eigen::VectorXd;
+    using matrix_t = Eigen::MatrixXd;
+
+    static constexpr size_t n = 5;
+    vector_t x;
+
+    jacobian_fixture()
+        : x(n)
+    {
+        x << 0.3, -1.2, 2., 0.7, 1.5;
+    }
+
+    // f(x) = exp(x) * x_0 + sum(x)
+    static auto f()
+    {
+        return [](auto& x) { return ad::exp(x) * x[0] + ad::sum(x); };
+    }
+
+    matrix_t f_jacobian() const
+    {
+        matrix_t J = matrix_t::Ones(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            J(i,i) += std::exp(x(i)) * x(0);
+            J(i,0) += std::exp(x(i));
+        }
+        return J;
+    }
+
+    void check_eq(const matrix_t& actual, const matrix_t& expected)
+    {
+        ASSERT_EQ(actual.rows(), expected.rows());
+        ASSERT_EQ(actual.cols(), expected.cols());
+        for (int i = 0; i < actual.rows(); ++i) {
+            for (int j = 0; j < actual.cols(); ++j) {
+                EXPECT_NEAR(actual(i,j), expected(i,j), 1e-12);
+            }
+        }
+    }
+};
+
+TEST_F(jacobian_fixture, square)
+{
+    check_eq(ad::jacobian(f(), x), f_jacobian());
+    check_eq(ad::jacobian<1>(f(), x), f_jacobian());
+    check_eq(ad::jacobian<8>(f(), x), f_jacobian());
+}
+
+TEST_F(jacobian_fixture, forward_reverse_agree)
+{
+    auto g = f();
+    matrix_t Jf(n, n), Jr(n, n);
+    JacobianWorker<value_t, 2, decltype(g), true> fworker(g, x);
+    JacobianWorker<value_t, 2, decltype(g), false> rworker(g, x);
+    for (size_t k = 0; k < n; k += 2) {
+        fworker.cols(k, Jf);
+        rworker.rows(k, Jr);
+    }
+    check_eq(Jf, f_jacobian());
+    check_eq(Jr, f_jacobian());
+}
+
+TEST_F(jacobian_fixture, reverse_wide)
+{
+    // 2 outputs, 5 inputs: reverse mode with a single sweep
+    Eigen::MatrixXd A(2, n);
+    A << 1., 2., 3., 4., 5.,
+         -1., 0.5, 0., 2., -3.;
+    auto J = ad::jacobian([&](auto& x) {
+                // constants must have the value type of x
+                using v_t = typename std::decay_t<decltype(x)>::value_t;
+                Eigen::Matrix<v_t, Eigen::Dynamic, Eigen::Dynamic> Av = A.cast<v_t>();
+                return ad::sin(ad::dot(Av, x));
+            }, x);
+    vector_t Ax = A * x;
+    matrix_t expected(2, n);
+    for (int i = 0; i < 2; ++i) {
+        expected.row(i) = std::cos(Ax(i)) * A.row(i);
+    }
+    check_eq(J, expected);
+}
+
+TEST_F(jacobian_fixture, scalar_output)
+{
+    auto J = ad::jacobian([](auto& x) { return ad::sum(x * x); }, x);
+    check_eq(J, 2. * x.transpose());
+}
+
+TEST_F(jacobian_fixture, bound_expr)
+{
+    Var<value_t, vec> v(n);
+    Var<value_t> s(2.), w;
+    v.get() = x;
+    auto expr = ad::bind((w = s * s, ad::exp(v) * w + v * s));
+    auto J = ad::jacobian(expr, v, s);
+    ASSERT_EQ(J.rows(), static_cast<int>(n));
+    ASSERT_EQ(J.cols(), static_cast<int>(n + 1));
+
+    matrix_t expected = matrix_t::Zero(n, n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        expected(i,i) = std::exp(x(i)) * 4. + 2.;
+        expected(i,n) = std::exp(x(i)) * 4. + x(i);
+    }
+    check_eq(J, expected);
+
+    // repeated calls give the same result
+    check_eq(ad::jacobian(expr, v, s), expected);
+}
+
+} // namespace core
+} // namespace ad
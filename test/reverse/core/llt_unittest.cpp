@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/det.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
+#include <fastad_bits/reverse/stat/wishart.hpp>
+
+namespace ad {
+namespace core {
+
+struct llt_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using mat_t = Eigen::MatrixXd;
+
+    static constexpr size_t n = 3;
+
+    Var<value_t, mat> S{n, n};
+    Var<value_t, mat> X{n, n};
+    Var<value_t, vec> x{n};
+    Var<value_t, vec> mu{n};
+
+    llt_fixture()
+    {
+        S.get() << 4., 1., 0.5,
+                   1., 3., 0.2,
+                   0.5, 0.2, 2.;
+        X.get() << 5., 1., 0.,
+                   1., 5., 1.,
+                   0., 1., 5.;
+        x.get() << 0.3, -1.2, 0.8;
+        mu.get() << 0.1, 0.4, -0.5;
+    }
+
+    void reset_adj()
+    {
+        S.reset_adj();
+        X.reset_adj();
+        x.reset_adj();
+        mu.reset_adj();
+    }
+
+    void check_eq(const mat_t& actual, const mat_t& expected)
+    {
+        ASSERT_EQ(actual.rows(), expected.rows());
+        ASSERT_EQ(actual.cols(), expected.cols());
+        for (int i = 0; i < actual.rows(); ++i) {
+            for (int j = 0; j < actual.cols(); ++j) {
+                EXPECT_NEAR(actual(i,j), expected(i,j), 1e-12);
+            }
+        }
+    }
+
+    // compares the value and gradients of the two expressions
+    template <class E1, class E2>
+    void check_same(E1&& e1, E2&& e2)
+    {
+        auto expr1 = ad::bind(e1);
+        value_t res1 = ad::autodiff(expr1);
+        mat_t S_adj = S.get_adj(), X_adj = X.get_adj();
+        mat_t x_adj = x.get_adj(), mu_adj = mu.get_adj();
+
+        reset_adj();
+        auto expr2 = ad::bind(e2);
+        EXPECT_NEAR(ad::autodiff(expr2), res1, 1e-12);
+        check_eq(S.get_adj(), S_adj);
+        check_eq(X.get_adj(), X_adj);
+        check_eq(x.get_adj(), x_adj);
+        check_eq(mu.get_adj(), mu_adj);
+    }
+};
+
+TEST_F(llt_fixture, log_det)
+{
+    check_same(ad::log_det<LogDetLLT>(S),
+               ad::log_det(ad::llt(S)));
+}
+
+TEST_F(llt_fixture, det)
+{
+    check_same(ad::det<DetLLT>(S),
+               ad::det(ad::llt(S)));
+}
+
+TEST_F(llt_fixture, inv_quad_form)
+{
+    auto expr = ad::bind(ad::inv_quad_form(S, x));
+    value_t res = ad::autodiff(expr);
+
+    Eigen::VectorXd z = S.get().llt().solve(x.get());
+    EXPECT_NEAR(res, x.get().dot(z), 1e-12);
+    check_eq(x.get_adj(), 2. * z);
+    check_eq(S.get_adj(), -z * z.transpose());
+}
+
+TEST_F(llt_fixture, inv_quad_form_not_pos_def)
+{
+    S.get()(0,0) = -1.;
+    auto expr = ad::bind(ad::inv_quad_form(ad::llt(S), x));
+    EXPECT_EQ(ad::autodiff(expr), util::inf<value_t>);
+    check_eq(S.get_adj(), mat_t::Zero(n, n));
+}
+
+TEST_F(llt_fixture, shared_consumers)
+{
+    // one factor of S is used by every node
+    check_same(ad::normal_adj_log_pdf(x, mu, S) +
+               ad::log_det<LogDetLLT>(S) +
+               ad::inv_quad_form(S, mu),
+               [&]() {
+                    auto L = ad::llt(S);
+                    return ad::normal_adj_log_pdf(x, mu, L) +
+                           ad::log_det(L) +
+                           ad::inv_quad_form(L, mu);
+               }());
+}
+
+TEST_F(llt_fixture, wishart)
+{
+    check_same(ad::wishart_adj_log_pdf(X, S, 5.) + ad::log_det<LogDetLLT>(S),
+               [&]() {
+                    auto L = ad::llt(S);
+                    return ad::wishart_adj_log_pdf(ad::llt(X), L, 5.) +
+                           ad::log_det(L);
+               }());
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,187 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/map_reduce.hpp>
+
+namespace ad {
+namespace core {
+
+struct map_reduce_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using vector_t = Eigen::VectorXd;
+    using matrix_t = Eigen::MatrixXd;
+
+    static constexpr size_t n = 37;
+    static constexpr size_t p = 3;
+
+    matrix_t data;                  // rows (x, y)
+    vector_t theta;
+
+    map_reduce_fixture()
+        : data(n, p+1)
+        , theta(p)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j <= p; ++j) {
+                data(i,j) = std::sin(0.7 * i + 1.3 * j);
+            }
+        }
+        theta << 0.4, -1.1, 0.25;
+    }
+
+    // least squares loss of a row
+    static auto least_squares()
+    {
+        return [](const auto& row, auto& w) {
+            auto x = row.segment(0, p);
+            auto y = row.segment(p, 1);
+            return ad::sum(ad::pow<2>(y - ad::dot(w, x)));
+        };
+    }
+
+    // loss and gradient of least squares
+    value_t expected(vector_t& grad) const
+    {
+        const auto X = data.leftCols(p);
+        vector_t r = data.col(p) - X * theta;
+        grad = -2. * X.transpose() * r;
+        return r.squaredNorm();
+    }
+
+    void check_eq(const vector_t& actual, const vector_t& expected)
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (int i = 0; i < actual.size(); ++i) {
+            EXPECT_NEAR(actual(i), expected(i), 1e-10);
+        }
+    }
+};
+
+TEST_F(map_reduce_fixture, serial)
+{
+    vector_t grad = vector_t::Zero(p);
+    VarView<value_t, mat> w(theta.data(), grad.data(), 1, p);
+    value_t loss = ad::map_reduce(data, least_squares(), w);
+
+    vector_t grad_expected;
+    EXPECT_NEAR(loss, expected(grad_expected), 1e-10);
+    check_eq(grad, grad_expected);
+}
+
+TEST_F(map_reduce_fixture, layouts)
+{
+    // rows viewed in place (row-major and transposed column-major data)
+    // or copied (strided rows and rows of another value type)
+    using row_major_t = Eigen::Matrix<value_t, Eigen::Dynamic, Eigen::Dynamic,
+                                      Eigen::RowMajor>;
+    row_major_t data_rm = data;
+    matrix_t data_t = data.transpose();
+    Eigen::MatrixXf data_f = data.cast<float>();
+    row_major_t wide(n, 2*(p+1));
+    wide.setConstant(1e3);
+    Eigen::Map<row_major_t, 0, Eigen::Stride<Eigen::Dynamic, 2>>
+        data_strided(wide.data(), n, p+1,
+                     Eigen::Stride<Eigen::Dynamic, 2>(2*(p+1), 2));
+    data_strided = data;
+
+    vector_t grad_expected;
+    value_t loss_expected = expected(grad_expected);
+    auto check = [&](const auto& d, double tol) {
+        vector_t grad = vector_t::Zero(p);
+        VarView<value_t, mat> w(theta.data(), grad.data(), 1, p);
+        value_t loss = ad::map_reduce(d, least_squares(), w);
+        EXPECT_NEAR(loss, loss_expected, tol);
+        for (size_t i = 0; i < p; ++i) {
+            EXPECT_NEAR(grad(i), grad_expected(i), tol);
+        }
+    };
+    check(data_rm, 1e-10);
+    check(data_t.transpose(), 1e-10);
+    check(data_rm.middleRows(0, n), 1e-10);
+    check(data, 1e-10);
+    check(data_strided, 1e-10);
+    check(data_f, 1e-5);
+}
+
+TEST_F(map_reduce_fixture, par)
+{
+    vector_t grad_expected;
+    value_t loss_expected = expected(grad_expected);
+    for (size_t n_threads : {1, 2, 4}) {
+        for (bool deterministic : {false, true}) {
+            vector_t grad = vector_t::Zero(p);
+            VarView<value_t, mat> w(theta.data(), grad.data(), 1, p);
+            value_t loss = ad::map_reduce(ad::par(n_threads, deterministic),
+                                          data, least_squares(), w);
+            EXPECT_NEAR(loss, loss_expected, 1e-10);
+            check_eq(grad, grad_expected);
+        }
+    }
+}
+
+TEST_F(map_reduce_fixture, par_deterministic)
+{
+    auto policy = ad::par(4, true);
+    vector_t grad1 = vector_t::Zero(p);
+    vector_t grad2 = vector_t::Zero(p);
+    VarView<value_t, mat> w1(theta.data(), grad1.data(), 1, p);
+    VarView<value_t, mat> w2(theta.data(), grad2.data(), 1, p);
+    value_t loss1 = ad::map_reduce(policy, data, least_squares(), w1);
+    value_t loss2 = ad::map_reduce(policy, data, least_squares(), w2);
+    EXPECT_EQ(loss1, loss2);
+    for (size_t i = 0; i < p; ++i) {
+        EXPECT_EQ(grad1(i), grad2(i));
+    }
+}
+
+TEST_F(map_reduce_fixture, par_nested_same_pool)
+{
+    // f returns a parallel sum with the pool of the outer policy,
+    // which runs serially on the thread evaluating it
+    auto policy = ad::par(4);
+    auto f = [&](const auto& row, auto& w) {
+        std::vector<value_t> halves = {0.5, 0.5};
+        return ad::sum(policy, halves.begin(), halves.end(), [&](value_t h) {
+                    auto x = row.segment(0, p);
+                    auto y = row.segment(p, 1);
+                    return h * ad::sum(ad::pow<2>(y - ad::dot(w, x)));
+                });
+    };
+    vector_t grad = vector_t::Zero(p);
+    VarView<value_t, mat> w(theta.data(), grad.data(), 1, p);
+    value_t loss = ad::map_reduce(policy, data, f, w);
+
+    vector_t grad_expected;
+    EXPECT_NEAR(loss, expected(grad_expected), 1e-10);
+    check_eq(grad, grad_expected);
+}
+
+TEST_F(map_reduce_fixture, scl_accumulates)
+{
+    // sum_i exp(a * x_i) with x_i the first column
+    Var<value_t> a(0.3);
+    a.get_adj() = 1.;
+    auto f = [](const auto& row, auto& a) {
+        return ad::sum(ad::exp(a * row.segment(0, 1)));
+    };
+    value_t res = ad::map_reduce(ad::par(3), data, f, a);
+
+    value_t res_expected = 0;
+    value_t adj_expected = 1.;
+    for (size_t i = 0; i < n; ++i) {
+        value_t e = std::exp(a.get() * data(i,0));
+        res_expected += e;
+        adj_expected += e * data(i,0);
+    }
+    EXPECT_NEAR(res, res_expected, 1e-10);
+    EXPECT_NEAR(a.get_adj(), adj_expected, 1e-10);
+}
+
+} // namespace core
+} // namespace ad
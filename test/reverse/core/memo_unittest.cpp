@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/constant.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/checkpoint.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/memo.hpp>
+
+namespace ad {
+namespace core {
+
+struct memo_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> x{1.3}, w{-0.7}, p, u;
+    Var<value_t, vec> v{3};
+
+    memo_fixture()
+    {
+        v.get() << 0.2, -1.1, 0.5;
+    }
+
+    void reset_adj()
+    {
+        x.reset_adj();
+        w.reset_adj();
+        v.reset_adj();
+        p.reset_adj();
+        u.reset_adj();
+    }
+
+    // Runs autodiff on both expressions after every change of the leaves
+    // and checks that they agree.
+    template <class ExprType1, class ExprType2>
+    void check_steps(ExprType1& expr, ExprType2& memo_expr)
+    {
+        for (int step = 0; step < 6; ++step) {
+            if (step % 2) x.get() += 0.1;
+            if (step % 3 == 2) v.get()(1) -= 0.2;
+            reset_adj();
+            value_t res = ad::autodiff(expr);
+            value_t x_adj = x.get_adj();
+            value_t w_adj = w.get_adj();
+            Eigen::VectorXd v_adj = v.get_adj();
+
+            reset_adj();
+            EXPECT_DOUBLE_EQ(ad::autodiff(memo_expr), res);
+            EXPECT_DOUBLE_EQ(x.get_adj(), x_adj);
+            EXPECT_DOUBLE_EQ(w.get_adj(), w_adj);
+            for (size_t i = 0; i < v.size(); ++i) {
+                EXPECT_DOUBLE_EQ(v.get_adj()(i), v_adj(i));
+            }
+        }
+    }
+};
+
+TEST_F(memo_fixture, skips_unchanged_inputs)
+{
+    // values viewed by a constant are not inputs,
+    // so changing them shows whether the subexpression is evaluated
+    Eigen::VectorXd c(1);
+    c << 2.;
+    auto expr = ad::bind(ad::memo(ad::sum(ad::constant_view(c.data(), 1) * w)));
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), 2. * w.get());
+
+    c << 3.;
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), 2. * w.get());
+
+    w.get() = 0.5;
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), 3. * 0.5);
+}
+
+TEST_F(memo_fixture, value_adj)
+{
+    auto expr = ad::bind(
+            ad::memo(ad::sin(x) * w) + ad::memo(ad::sum(ad::exp(v) * w)) * x);
+    auto memo_free = ad::bind(
+            ad::sin(x) * w + ad::sum(ad::exp(v) * w) * x);
+    check_steps(memo_free, expr);
+}
+
+TEST_F(memo_fixture, zero_seed)
+{
+    auto expr = ad::bind(ad::memo(ad::sin(x) * w) * 0.);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 0.);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 0.);
+    EXPECT_DOUBLE_EQ(w.get_adj(), 0.);
+}
+
+TEST_F(memo_fixture, placeholder_overwritten)
+{
+    // p is written by the memoized statement and overwritten afterwards,
+    // so the statement is evaluated again even though x and w are unchanged
+    auto expr = ad::bind((ad::memo(p = ad::sin(x) * w), p = p * x, p * w));
+    auto memo_free = ad::bind((p = ad::sin(x) * w, p = p * x, p * w));
+    check_steps(memo_free, expr);
+}
+
+TEST_F(memo_fixture, placeholder_read_outside)
+{
+    // p gets its adjoint from outside of the memoized statement
+    auto expr = ad::bind((ad::memo(p = ad::sin(x) * w), p * p * 0. + p * x));
+    auto memo_free = ad::bind((p = ad::sin(x) * w, p * p * 0. + p * x));
+    check_steps(memo_free, expr);
+}
+
+TEST_F(memo_fixture, placeholder_root)
+{
+    // p views the value of the memoized subexpression, skipped or not
+    auto expr = ad::bind((p = ad::memo(x * x), p * 3.));
+    auto memo_free = ad::bind((p = x * x, p * 3.));
+    check_steps(memo_free, expr);
+    x.get() = 2.;
+    reset_adj();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 12.);
+    EXPECT_DOUBLE_EQ(p.get(), 4.);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 12.);
+}
+
+TEST_F(memo_fixture, checkpoint)
+{
+    std::vector<int> idx(5);
+    auto f = [&](int) { return u = ad::sin(u) * w + x; };
+    auto expr = ad::bind(ad::memo(
+                (u = x * w, ad::checkpoint_for_each(idx.begin(), idx.end(), f, 2), u * v[0])));
+    auto memo_free = ad::bind(
+                (u = x * w, ad::checkpoint_for_each(idx.begin(), idx.end(), f, 2), u * v[0]));
+    check_steps(memo_free, expr);
+}
+
+TEST_F(memo_fixture, if_else_shared_cache)
+{
+    // the else branch is bound to the same cache as the memoized subexpression
+    // and overwrites the value of sin(x) that its backward evaluation reads
+    Var<value_t> c(1.);
+    auto expr = ad::bind(ad::if_else(c > 0., ad::memo(ad::sin(x) * x), ad::exp(w)));
+    auto memo_free = ad::bind(ad::if_else(c > 0., ad::sin(x) * x, ad::exp(w)));
+    for (value_t cv : {1., -1., 1.}) {
+        c.get() = cv;
+        reset_adj();
+        value_t res = ad::autodiff(memo_free);
+        value_t x_adj = x.get_adj();
+        value_t w_adj = w.get_adj();
+
+        reset_adj();
+        EXPECT_DOUBLE_EQ(ad::autodiff(expr), res);
+        EXPECT_DOUBLE_EQ(x.get_adj(), x_adj);
+        EXPECT_DOUBLE_EQ(w.get_adj(), w_adj);
+    }
+}
+
+TEST_F(memo_fixture, copies)
+{
+    auto expr = ad::bind(ad::memo(ad::sin(x) * w));
+    auto copy = expr;
+    EXPECT_DOUBLE_EQ(ad::evaluate(copy), std::sin(x.get()) * w.get());
+    x.get() = 0.2;
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), std::sin(0.2) * w.get());
+    EXPECT_DOUBLE_EQ(ad::evaluate(copy), std::sin(0.2) * w.get());
+}
+
+TEST_F(memo_fixture, value_bind)
+{
+    auto expr = ad::bind_value(ad::memo(ad::sum(ad::exp(v) * w)));
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), v.get().array().exp().sum() * w.get());
+    w.get() = 2.;
+    EXPECT_DOUBLE_EQ(ad::evaluate(expr), v.get().array().exp().sum() * 2.);
+}
+
+} // namespace core
+} // namespace ad
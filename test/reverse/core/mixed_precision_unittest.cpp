@@ -0,0 +1,220 @@
+#include "gtest/gtest.h"
+#include <type_traits>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
+#include <fastad_bits/reverse/core/pow.hpp>
+#include <fastad_bits/reverse/core/norm.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/prod.hpp>
+#include <fastad_bits/reverse/core/det.hpp>
+#include <fastad_bits/reverse/core/log_det.hpp>
+#include <fastad_bits/reverse/core/llt.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/stat/bernoulli.hpp>
+#include <fastad_bits/reverse/stat/cauchy.hpp>
+#include <fastad_bits/reverse/stat/normal.hpp>
+#include <fastad_bits/reverse/stat/uniform.hpp>
+#include <fastad_bits/reverse/stat/wishart.hpp>
+
+namespace ad {
+namespace core {
+
+struct mixed_precision_fixture : ::testing::Test
+{
+protected:
+    // Leaves of value type T with the same values in every fixture.
+    template <class T>
+    struct Leaves
+    {
+        Var<T> x{0.7f};
+        Var<T, vec> v{3};
+        Var<T, mat> m{3, 3};
+
+        Leaves()
+        {
+            v.get() << 0.2f, -0.4f, 0.9f;
+            m.get() << 4.f, 1.f, 0.5f,
+                       1.f, 3.f, 0.2f,
+                       0.5f, 0.2f, 2.f;
+        }
+    };
+
+    /*
+     * Evaluates f on float and on double leaves and checks
+     * that the values and adjoints agree up to float precision.
+     */
+    template <class F>
+    void check_float(F f)
+    {
+        Leaves<double> d;
+        auto expr_d = ad::bind(f(d.x, d.v, d.m));
+        double res_d = ad::autodiff(expr_d);
+
+        Leaves<float> s;
+        auto expr_s = ad::bind(f(s.x, s.v, s.m));
+        static_assert(std::is_same_v<decltype(ad::autodiff(expr_s)), float>);
+        float res_s = ad::autodiff(expr_s);
+
+        check_near(res_s, res_d);
+        check_near(s.x.get_adj(), d.x.get_adj());
+        for (size_t i = 0; i < d.v.size(); ++i) {
+            check_near(s.v.get_adj()(i), d.v.get_adj()(i));
+        }
+        for (size_t i = 0; i < d.m.rows(); ++i) {
+            for (size_t j = 0; j < d.m.cols(); ++j) {
+                check_near(s.m.get_adj()(i,j), d.m.get_adj()(i,j));
+            }
+        }
+    }
+
+    void check_near(float actual, double expected)
+    {
+        EXPECT_NEAR(actual, expected, 1e-4 * std::max(1., std::abs(expected)));
+    }
+};
+
+TEST_F(mixed_precision_fixture, literals_keep_value_type)
+{
+    Var<float> x;
+    Var<float, vec> v(3);
+    static_assert(std::is_same_v<
+            util::expr_traits<decltype(2. * x + 1)>::value_t, float>);
+    static_assert(std::is_same_v<
+            util::expr_traits<decltype(ad::sum(v) * 2.)>::value_t, float>);
+    static_assert(std::is_same_v<
+            util::expr_traits<decltype(ad::if_else(x < 0., x, 0.))>::value_t, float>);
+    static_assert(std::is_same_v<
+            util::expr_traits<decltype(x += 2.)>::value_t, float>);
+    static_assert(std::is_same_v<
+            util::expr_traits<decltype(ad::normal_adj_log_pdf(v, 0., 1.))>::value_t, float>);
+
+    // literals with double expressions are unchanged
+    Var<double> y;
+    static_assert(std::is_same_v<
+            util::expr_traits<decltype(2.f * y + 1)>::value_t, double>);
+}
+
+TEST_F(mixed_precision_fixture, unary)
+{
+    check_float([](auto& x, auto& v, auto&) {
+        return ad::sin(x) * ad::cos(x) + ad::tan(x) +
+               ad::asin(x) + ad::acos(x) + ad::atan(x) +
+               ad::exp(x) + ad::log(x) + ad::sqrt(x) + ad::erf(x) +
+               ad::sigmoid(x) + ad::sinh(x) + ad::cosh(x) + ad::tanh(x) +
+               ad::sum(ad::sigmoid(v) * ad::tanh(v) + ad::sinh(v) + ad::cosh(v));
+    });
+}
+
+TEST_F(mixed_precision_fixture, binary_literals)
+{
+    check_float([](auto& x, auto& v, auto&) {
+        return 2. * x + x / 3 - 1.5 + ad::sum(v * 0.1 - 2.);
+    });
+}
+
+TEST_F(mixed_precision_fixture, placeholders)
+{
+    // placeholders must outlive the bound expressions
+    Var<double> w_d;
+    Var<float> w_s;
+    check_float([&](auto& x, auto& v, auto&) {
+        using value_t = typename std::decay_t<decltype(x)>::value_t;
+        auto& w = [&]() -> Var<value_t>& {
+            if constexpr (std::is_same_v<value_t, float>) return w_s;
+            else return w_d;
+        }();
+        return (w = x * x, w += ad::sin(w), ad::sum(v * w));
+    });
+}
+
+TEST_F(mixed_precision_fixture, reductions)
+{
+    check_float([](auto& x, auto& v, auto& m) {
+        return ad::pow<3>(x) + ad::pow<-2>(x) + ad::norm(v) + ad::norm(m) +
+               ad::sum(ad::dot(m, v)) + ad::prod(v) + ad::sum(m);
+    });
+}
+
+TEST_F(mixed_precision_fixture, matrix)
+{
+    check_float([](auto&, auto& v, auto& m) {
+        return ad::det<DetLLT>(m) + ad::det<DetFullPivLU>(m) +
+               ad::log_det<LogDetLDLT>(m) + ad::log_det(ad::llt(m)) +
+               ad::inv_quad_form(m, v);
+    });
+}
+
+TEST_F(mixed_precision_fixture, stat)
+{
+    check_float([](auto& x, auto& v, auto& m) {
+        return ad::normal_adj_log_pdf(v, x, x) +
+               ad::normal_adj_log_pdf(v, 0., 2.) +
+               ad::normal_adj_log_pdf(v, v * x, ad::exp(v)) +
+               ad::normal_adj_log_pdf(v, x, m) +
+               ad::cauchy_adj_log_pdf(v, x, 1.) +
+               ad::uniform_adj_log_pdf(v, -x - 1., x + 1.) +
+               ad::bernoulli_adj_log_pdf(1, ad::sigmoid(x)) +
+               ad::wishart_adj_log_pdf(m, m * x, 5.);
+    });
+}
+
+TEST_F(mixed_precision_fixture, accumulator)
+{
+    // sum of many small seeds
+    constexpr size_t n = 100000;
+    constexpr float seed = 1e-3f;
+
+    Var<float, vec> w(2);
+    auto expr = ad::bind(ad::sum(w));
+
+    for (size_t i = 0; i < n; ++i) ad::autodiff(expr, seed);
+    float err_float = std::abs(w.get_adj()(0) - n * double(seed));
+
+    w.reset_adj();
+    {
+        AdjAccumulator<float> acc(w);
+        for (size_t i = 0; i < n; ++i) ad::autodiff(expr, seed);
+
+        // adjoints are only written on flush
+        EXPECT_EQ(w.get_adj()(0), 0.f);
+    }
+    float err_acc = std::abs(w.get_adj()(0) - n * double(seed));
+
+    EXPECT_NEAR(w.get_adj()(0), n * double(seed), 1e-4);
+    EXPECT_EQ(w.get_adj()(0), w.get_adj()(1));
+    EXPECT_LT(100 * err_acc, err_float);
+}
+
+TEST_F(mixed_precision_fixture, accumulator_subviews_placeholders)
+{
+    Var<float, vec> w(2);
+    Var<float> x(3.f), p;
+    w.get() << 2.f, -1.f;
+
+    auto expr = ad::bind((p = w[0] * w[1] * x, p * p));
+    {
+        AdjAccumulator<float> acc(w);
+        for (int i = 0; i < 4; ++i) {
+            p.reset_adj();
+            ad::autodiff(expr);
+        }
+
+        // x is not accumulated
+        EXPECT_FLOAT_EQ(x.get_adj(), 4 * 2.f * (-6.f) * (-2.f));
+        acc.flush();
+        EXPECT_FLOAT_EQ(w.get_adj()(0), 4 * 2.f * (-6.f) * (-3.f));
+        EXPECT_FLOAT_EQ(w.get_adj()(1), 4 * 2.f * (-6.f) * 6.f);
+        p.reset_adj();
+        ad::autodiff(expr);
+    }
+    EXPECT_FLOAT_EQ(w.get_adj()(0), 5 * 2.f * (-6.f) * (-3.f));
+    EXPECT_FLOAT_EQ(w.get_adj()(1), 5 * 2.f * (-6.f) * 6.f);
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,191 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/for_each.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/schedule.hpp>
+#include <fastad_bits/reverse/core/bind.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <testutil/base_fixture.hpp>
+
+namespace ad {
+namespace core {
+
+struct schedule_fixture : base_fixture
+{
+protected:
+    value_t seed = 3.14;
+
+    Var<value_t> x{1.5};
+    Var<value_t> y{-0.7};
+    Var<value_t> w1, w2, w3;
+    std::vector<Var<value_t>> ws = std::vector<Var<value_t>>(200);
+    std::vector<size_t> idx;
+
+    schedule_fixture()
+        : base_fixture()
+        , idx(ws.size())
+    {
+        for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+    }
+
+    template <class F>
+    void check_glue(F make)
+    {
+        auto seq = make();
+        bind(seq);
+        value_t expected = seq.feval();
+        seq.beval(seed);
+        value_t x_adj = x.get_adj();
+        value_t y_adj = y.get_adj();
+
+        for (bool deterministic : {false, true}) {
+            reset_adj();
+            auto expr = ad::schedule(ad::par(4, deterministic), make());
+            bind(expr);
+            EXPECT_DOUBLE_EQ(expr.feval(), expected);
+            expr.beval(seed);
+            EXPECT_NEAR(x.get_adj(), x_adj, 1e-12);
+            EXPECT_NEAR(y.get_adj(), y_adj, 1e-12);
+        }
+    }
+
+    void reset_adj()
+    {
+        for (auto* v : {&x, &y, &w1, &w2, &w3}) v->reset_adj();
+        for (auto& w : ws) w.reset_adj();
+    }
+};
+
+TEST_F(schedule_fixture, glue_independent)
+{
+    check_glue([&]() {
+        return (w1 = ad::sin(x) * y,
+                w2 = ad::exp(x) + y,
+                w1 * w2 + x);
+    });
+}
+
+TEST_F(schedule_fixture, glue_chain)
+{
+    // w3 depends on both w1 and w2 and w1 is read by many statements
+    check_glue([&]() {
+        return (w1 = ad::sin(x) * y,
+                w2 = ad::exp(x) * w1,
+                w3 = w1 * w2 + w1,
+                w3 * x + w1);
+    });
+}
+
+TEST_F(schedule_fixture, opeq_chain)
+{
+    std::vector<value_t> xs = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+    check_glue([&]() {
+        return (w1 = x,
+                ad::for_each(xs.begin(), xs.end(),
+                    [&](value_t c) { return w1 += ad::sin(x * c) * y; }),
+                w1 * x);
+    });
+}
+
+TEST_F(schedule_fixture, for_each_shared_leaves)
+{
+    // many independent statements that share leaves x and y
+    check_glue([&]() {
+        return (ad::for_each(idx.begin(), idx.end(),
+                    [&](size_t i) { return ws[i] = ad::sin(x * (0.01 * i) + y); }),
+                ad::sum(ws.begin(), ws.end(), [](const VarView<value_t>& w) { return w; }));
+    });
+}
+
+TEST_F(schedule_fixture, copy_move)
+{
+    // statements point into the node, so copies and moves must not see the original
+    auto make = [&]() {
+        return (ad::for_each(idx.begin(), idx.end(),
+                    [&](size_t i) { return ws[i] = ad::sin(x * (0.01 * i) + y); }),
+                w1 = ad::sum(ws.begin(), ws.end(), [](const VarView<value_t>& w) { return w; }),
+                w1 * x);
+    };
+    auto seq = make();
+    bind(seq);
+    value_t expected = seq.feval();
+    seq.beval(seed);
+    value_t x_adj = x.get_adj();
+    value_t y_adj = y.get_adj();
+
+    auto check = [&](auto& expr) {
+        reset_adj();
+        EXPECT_DOUBLE_EQ(ad::autodiff(expr, seed), expected);
+        EXPECT_NEAR(x.get_adj(), x_adj, 1e-12);
+        EXPECT_NEAR(y.get_adj(), y_adj, 1e-12);
+    };
+
+    for (bool deterministic : {false, true}) {
+        auto bound = ad::bind(ad::schedule(ad::par(4, deterministic), make()));
+        auto moved = std::make_unique<decltype(bound)>(std::move(bound));
+        check(*moved);
+        auto copied = std::make_unique<decltype(bound)>(*moved);
+        moved.reset();
+        check(*copied);
+
+        // copy of a bound node, then bound again
+        auto node = ad::schedule(ad::par(4, deterministic), make());
+        bind(node);
+        auto node_copy = std::make_unique<decltype(node)>(node);
+        auto node_bound = ad::bind(std::move(*node_copy));
+        node_copy.reset();
+        check(node_bound);
+    }
+}
+
+TEST_F(schedule_fixture, vec_beval)
+{
+    Var<value_t, ad::vec> v(vec_size), u(vec_size);
+    v.get() = vec_expr.get();
+    aVectorXd vseed = aVectorXd::LinSpaced(vec_size, -1., 2.);
+
+    auto make = [&]() { return (u = ad::sin(v) * x, u * v); };
+
+    auto seq = make();
+    bind(seq);
+    Eigen::VectorXd expected = seq.feval();
+    seq.beval(vseed);
+    Eigen::VectorXd v_adj = v.get_adj();
+    value_t x_adj = x.get_adj();
+
+    v.reset_adj(); u.reset_adj(); x.reset_adj();
+    auto expr = ad::schedule(ad::par(2), make());
+    bind(expr);
+    Eigen::VectorXd res = expr.feval();
+    expr.beval(vseed);
+    for (size_t i = 0; i < vec_size; ++i) {
+        EXPECT_DOUBLE_EQ(res(i), expected(i));
+        EXPECT_NEAR(v.get_adj(i, 0), v_adj(i), 1e-12);
+    }
+    EXPECT_NEAR(x.get_adj(), x_adj, 1e-12);
+}
+
+TEST_F(schedule_fixture, deterministic)
+{
+    auto expr = ad::schedule(ad::par(4, true),
+            (ad::for_each(idx.begin(), idx.end(),
+                [&](size_t i) { return ws[i] = ad::exp(x * (1e-3 * i * (i % 7))); }),
+             ad::sum(ws.begin(), ws.end(), [](const VarView<value_t>& w) { return w; })));
+    bind(expr);
+    value_t first = expr.feval();
+    expr.beval(seed);
+    value_t first_adj = x.get_adj();
+    for (int k = 0; k < 10; ++k) {
+        reset_adj();
+        EXPECT_EQ(expr.feval(), first);
+        expr.beval(seed);
+        EXPECT_EQ(x.get_adj(), first_adj);
+    }
+}
+
+} // namespace core
+} // namespace ad
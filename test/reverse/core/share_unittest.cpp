@@ -0,0 +1,198 @@
+#include "gtest/gtest.h"
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/if_else.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/share.hpp>
+
+namespace ad {
+namespace core {
+
+struct share_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    Var<value_t> x{1.3}, w{-0.7};
+    Var<value_t, vec> v{3};
+
+    share_fixture()
+    {
+        v.get() << 0.2, -1.1, 0.5;
+    }
+
+    void reset_adj()
+    {
+        x.reset_adj();
+        w.reset_adj();
+        v.reset_adj();
+    }
+};
+
+TEST_F(share_fixture, scl_value_adj)
+{
+    auto u = ad::share(x * w);
+    auto expr = ad::bind(ad::sin(u) + u * u);
+    value_t res = ad::autodiff(expr);
+
+    value_t uv = x.get() * w.get();
+    EXPECT_DOUBLE_EQ(res, std::sin(uv) + uv * uv);
+    value_t du = std::cos(uv) + 2. * uv;
+    EXPECT_DOUBLE_EQ(x.get_adj(), du * w.get());
+    EXPECT_DOUBLE_EQ(w.get_adj(), du * x.get());
+}
+
+TEST_F(share_fixture, matches_placeholder)
+{
+    Var<value_t> p;
+    auto expr_p = ad::bind((p = ad::exp(x) * w, p * ad::cos(p) + p));
+    value_t res_p = ad::autodiff(expr_p);
+    value_t x_adj = x.get_adj();
+    value_t w_adj = w.get_adj();
+
+    reset_adj();
+    auto u = ad::share(ad::exp(x) * w);
+    auto expr = ad::bind(u * ad::cos(u) + u);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), res_p);
+    EXPECT_DOUBLE_EQ(x.get_adj(), x_adj);
+    EXPECT_DOUBLE_EQ(w.get_adj(), w_adj);
+}
+
+TEST_F(share_fixture, vec_value_adj)
+{
+    auto u = ad::share(ad::exp(v) * x);
+    auto expr = ad::bind(ad::sum(u * u) + ad::sum(u));
+    value_t res = ad::autodiff(expr);
+
+    Eigen::ArrayXd uv = v.get().array().exp() * x.get();
+    EXPECT_DOUBLE_EQ(res, (uv * uv).sum() + uv.sum());
+    Eigen::ArrayXd du = 2. * uv + 1.;
+    value_t x_adj = (du * v.get().array().exp()).sum();
+    EXPECT_DOUBLE_EQ(x.get_adj(), x_adj);
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_DOUBLE_EQ(v.get_adj()(i), du(i) * uv(i));
+    }
+}
+
+TEST_F(share_fixture, bind_cache_size)
+{
+    auto e = ad::exp(x) * w;
+    auto u = ad::share(e);
+    auto unshared = e * ad::sin(e) + e;
+    auto shared = u * ad::sin(u) + u;
+
+    // the shared subexpression is bound once
+    auto e_size = e.bind_cache_size();
+    util::SizePack expected = unshared.bind_cache_size() - 2 * e_size;
+    util::SizePack actual = shared.bind_cache_size();
+    EXPECT_EQ(actual(0), expected(0));
+    EXPECT_EQ(actual(1), expected(1));
+}
+
+TEST_F(share_fixture, evaluates_once)
+{
+    // u = w * x is fevaled once, so the placeholder doubles once
+    Var<value_t> p{1.};
+    auto u = ad::share((p *= 2., p * x));
+    auto expr = ad::bind(u + u * u);
+    ad::evaluate(expr);
+    EXPECT_DOUBLE_EQ(p.get(), 2.);
+}
+
+TEST_F(share_fixture, repeated_autodiff)
+{
+    auto u = ad::share(x * w);
+    auto expr = ad::bind(u * u);
+    ad::autodiff(expr);
+    reset_adj();
+    ad::autodiff(expr);
+    value_t uv = x.get() * w.get();
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * uv * w.get());
+    EXPECT_DOUBLE_EQ(w.get_adj(), 2. * uv * x.get());
+}
+
+TEST_F(share_fixture, bind_copies)
+{
+    auto u = ad::share(x * w);
+    auto e = u * ad::exp(u);
+    auto expr1 = ad::bind(e);
+    auto expr2 = ad::bind(e);
+    auto expr3 = expr1;
+
+    value_t uv = x.get() * w.get();
+    value_t du = std::exp(uv) * (1. + uv);
+    for (auto* expr : {&expr1, &expr2, &expr3}) {
+        reset_adj();
+        EXPECT_DOUBLE_EQ(ad::autodiff(*expr), uv * std::exp(uv));
+        EXPECT_DOUBLE_EQ(x.get_adj(), du * w.get());
+        EXPECT_DOUBLE_EQ(w.get_adj(), du * x.get());
+    }
+}
+
+TEST_F(share_fixture, bind_rvalues)
+{
+    // temporaries are moved into the ExprBind, but still get their own state
+    auto u = ad::share(x * w);
+    auto expr1 = ad::bind(u * ad::exp(u));
+    auto expr2 = ad::bind((ad::sum(v) + u) * u);
+
+    value_t uv = x.get() * w.get();
+    value_t du = std::exp(uv) * (1. + uv);
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr1), uv * std::exp(uv));
+    EXPECT_DOUBLE_EQ(x.get_adj(), du * w.get());
+    EXPECT_DOUBLE_EQ(w.get_adj(), du * x.get());
+
+    reset_adj();
+    value_t s = v.get().sum() + uv;
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr2), s * uv);
+    EXPECT_DOUBLE_EQ(x.get_adj(), (s + uv) * w.get());
+    EXPECT_DOUBLE_EQ(w.get_adj(), (s + uv) * x.get());
+}
+
+TEST_F(share_fixture, placeholder)
+{
+    // the use defining the placeholder copies the value into it
+    Var<value_t> p;
+    auto expr = ad::bind((p = ad::share(x * x), p * 3.));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 3. * x.get() * x.get());
+    EXPECT_DOUBLE_EQ(p.get(), x.get() * x.get());
+    EXPECT_DOUBLE_EQ(x.get_adj(), 6. * x.get());
+}
+
+TEST_F(share_fixture, if_else_condition)
+{
+    // the use in the condition is never backward evaluated
+    auto u = ad::share(x * x);
+    auto expr = ad::bind(ad::if_else(u > 0., u * 2., u));
+    value_t uv = x.get() * x.get();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 2. * uv);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 4. * x.get());
+
+    reset_adj();
+    auto expr_else = ad::bind(ad::if_else(u < 0., u * 2., u));
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr_else), uv);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 2. * x.get());
+}
+
+TEST_F(share_fixture, comparison)
+{
+    // the first use is only read by a comparison
+    auto u = ad::share(x * x);
+    auto expr = ad::bind((u > 1.) * u + u);
+    value_t uv = x.get() * x.get();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 2. * uv);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 4. * x.get());
+
+    // repeated passes with a different condition
+    x.get() = 0.5;
+    reset_adj();
+    EXPECT_DOUBLE_EQ(ad::autodiff(expr), 0.25);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 1.);
+}
+
+} // namespace core
+} // namespace ad
@@ -0,0 +1,158 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/dot.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/sparsity.hpp>
+
+namespace ad {
+namespace core {
+
+struct sparsity_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using vector_t = Eigen::VectorXd;
+    using matrix_t = Eigen::MatrixXd;
+    using tracer_t = SparsityTracer;
+    using set_t = tracer_t::set_t;
+
+    static constexpr size_t n = 8;
+    std::vector<size_t> idx;
+    vector_t x;
+
+    sparsity_fixture()
+        : idx(n-1)
+        , x(n)
+    {
+        for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+        for (size_t i = 0; i < n; ++i) x(i) = 0.1 * i - 0.3;
+    }
+
+    // y_i = x_i * x_{i+1} + sin(x_i), i = 0,...,n-2
+    static auto bidiagonal()
+    {
+        return [](auto& x) {
+            return x.head(n-1) * x.tail(n-1) + ad::sin(x.head(n-1));
+        };
+    }
+
+    // f(x) = sum_i 100 (x_{i+1} - x_i^2)^2 + (1 - x_i)^2
+    auto rosenbrock()
+    {
+        return [&](auto& x) {
+            return ad::sum(idx.begin(), idx.end(), [&](size_t i) {
+                auto d = x[i+1] - x[i] * x[i];
+                auto e = 1. - x[i];
+                return 100. * d * d + e * e;
+            });
+        };
+    }
+
+    static void check_eq(const Eigen::SparseMatrix<value_t>& actual,
+                         const matrix_t& expected)
+    {
+        matrix_t dense(actual);
+        ASSERT_EQ(dense.rows(), expected.rows());
+        ASSERT_EQ(dense.cols(), expected.cols());
+        for (int i = 0; i < dense.rows(); ++i) {
+            for (int j = 0; j < dense.cols(); ++j) {
+                EXPECT_NEAR(dense(i,j), expected(i,j), 1e-10);
+            }
+        }
+    }
+};
+
+TEST_F(sparsity_fixture, tracer)
+{
+    InteractionRecorder recorder;
+    auto x0 = tracer_t::independent(0);
+    auto x1 = tracer_t::independent(1);
+    auto x2 = tracer_t::independent(2);
+
+    auto y = 2. * x0 + x2 - 1.;
+    EXPECT_EQ(y.deps(), set_t({0, 2}));
+    EXPECT_TRUE(recorder.pairs().empty());     // linear
+
+    auto z = x0 * x1 + ad::core::exp(x2);
+    EXPECT_EQ(z.deps(), set_t({0, 1, 2}));
+    using pair_t = InteractionRecorder::pair_t;
+    std::vector<pair_t> expected = {{0, 1}, {1, 0}, {2, 2}};
+    EXPECT_EQ(recorder.pairs(), expected);
+}
+
+TEST_F(sparsity_fixture, jacobian_sparsity)
+{
+    auto p = ad::jacobian_sparsity(bidiagonal(), x);
+    ASSERT_EQ(p.rows(), n-1);
+    ASSERT_EQ(p.cols.size(), n);
+    EXPECT_EQ(p.n_nonzeros(), 2*(n-1));
+    EXPECT_EQ(p.cols[0], std::vector<size_t>({0}));
+    EXPECT_EQ(p.cols[3], std::vector<size_t>({2, 3}));
+    EXPECT_EQ(p.cols[n-1], std::vector<size_t>({n-2}));
+}
+
+TEST_F(sparsity_fixture, color_columns)
+{
+    auto p = ad::jacobian_sparsity(bidiagonal(), x);
+    auto c = color_columns(p);
+    EXPECT_EQ(c.n_colors, 2ul);
+    for (size_t j = 0; j + 1 < n; ++j) {
+        EXPECT_NE(c.color[j], c.color[j+1]);
+    }
+
+    // dense rows: every column conflicts
+    SparsityPattern dense(2, 4);
+    for (auto& col : dense.cols) col = {0, 1};
+    EXPECT_EQ(color_columns(dense).n_colors, 4ul);
+    EXPECT_EQ(color_columns(dense.transpose()).n_colors, 2ul);
+}
+
+TEST_F(sparsity_fixture, sparse_jacobian_forward)
+{
+    auto f = bidiagonal();
+    auto J = ad::sparse_jacobian(f, x);
+    EXPECT_EQ(J.nonZeros(), static_cast<int>(2*(n-1)));
+    check_eq(J, ad::jacobian(f, x));
+    check_eq(ad::sparse_jacobian<1>(f, x), ad::jacobian(f, x));
+}
+
+TEST_F(sparsity_fixture, sparse_jacobian_reverse)
+{
+    // 2 dense rows: 2 row colors vs n column colors
+    matrix_t A = matrix_t::Random(2, n);
+    auto f = [&](auto& x) {
+        using v_t = typename std::decay_t<decltype(x)>::value_t;
+        Eigen::Matrix<v_t, Eigen::Dynamic, Eigen::Dynamic> Av = A.cast<v_t>();
+        return ad::sin(ad::dot(Av, x));
+    };
+    auto J = ad::sparse_jacobian(f, x);
+    check_eq(J, ad::jacobian(f, x));
+}
+
+TEST_F(sparsity_fixture, hessian_sparsity)
+{
+    auto p = ad::hessian_sparsity(rosenbrock(), x);
+    ASSERT_EQ(p.rows(), n);
+    EXPECT_EQ(p.n_nonzeros(), 3*n - 2);     // tridiagonal
+    EXPECT_EQ(p.cols[0], std::vector<size_t>({0, 1}));
+    EXPECT_EQ(p.cols[4], std::vector<size_t>({3, 4, 5}));
+    EXPECT_EQ(color_columns(p).n_colors, 3ul);
+}
+
+TEST_F(sparsity_fixture, sparse_hessian)
+{
+    auto f = rosenbrock();
+    auto H = ad::sparse_hessian(f, x);
+    EXPECT_EQ(H.nonZeros(), static_cast<int>(3*n - 2));
+    check_eq(H, ad::hessian(f, x));
+
+    // reusing the pattern at another point
+    auto p = ad::hessian_sparsity(f, x);
+    vector_t y = 2. * x;
+    check_eq(ad::sparse_hessian(f, y, p), ad::hessian(f, y));
+}
+
+} // namespace core
+} // namespace ad
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
 #include <fastad_bits/reverse/core/constant.hpp>
 #include <fastad_bits/reverse/core/sum.hpp>
 #include <testutil/base_fixture.hpp>
@@ -154,6 +155,127 @@ TEST_F(sum_fixture, vec_constant)
     }
 }
 
+// Sum (parallel iter) TEST
+
+TEST_F(sum_fixture, par_scl_feval)
+{
+    auto scl_sum = sum(ad::par(3), scl_exprs.begin(), scl_exprs.end(), 
+                       [](const auto& x) { return scl_unary_t(x); });
+    bind(scl_sum);
+    value_t res = scl_sum.feval();
+    EXPECT_DOUBLE_EQ(res, size*2.*scl_expr.get());
+}
+
+TEST_F(sum_fixture, par_vec_beval)
+{
+    auto vec_sum = sum(ad::par(3), vec_exprs.begin(), vec_exprs.end(), 
+                       [](const auto& x) { return vec_unary_t(x); });
+    bind(vec_sum);
+    vec_sum.beval(vseed);
+    for (size_t k = 0; k < vec_exprs.size(); ++k) {
+        for (size_t i = 0; i < vec_size; ++i) {
+            EXPECT_DOUBLE_EQ(vec_exprs[k].get_adj(i,0), 2*vseed[i]);
+        }        
+    }
+}
+
+TEST_F(sum_fixture, par_shared_leaf)
+{
+    // every summand depends on the same leaves w, b
+    Var<value_t> w(1.3), b(-0.4);
+    std::vector<value_t> xs(1000);
+    for (size_t i = 0; i < xs.size(); ++i) xs[i] = 0.001 * i;
+
+    auto make = [&](const auto& policy) {
+        return sum(policy, xs.begin(), xs.end(), 
+                   [&](value_t x) { return ad::sin(w * x + b); });
+    };
+
+    auto seq_sum = sum(xs.begin(), xs.end(),
+                       [&](value_t x) { return ad::sin(w * x + b); });
+    bind(seq_sum);
+    value_t expected = seq_sum.feval();
+    seq_sum.beval(seed);
+    value_t w_adj = w.get_adj();
+    value_t b_adj = b.get_adj();
+
+    for (bool deterministic : {false, true}) {
+        w.reset_adj();
+        b.reset_adj();
+        auto par_sum = make(ad::par(4, deterministic));
+        bind(par_sum);
+        EXPECT_NEAR(par_sum.feval(), expected, 1e-10);
+        par_sum.beval(seed);
+        EXPECT_NEAR(w.get_adj(), w_adj, 1e-10);
+        EXPECT_NEAR(b.get_adj(), b_adj, 1e-10);
+
+        // second sweep must accumulate the same amount again
+        par_sum.beval(seed);
+        EXPECT_NEAR(w.get_adj(), 2*w_adj, 1e-10);
+        EXPECT_NEAR(b.get_adj(), 2*b_adj, 1e-10);
+    }
+}
+
+TEST_F(sum_fixture, par_deterministic)
+{
+    Var<value_t> w(0.3);
+    std::vector<value_t> xs(5000);
+    for (size_t i = 0; i < xs.size(); ++i) xs[i] = 1e-3 * i * (i % 7);
+
+    auto par_sum = sum(ad::par(4, true), xs.begin(), xs.end(), 
+                       [&](value_t x) { return ad::exp(w * x); });
+    bind(par_sum);
+    value_t first = par_sum.feval();
+    par_sum.beval(seed);
+    value_t first_adj = w.get_adj();
+    for (int k = 0; k < 10; ++k) {
+        w.reset_adj();
+        EXPECT_EQ(par_sum.feval(), first);
+        par_sum.beval(seed);
+        EXPECT_EQ(w.get_adj(), first_adj);
+    }
+}
+
+TEST_F(sum_fixture, par_empty)
+{
+    std::vector<value_t> xs;
+    Var<value_t> w(0.3);
+    auto par_sum = sum(ad::par(2), xs.begin(), xs.end(), 
+                       [&](value_t x) { return w * x; });
+    bind(par_sum);
+    EXPECT_DOUBLE_EQ(par_sum.feval(), 0.);
+    par_sum.beval(seed);
+    EXPECT_DOUBLE_EQ(w.get_adj(), 0.);
+}
+
+TEST_F(sum_fixture, par_nested_same_pool)
+{
+    // inner sums use the pool of the outer sum, so they run serially
+    Var<value_t> w(0.3);
+    std::vector<value_t> xs(50);
+    for (size_t i = 0; i < xs.size(); ++i) xs[i] = 1e-2 * i;
+
+    auto seq_sum = sum(xs.begin(), xs.end(), [&](value_t x) {
+                return sum(xs.begin(), xs.end(),
+                           [&](value_t y) { return ad::sin(w * x * y); });
+            });
+    bind(seq_sum);
+    value_t expected = seq_sum.feval();
+    seq_sum.beval(seed);
+    value_t w_adj = w.get_adj();
+    w.reset_adj();
+
+    auto policy = ad::par(4);
+    auto par_sum = sum(policy, xs.begin(), xs.end(), [&](value_t x) {
+                return sum(policy, xs.begin(), xs.end(),
+                           [&](value_t y) { return ad::sin(w * x * y); });
+            });
+    bind(par_sum);
+    EXPECT_NEAR(par_sum.feval(), expected, 1e-10);
+    par_sum.beval(seed);
+    EXPECT_NEAR(w.get_adj(), w_adj, 1e-10);
+}
+
 // Sum (expr) TEST
 
 TEST_F(sum_fixture, scl_expr_feval)
@@ -29,5 +29,34 @@ TEST_F(var_fixture, var_ctors)
     test_ctor(mat_v_t(1,2));
 }
 
+TEST_F(var_fixture, freeze)
+{
+    vec_v_t v(3);
+    EXPECT_FALSE(v.is_frozen());
+    v.freeze();
+    EXPECT_TRUE(v.is_frozen());
+
+    // views and subviews see the flag of the variable
+    VarView<value_t, vec> view = v;
+    auto elem = v(1);
+    auto head = v.head(2);
+    v.unfreeze();
+    EXPECT_FALSE(view.is_frozen());
+    v.freeze();
+    EXPECT_TRUE(view.is_frozen());
+    EXPECT_TRUE(elem.is_frozen());
+    EXPECT_TRUE(head.is_frozen());
+
+    // copies own their flag
+    vec_v_t w = v;
+    EXPECT_TRUE(w.is_frozen());
+    w.unfreeze();
+    EXPECT_TRUE(v.is_frozen());
+
+    // views of raw pointers are never frozen
+    VarView<value_t, vec> raw(v.data(), v.data_adj(), 3);
+    EXPECT_FALSE(raw.is_frozen());
+}
+
 } // namespace core
 } // namespace ad
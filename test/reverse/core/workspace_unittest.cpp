@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <vector>
+#include <fastad_bits/reverse/core/var_view.hpp>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/sum.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/core/workspace.hpp>
+
+namespace ad {
+namespace core {
+
+struct workspace_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+
+    VarView<value_t> x;
+    VarView<value_t, vec> v;
+    VarView<value_t, mat> m;
+    std::vector<VarView<value_t>> w;
+
+    workspace_fixture()
+        : v(3)
+        , m(2, 2)
+        , w(2)
+    {}
+};
+
+TEST_F(workspace_fixture, layout)
+{
+    Workspace<value_t> ws(x, v, m, w);
+    EXPECT_EQ(ws.size(), 10UL);
+
+    // leaves are bound contiguously in the order given
+    EXPECT_EQ(x.data(), ws.values().data());
+    EXPECT_EQ(v.data(), ws.values().data() + 1);
+    EXPECT_EQ(m.data(), ws.values().data() + 4);
+    EXPECT_EQ(w[0].data(), ws.values().data() + 8);
+    EXPECT_EQ(w[1].data(), ws.values().data() + 9);
+    EXPECT_EQ(x.data_adj(), ws.adjoints().data());
+    EXPECT_EQ(w[1].data_adj(), ws.adjoints().data() + 9);
+
+    // adjoints are aligned like the values
+    auto addr = reinterpret_cast<std::uintptr_t>(ws.adjoints().data());
+    EXPECT_EQ(addr % util::CachePool::alignment, 0UL);
+
+    for (size_t i = 0; i < ws.size(); ++i) {
+        EXPECT_DOUBLE_EQ(ws.values()(i), 0.);
+        EXPECT_DOUBLE_EQ(ws.adjoints()(i), 0.);
+    }
+}
+
+TEST_F(workspace_fixture, values_in_gradient_out)
+{
+    Workspace<value_t> ws(x, v, w);
+    ws.values().head(4) << 2., 1., -1., 3.;
+
+    auto expr = ad::bind((w[0] = x * ad::sum(v),
+                          w[1] = ad::sin(w[0]) + x,
+                          w[1] * w[0]));
+
+    for (int iter = 0; iter < 2; ++iter) {
+        ws.reset_adj();
+        ad::autodiff(expr);
+
+        value_t s = 3.;
+        value_t w0 = 2. * s;
+        value_t w1 = std::sin(w0) + 2.;
+        value_t dw0 = w1 + w0 * std::cos(w0);
+        auto g = ws.adjoints();
+        EXPECT_DOUBLE_EQ(g(0), dw0 * s + w0);
+        for (int i = 1; i < 4; ++i) {
+            EXPECT_DOUBLE_EQ(g(i), dw0 * 2.);
+        }
+    }
+}
+
+TEST_F(workspace_fixture, move)
+{
+    Workspace<value_t> ws1(x, v);
+    auto* data = ws1.values().data();
+    Workspace<value_t> ws2(std::move(ws1));
+    ws2.values() << 1., 2., 3., 4.;
+    EXPECT_EQ(ws2.values().data(), data);
+    EXPECT_DOUBLE_EQ(x.get(), 1.);
+    EXPECT_DOUBLE_EQ(v.get(2,0), 4.);
+}
+
+} // namespace core
+} // namespace ad
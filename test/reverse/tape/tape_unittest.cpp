@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <vector>
+#include <fastad_bits/reverse/core/unary.hpp>
+#include <fastad_bits/reverse/core/binary.hpp>
+#include <fastad_bits/reverse/core/eq.hpp>
+#include <fastad_bits/reverse/core/glue.hpp>
+#include <fastad_bits/reverse/core/var.hpp>
+#include <fastad_bits/reverse/core/eval.hpp>
+#include <fastad_bits/reverse/tape/real.hpp>
+#include <fastad_bits/reverse/tape/stack.hpp>
+
+namespace ad {
+namespace tape {
+
+struct tape_fixture : ::testing::Test
+{
+protected:
+    using value_t = double;
+    using real_t = Real<value_t>;
+
+    Stack<value_t> stack;
+};
+
+TEST_F(tape_fixture, leaf)
+{
+    real_t x(3.);
+    EXPECT_DOUBLE_EQ(x.get(), 3.);
+    EXPECT_EQ(x.index(), 0ul);
+    EXPECT_EQ(stack.n_statements(), 1ul);
+    EXPECT_EQ(stack.n_operations(), 0ul);
+    EXPECT_DOUBLE_EQ(x.get_adj(), 0.);
+}
+
+TEST_F(tape_fixture, ops)
+{
+    real_t x(3.), y(-2.);
+    real_t z = (x * y - 2. * x) / y + 1.;
+    EXPECT_DOUBLE_EQ(z.get(), (3. * -2. - 6.) / -2. + 1.);
+
+    // only Real operands are recorded
+    EXPECT_EQ(stack.n_statements(), 7ul);
+    EXPECT_EQ(stack.n_operations(), 8ul);
+
+    z.set_adj(1.);
+    stack.reverse();
+    EXPECT_DOUBLE_EQ(x.get_adj(), (-2. - 2.) / -2.);
+    EXPECT_DOUBLE_EQ(y.get_adj(), 3. / -2. - (3. * -2. - 6.) / 4.);
+}
+
+TEST_F(tape_fixture, unary)
+{
+    real_t x(0.3);
+    real_t z = sin(x) + cos(x) + tan(x) + asin(x) + acos(x) + atan(x) +
+               exp(x) + log(x) + sqrt(x) + erf(x) - x;
+    z.set_adj(1.);
+    stack.reverse();
+    value_t dx = std::cos(0.3) - std::sin(0.3) + 1. / std::pow(std::cos(0.3), 2) +
+                 1. / (1. + 0.09) + std::exp(0.3) + 1. / 0.3 + 0.5 / std::sqrt(0.3) +
+                 2. / std::sqrt(M_PI) * std::exp(-0.09) - 1.;
+    EXPECT_NEAR(x.get_adj(), dx, 1e-14);
+}
+
+TEST_F(tape_fixture, compound_and_comparison)
+{
+    real_t x(2.);
+    real_t y = x;
+    y *= x;
+    y += 1.;
+    EXPECT_TRUE(y > x);
+    EXPECT_TRUE(y == 5.);
+    EXPECT_FALSE(1. >= y);
+    y.set_adj(1.);
+    stack.reverse();
+    EXPECT_DOUBLE_EQ(x.get_adj(), 4.);
+}
+
+// number of halvings depends on the value of x
+TEST_F(tape_fixture, data_dependent_loop)
+{
+    real_t x(20.);
+    real_t y = x;
+    size_t n = 0;
+    while (y > 1.) {
+        y = y / 2.;
+        ++n;
+    }
+    EXPECT_EQ(n, 5ul);
+    y.set_adj(1.);
+    stack.reverse();
+    EXPECT_DOUBLE_EQ(x.get_adj(), 1. / 32.);
+}
+
+TEST_F(tape_fixture, matches_core)
+{
+    value_t x0 = 0.4, x1 = -1.3, x2 = 2.1;
+
+    Var<value_t> a(x0), b(x1), c(x2), w0, w1;
+    auto expr = ad::bind((w0 = a * b - c * ad::sin(a),
+                          w1 = b * w0 - ad::cos(w0),
+                          w1 + ad::exp(w1 - w0) / ad::sqrt(c)));
+    value_t expected = ad::autodiff(expr);
+
+    real_t x(x0), y(x1), z(x2);
+    real_t v0 = x * y - z * sin(x);
+    real_t v1 = y * v0 - cos(v0);
+    real_t f = v1 + exp(v1 - v0) / sqrt(z);
+    f.set_adj(1.);
+    stack.reverse();
+
+    EXPECT_DOUBLE_EQ(f.get(), expected);
+    EXPECT_DOUBLE_EQ(x.get_adj(), a.get_adj());
+    EXPECT_DOUBLE_EQ(y.get_adj(), b.get_adj());
+    EXPECT_DOUBLE_EQ(z.get_adj(), c.get_adj());
+}
+
+TEST_F(tape_fixture, replay_and_new_recording)
+{
+    real_t x(2.);
+    real_t f = x * x * x;
+    f.set_adj(1.);
+    stack.reverse();
+    EXPECT_DOUBLE_EQ(x.get_adj(), 12.);
+
+    // same tape, new seed
+    stack.reset_adj();
+    f.set_adj(2.);
+    stack.reverse();
+    EXPECT_DOUBLE_EQ(x.get_adj(), 24.);
+
+    stack.new_recording();
+    EXPECT_EQ(stack.n_statements(), 0ul);
+    real_t u(3.);
+    real_t g = u * u;
+    g.set_adj(1.);
+    stack.reverse();
+    EXPECT_DOUBLE_EQ(u.get_adj(), 6.);
+}
+
+TEST_F(tape_fixture, vector)
+{
+    Vector<value_t> x(3);
+    x << real_t(1.), real_t(-2.), real_t(0.5);
+    Matrix<value_t> A(2, 3);
+    A << real_t(1.), real_t(2.), real_t(3.),
+         real_t(4.), real_t(5.), real_t(6.);
+    Vector<value_t> y = A * x;
+    real_t f = y.dot(y);
+    f.set_adj(1.);
+    stack.reverse();
+
+    Eigen::MatrixXd Ad(2, 3);
+    Ad << 1., 2., 3., 4., 5., 6.;
+    Eigen::VectorXd xd(3);
+    xd << 1., -2., 0.5;
+    Eigen::VectorXd yd = Ad * xd;
+    Eigen::VectorXd dx = 2. * Ad.transpose() * yd;
+    EXPECT_DOUBLE_EQ(f.get(), yd.squaredNorm());
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(x(i).get_adj(), dx(i));
+    }
+}
+
+TEST_F(tape_fixture, nested_stack)
+{
+    {
+        Stack<value_t> inner;
+        EXPECT_EQ(&Stack<value_t>::active(), &inner);
+    }
+    EXPECT_EQ(&Stack<value_t>::active(), &stack);
+}
+
+} // namespace tape
+} // namespace ad
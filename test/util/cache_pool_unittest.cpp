@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <fastad_bits/util/cache_pool.hpp>
+
+namespace ad {
+namespace util {
+
+struct cache_pool_fixture : ::testing::Test
+{
+protected:
+    static bool aligned(void* p)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % CachePool::alignment == 0;
+    }
+};
+
+TEST_F(cache_pool_fixture, allocate_aligned)
+{
+    CachePool pool(4096);
+    std::vector<void*> ps;
+    for (size_t n : {1, 8, 100, 1000, 5000}) {
+        void* p = pool.allocate(n);
+        EXPECT_TRUE(aligned(p));
+        ps.push_back(p);
+    }
+    // blocks do not overlap
+    static_cast<unsigned char*>(ps[3])[999] = 1;
+    static_cast<unsigned char*>(ps[4])[0] = 2;
+    EXPECT_EQ(static_cast<unsigned char*>(ps[3])[999], 1);
+}
+
+TEST_F(cache_pool_fixture, reuse)
+{
+    CachePool pool(4096);
+    void* p = pool.allocate(300);
+    pool.deallocate(p, 300);
+    size_t reserved = pool.reserved();
+    // same size class is recycled without touching the slab
+    void* q = pool.allocate(500);
+    EXPECT_EQ(p, q);
+    EXPECT_EQ(pool.reserved(), reserved);
+    pool.deallocate(q, 500);
+}
+
+TEST_F(cache_pool_fixture, high_water_mark)
+{
+    CachePool pool;
+    void* p = pool.allocate(64);
+    void* q = pool.allocate(128);
+    EXPECT_EQ(pool.in_use(), 192ul);
+    pool.deallocate(p, 64);
+    pool.deallocate(q, 128);
+    EXPECT_EQ(pool.in_use(), 0ul);
+    EXPECT_EQ(pool.high_water_mark(), 192ul);
+}
+
+TEST_F(cache_pool_fixture, large_block)
+{
+    CachePool pool(1024);
+    void* p = pool.allocate(10000);
+    EXPECT_TRUE(aligned(p));
+    EXPECT_GE(pool.reserved(), 10000ul);
+    pool.deallocate(p, 10000);
+}
+
+TEST_F(cache_pool_fixture, reserve)
+{
+    CachePool pool(1024);
+    pool.reserve(1 << 16);
+    size_t reserved = pool.reserved();
+    for (int i = 0; i < 16; ++i) pool.allocate(1000);
+    EXPECT_EQ(pool.reserved(), reserved);
+}
+
+TEST_F(cache_pool_fixture, huge_pages)
+{
+    CachePool pool(1, true);
+    void* p = pool.allocate(100);
+    EXPECT_TRUE(aligned(p));
+    EXPECT_EQ(pool.reserved() % CachePool::huge_page_size, 0ul);
+    pool.deallocate(p, 100);
+}
+
+TEST_F(cache_pool_fixture, local)
+{
+    CachePool* main_pool = &CachePool::local();
+    EXPECT_EQ(main_pool, &CachePool::local());
+}
+
+} // namespace util
+} // namespace ad
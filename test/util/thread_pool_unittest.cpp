@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include <fastad_bits/util/thread_pool.hpp>
+
+namespace ad {
+namespace util {
+
+struct thread_pool_fixture : ::testing::Test
+{
+protected:
+};
+
+TEST_F(thread_pool_fixture, size)
+{
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 3ul);
+    ThreadPool default_pool;
+    EXPECT_GE(default_pool.size(), 1ul);
+}
+
+TEST_F(thread_pool_fixture, run_all_workers)
+{
+    ThreadPool pool(4);
+    std::vector<int> hits(pool.size(), 0);
+    for (int k = 0; k < 100; ++k) {
+        pool.run([&](size_t worker) { ++hits[worker]; });
+    }
+    for (int h : hits) EXPECT_EQ(h, 100);
+}
+
+TEST_F(thread_pool_fixture, parallel_for_covers_tasks)
+{
+    ThreadPool pool(4);
+    constexpr size_t n = 1000;
+    std::vector<std::atomic<int>> hits(n);
+    for (auto& h : hits) h = 0;
+    pool.parallel_for(n, [&](size_t i, size_t worker) {
+        EXPECT_LT(worker, pool.size());
+        ++hits[i];
+    });
+    for (const auto& h : hits) EXPECT_EQ(h, 1);
+}
+
+TEST_F(thread_pool_fixture, single_thread_inline)
+{
+    ThreadPool pool(1);
+    size_t sum = 0;
+    pool.parallel_for(10, [&](size_t i, size_t worker) {
+        EXPECT_EQ(worker, 0ul);
+        sum += i;
+    });
+    EXPECT_EQ(sum, 45ul);
+}
+
+TEST_F(thread_pool_fixture, nested_run_inline)
+{
+    ThreadPool pool(4);
+    constexpr size_t n = 100;
+    std::vector<std::atomic<int>> hits(n * n);
+    for (auto& h : hits) h = 0;
+    pool.parallel_for(n, [&](size_t i, size_t) {
+        pool.parallel_for(n, [&](size_t j, size_t worker) {
+            EXPECT_LT(worker, pool.size());
+            ++hits[i * n + j];
+        });
+    });
+    for (const auto& h : hits) EXPECT_EQ(h, 1);
+}
+
+} // namespace util
+} // namespace ad